@@ -16,36 +16,102 @@
 
 #pragma once
 
-#include <cc7/ByteArray.h>
+#include <cc7/ByteRangeList.h>
+#include <functional>
 
 namespace cc7
 {
+	/**
+	 The Base32_Alphabet enumeration defines alphabet used by the Base32 codec.
+	 Each alphabet has its own lookup tables, generated at compile time.
+	 */
+	enum Base32_Alphabet
+	{
+		/// Standard alphabet, with "A-Z2-7" characters (RFC 4648, section 6)
+		Base32_Standard		= 0,
+		/// Extended hex alphabet, with "0-9A-V" characters (RFC 4648, section 7). The encoded
+		/// strings preserve the sort order of the encoded data.
+		Base32_Hex			= 1,
+		/// Douglas Crockford's alphabet, designed for human-entered codes. The decoder ignores
+		/// case of characters and accepts 'I' and 'L' as '1' and 'O' as '0'.
+		Base32_Crockford	= 2,
+	};
+	
 	/**
 	 Converts input byte range ino Base32 encoded string. The |use_padding| parameter
 	 determines whether the output string will contain padding characted '='.
+	 The |alphabet| parameter defines characters used in the produced string.
 	 The function always returns true.
 	 */
-	bool Base32_Encode(const ByteRange & bytes, bool use_padding, std::string & out_string);
-
+	bool Base32_Encode(const ByteRange & bytes, bool use_padding, std::string & out_string,
+					   Base32_Alphabet alphabet = Base32_Standard);
+	
 	/**
-	 Converts Base32 encoded string into ByteArray. If the |require_padding| parameter is true,
-	 then the padding '=' characters must be present at the end of string (if size doesn't fit the base32
-	 encoded string block).
+	 Converts Base32 encoded string, captured in the byte range, into ByteArray. If the |require_padding|
+	 parameter is true, then the padding '=' characters must be present at the end of string (if size
+	 doesn't fit the base32 encoded string block).
 	 
 	 Returns false if the string is not a valid Base32 string.
 	 
 	 Note that unlike the other Base32 implementations, this decoder threats invalid characters in the string
-	 as an error.
+	 as an error. The string must also use characters from the |alphabet|.
+	 */
+	bool Base32_Decode(const ByteRange & in_string, bool require_padding, ByteArray & out_bytes,
+					   Base32_Alphabet alphabet = Base32_Standard);
+	
+	/**
+	 Converts Base32 encoded string into ByteArray. This is just the convenient function to
+	 Base32_Decode() with ByteRange input.
+	 */
+	inline bool Base32_Decode(const std::string & in_string, bool require_padding, ByteArray & out_bytes,
+							  Base32_Alphabet alphabet = Base32_Standard)
+	{
+		return Base32_Decode(MakeRange(in_string), require_padding, out_bytes, alphabet);
+	}
+	
+	/**
+	 Returns exact length of Base32 encoded string, produced for data with |data_size|
+	 bytes, with or without the padding.
+	 */
+	size_t Base32_EncodedLength(size_t data_size, bool use_padding);
+	
+	/**
+	 Returns the maximum number of bytes which can be decoded from a Base32 string
+	 with |string_length| characters. The actual number of bytes may be lower, due to padding.
+	 */
+	size_t Base32_DecodedMaxLength(size_t string_length);
+	
+	/**
+	 Converts input byte range into Base32 encoded string, written to the caller's buffer
+	 |out| with |out_capacity| characters. The function doesn't allocate memory and doesn't
+	 append the NUL terminator to the produced string.
+	 
+	 Returns number of characters written to the buffer, or ByteRange::npos if the buffer
+	 is smaller than Base32_EncodedLength().
 	 */
-	bool Base32_Decode(const std::string & in_string, bool require_padding, ByteArray & out_bytes);
+	size_t Base32_EncodeTo(const ByteRange & bytes, bool use_padding, char * out, size_t out_capacity,
+						   Base32_Alphabet alphabet = Base32_Standard);
+	
+	/**
+	 Converts Base32 encoded string into bytes, written to the caller's buffer |out| with
+	 |out_capacity| bytes. The function doesn't allocate memory and accepts the same strings
+	 as Base32_Decode(). The buffer with Base32_DecodedMaxLength() capacity is always enough,
+	 but the exact size of decoded data is also acceptable.
+	 
+	 Returns number of bytes written to the buffer, or ByteRange::npos if the string is not a valid
+	 Base32 string, or if the buffer is too small. The content of the buffer is undefined
+	 in case of failure.
+	 */
+	size_t Base32_DecodeTo(const ByteRange & in_string, bool require_padding, cc7::byte * out, size_t out_capacity,
+						   Base32_Alphabet alphabet = Base32_Standard);
 	
 	/**
 	 Converts input byte range into Base32 encoded string. This is just the convenient function to Base32_Encode().
 	 */
-	inline std::string ToBase32String(const ByteRange & data, bool use_padding)
+	inline std::string ToBase32String(const ByteRange & data, bool use_padding, Base32_Alphabet alphabet = Base32_Standard)
 	{
 		std::string result;
-		Base32_Encode(data, use_padding, result);
+		Base32_Encode(data, use_padding, result, alphabet);
 		return result;
 	}
 	
@@ -54,11 +120,184 @@ namespace cc7
 	 easier to use, but unlike the Base32_Decode(), you are not able to determine whether
 	 the error occured or not.
 	 */
-	inline ByteArray FromBase32String(const std::string & string, bool require_padding)
+	inline ByteArray FromBase32String(const std::string & string, bool require_padding, Base32_Alphabet alphabet = Base32_Standard)
 	{
 		ByteArray result;
-		Base32_Decode(string, require_padding, result);
+		Base32_Decode(string, require_padding, result, alphabet);
 		return result;
 	}
 	
+	/**
+	 The Base32Encoder class converts data into Base32 encoded string incrementally.
+	 You can provide an input data in multiple chunks with arbitrary size. The produced
+	 characters are passed to the sink function, provided in the constructor, so the
+	 memory consumed by the encoder doesn't depend on the size of the input data.
+	 
+	 The final string is exactly the same as produced by the Base32_Encode() function.
+	 */
+	class Base32Encoder
+	{
+	public:
+		
+		/**
+		 The sink function receives chunks of the encoded string. The provided
+		 range is valid only during the call.
+		 */
+		typedef std::function<void (const ByteRange & chunk)> Sink;
+		
+		/**
+		 Size of the internal buffer for the produced characters.
+		 */
+		static const size_t BufferSize = 4096;
+		
+		/**
+		 Constructs a new encoder for the required |use_padding|, the |sink| function
+		 and the |alphabet|.
+		 */
+		Base32Encoder(bool use_padding, Sink sink, Base32_Alphabet alphabet = Base32_Standard);
+		
+		/**
+		 Destroys the encoder and securely cleans all internal buffers.
+		 */
+		~Base32Encoder();
+		
+		Base32Encoder(const Base32Encoder &) = delete;
+		Base32Encoder & operator=(const Base32Encoder &) = delete;
+		
+		/**
+		 Encodes next chunk of data. The partial 5 byte block at the end of the chunk is kept
+		 in the encoder and is processed with the next call to update() or finish().
+		 The function always returns true.
+		 */
+		bool update(const ByteRange & data);
+		
+		/**
+		 Encodes all segments from the |data| list, in the same way as the sequence
+		 of update() calls would do.
+		 */
+		bool update(const ByteRangeList & data)
+		{
+			for (const ByteRange & segment : data) {
+				if (!update(segment)) {
+					return false;
+				}
+			}
+			return true;
+		}
+		
+		/**
+		 Encodes the rest of data, including the padding, and passes all remaining characters
+		 to the sink. After the call, the encoder is ready for encoding of another data.
+		 The function always returns true.
+		 */
+		bool finish();
+		
+	private:
+		
+		void _encodeBlocks(const cc7::byte * in_p, size_t blocks_count);
+		void _flush();
+		
+		bool			_use_padding;
+		Base32_Alphabet	_alphabet;
+		Sink			_sink;
+		size_t			_pending_size;
+		cc7::byte		_pending[5];
+		size_t			_buffer_size;
+		char			_buffer[BufferSize];
+	};
+	
+	/**
+	 The Base32Decoder class converts Base32 encoded string into data incrementally.
+	 You can provide an input string in multiple chunks with arbitrary size, and the
+	 partial 8 character blocks are carried between the chunks. The produced bytes are
+	 passed to the sink function, provided in the constructor, so the memory consumed
+	 by the decoder doesn't depend on the size of the input string.
+	 
+	 The decoder accepts the same strings as the Base32_Decode() function. The padding
+	 and the canonical end of the string are validated in finish().
+	 
+	 Note that if the error is detected, then the sink may already receive a part of the
+	 data. In this case, you should discard all received data.
+	 */
+	class Base32Decoder
+	{
+	public:
+		
+		/**
+		 The sink function receives chunks of the decoded data. The provided
+		 range is valid only during the call.
+		 */
+		typedef std::function<void (const ByteRange & chunk)> Sink;
+		
+		/**
+		 Size of the internal buffer for the produced bytes.
+		 */
+		static const size_t BufferSize = 2560;
+		
+		/**
+		 Constructs a new decoder for the required |require_padding|, the |sink| function
+		 and the |alphabet|.
+		 */
+		Base32Decoder(bool require_padding, Sink sink, Base32_Alphabet alphabet = Base32_Standard);
+		
+		/**
+		 Destroys the decoder and securely cleans all internal buffers.
+		 */
+		~Base32Decoder();
+		
+		Base32Decoder(const Base32Decoder &) = delete;
+		Base32Decoder & operator=(const Base32Decoder &) = delete;
+		
+		/**
+		 Decodes next chunk of the Base32 encoded string. Returns false if the chunk
+		 contains an invalid character, or if the decoder already failed in a previous call.
+		 */
+		bool update(const ByteRange & string);
+		
+		/**
+		 Decodes next chunk of the Base32 encoded string.
+		 */
+		bool update(const std::string & string)
+		{
+			return update(MakeRange(string));
+		}
+		
+		/**
+		 Decodes all segments from the |string| list, in the same way as the sequence
+		 of update() calls would do.
+		 */
+		bool update(const ByteRangeList & string)
+		{
+			for (const ByteRange & segment : string) {
+				if (!update(segment)) {
+					return false;
+				}
+			}
+			return true;
+		}
+		
+		/**
+		 Finishes the decoding and passes all remaining bytes to the sink. Returns false
+		 if the whole string was not a valid Base32 string. After the call, the decoder
+		 is ready for decoding of another string.
+		 */
+		bool finish();
+		
+	private:
+		
+		bool _decodeBlocks(const cc7::byte * block_8, size_t blocks_count);
+		bool _fail();
+		void _flush();
+		void _reset();
+		
+		bool			_require_padding;
+		Base32_Alphabet	_alphabet;
+		Sink			_sink;
+		bool			_failed;
+		size_t			_pending_size;
+		cc7::byte		_pending[8];
+		size_t			_buffer_size;
+		cc7::byte		_buffer[BufferSize];
+	};
+	
 } // cc7
@@ -16,37 +16,116 @@
 
 #pragma once
 
-#include <cc7/ByteArray.h>
+#include <cc7/ByteRangeList.h>
+#include <functional>
 
 namespace cc7
 {
+	/**
+	 The Base64_Variant enumeration defines alphabet and padding used by the Base64 codec.
+	 The values can be combined, so Base64_UrlNoPadding is equal to Base64_Url | Base64_NoPadding.
+	 All variants share the same table driven and vectorized implementation.
+	 */
+	enum Base64_Variant
+	{
+		/// Standard alphabet, with "+/" characters and with mandatory padding (RFC 4648, section 4)
+		Base64_Standard		= 0,
+		/// URL and filename safe alphabet, with "-_" characters (RFC 4648, section 5)
+		Base64_Url			= 1,
+		/// Standard alphabet, without padding. The decoder doesn't accept the padding characters.
+		Base64_NoPadding	= 2,
+		/// URL and filename safe alphabet, without padding. This variant is used in JWT.
+		Base64_UrlNoPadding	= 3,
+	};
+	
 	/**
 	 Converts input byte range into Base64 encoded string. The function returns false
-	 only if you provide an invalid |wrap_size| parameter.
+	 only if you provide an invalid |wrap_size| parameter. The |variant| parameter
+	 defines alphabet and padding of the produced string.
 	 */
-	bool Base64_Encode(const ByteRange & in_data, size_t wrap_size, std::string & out_string);
+	bool Base64_Encode(const ByteRange & in_data, size_t wrap_size, std::string & out_string,
+					   Base64_Variant variant = Base64_Standard);
 	
 	/**
-	 Converts Base64 encoded string into ByteArray. If the |wrap_size| parameter is greater than 0
-	 then the multiline input string is expected. In this case, the size of wrapping is just a hint
+	 Converts Base64 encoded string, captured in the byte range, into ByteArray. If the |wrap_size|
+	 parameter is greater than 0 then the multiline input string is expected. In this case, the size of wrapping is just a hint
 	 and the decoder can process strings with a different size of lines.
 	 
 	 Returns false if the string is not a valid Base64 string.
 	 
 	 Note that unlike the other Base64 implementations, this decoder treats invalid characters in the string
 	 as an error. Other implementations usually stops processing at first invalid character.
+	 The string must also use the alphabet and padding defined by the |variant| parameter.
 	 */
-	bool Base64_Decode(const std::string & in_string, size_t wrap_size, ByteArray & out_data);
+	bool Base64_Decode(const ByteRange & in_string, size_t wrap_size, ByteArray & out_data,
+					   Base64_Variant variant = Base64_Standard);
+	
+	/**
+	 Converts Base64 encoded string into ByteArray. This is just the convenient function to
+	 Base64_Decode() with ByteRange input.
+	 */
+	inline bool Base64_Decode(const std::string & in_string, size_t wrap_size, ByteArray & out_data,
+							  Base64_Variant variant = Base64_Standard)
+	{
+		return Base64_Decode(MakeRange(in_string), wrap_size, out_data, variant);
+	}
+	
+	/**
+	 Converts Base64 encoded string, captured in |in_string| pointer with |length| characters,
+	 into ByteArray. This is just the convenient function to Base64_Decode() with ByteRange input.
+	 */
+	inline bool Base64_Decode(const char * in_string, size_t length, size_t wrap_size, ByteArray & out_data,
+							  Base64_Variant variant = Base64_Standard)
+	{
+		return Base64_Decode(ByteRange(in_string, length), wrap_size, out_data, variant);
+	}
+	
+	/**
+	 Returns exact length of Base64 encoded string, produced for data with |data_size|
+	 bytes and for required |wrap_size| and |variant|.
+	 */
+	size_t Base64_EncodedLength(size_t data_size, size_t wrap_size, Base64_Variant variant = Base64_Standard);
+	
+	/**
+	 Returns the maximum number of bytes which can be decoded from a Base64 string
+	 with |string_length| characters. The actual number of bytes may be lower, due to
+	 padding, or due to whitespaces in multiline strings.
+	 */
+	size_t Base64_DecodedMaxLength(size_t string_length, Base64_Variant variant = Base64_Standard);
+	
+	/**
+	 Converts input byte range into Base64 encoded string, written to the caller's buffer
+	 |out| with |out_capacity| characters. The function doesn't allocate memory and doesn't
+	 append the NUL terminator to the produced string.
+	 
+	 Returns number of characters written to the buffer, or ByteRange::npos if the |wrap_size|
+	 is invalid or if the buffer is smaller than Base64_EncodedLength().
+	 */
+	size_t Base64_EncodeTo(const ByteRange & in_data, size_t wrap_size, char * out, size_t out_capacity,
+						   Base64_Variant variant = Base64_Standard);
+	
+	/**
+	 Converts Base64 encoded string into bytes, written to the caller's buffer |out| with
+	 |out_capacity| bytes. The function doesn't allocate memory and accepts the same strings
+	 as Base64_Decode(). The buffer with Base64_DecodedMaxLength() capacity is always enough,
+	 but the exact size of decoded data is also acceptable.
+	 
+	 Returns number of bytes written to the buffer, or ByteRange::npos if the string is not a valid
+	 Base64 string, or if the buffer is too small. The content of the buffer is undefined
+	 in case of failure.
+	 */
+	size_t Base64_DecodeTo(const ByteRange & in_string, size_t wrap_size, cc7::byte * out, size_t out_capacity,
+						   Base64_Variant variant = Base64_Standard);
 	
 	/**
 	 Converts input byte range into Base64 encoded string. This variant of encoding function may be
 	 easier to use, but unlike the Base64_Encode(), you are not able to determine whether
 	 the error occured or not.
 	 */
-	inline std::string ToBase64String(const ByteRange & data, size_t wrap_size = 0)
+	inline std::string ToBase64String(const ByteRange & data, size_t wrap_size = 0, Base64_Variant variant = Base64_Standard)
 	{
 		std::string result;
-		Base64_Encode(data, wrap_size, result);
+		Base64_Encode(data, wrap_size, result, variant);
 		return result;
 	}
 	
@@ -55,11 +134,233 @@ namespace cc7
 	 easier to use, but unlike the Base64_Decode(), you are not able to determine whether
 	 the error occured or not.
 	 */
-	inline ByteArray FromBase64String(const std::string & string, size_t wrap_size = 0)
+	inline ByteArray FromBase64String(const std::string & string, size_t wrap_size = 0, Base64_Variant variant = Base64_Standard)
+	{
+		ByteArray result;
+		Base64_Decode(string, wrap_size, result, variant);
+		return result;
+	}
+	
+	/**
+	 Converts Base64 encoded string, captured in the byte range, into ByteArray.
+	 Like the string variant, you are not able to determine whether the error occured or not.
+	 */
+	inline ByteArray FromBase64String(const ByteRange & string, size_t wrap_size = 0, Base64_Variant variant = Base64_Standard)
 	{
 		ByteArray result;
-		Base64_Decode(string, wrap_size, result);
+		Base64_Decode(string, wrap_size, result, variant);
 		return result;
 	}
 	
+	
+	/**
+	 The Base64_Executor function executes |tasks_count| independent tasks, in any order and
+	 possibly in parallel. The function must return after all tasks are finished.
+	 */
+	typedef std::function<void (size_t tasks_count, const std::function<void (size_t task_index)> & task)> Base64_Executor;
+	
+	/**
+	 Converts input byte range into Base64 encoded string, with using multiple threads.
+	 The input data is split at line boundaries and each part is encoded independently.
+	 The result is exactly the same as produced by the Base64_Encode() function.
+	 
+	 The |threads_count| parameter specifies the maximum number of parallel tasks. If 0, then
+	 the number of available CPU cores is used. Each task processes at least 64KB of data, so
+	 the small inputs are encoded in the calling thread. If the |executor| is not provided,
+	 then the tasks are executed in newly created threads.
+	 */
+	bool Base64_EncodeParallel(const ByteRange & in_data, size_t wrap_size, std::string & out_string,
+							   size_t threads_count = 0, const Base64_Executor & executor = nullptr);
+	
+	/**
+	 Converts Base64 encoded string into ByteArray, with using multiple threads. The string
+	 is split at block, or line boundaries and each part is decoded independently. The result,
+	 including the error detection, is exactly the same as produced by the Base64_Decode() function.
+	 
+	 The |threads_count| and |executor| parameters have the same meaning as
+	 in Base64_EncodeParallel() function.
+	 */
+	bool Base64_DecodeParallel(const ByteRange & in_string, size_t wrap_size, ByteArray & out_data,
+							   size_t threads_count = 0, const Base64_Executor & executor = nullptr);
+	
+	/**
+	 The Base64Encoder class converts data into Base64 encoded string incrementally.
+	 You can provide an input data in multiple chunks with arbitrary size. The produced
+	 characters are passed to the sink function, provided in the constructor, so the
+	 memory consumed by the encoder doesn't depend on the size of the input data.
+	 
+	 The final string is exactly the same as produced by the Base64_Encode() function,
+	 including the line wrapping.
+	 */
+	class Base64Encoder
+	{
+	public:
+		
+		/**
+		 The sink function receives chunks of the encoded string. The provided
+		 range is valid only during the call.
+		 */
+		typedef std::function<void (const ByteRange & chunk)> Sink;
+		
+		/**
+		 Size of the internal buffer for the produced characters.
+		 */
+		static const size_t BufferSize = 4096;
+		
+		/**
+		 Constructs a new encoder for the required |wrap_size| and the |sink| function.
+		 The |wrap_size| must be divisible by 4, otherwise all subsequent calls to update()
+		 and finish() will fail.
+		 */
+		Base64Encoder(size_t wrap_size, Sink sink);
+		
+		/**
+		 Destroys the encoder and securely cleans all internal buffers.
+		 */
+		~Base64Encoder();
+		
+		Base64Encoder(const Base64Encoder &) = delete;
+		Base64Encoder & operator=(const Base64Encoder &) = delete;
+		
+		/**
+		 Encodes next chunk of data. The partial triplet at the end of the chunk is kept
+		 in the encoder and is processed with the next call to update() or finish().
+		 Returns false only if the encoder has an invalid |wrap_size|.
+		 */
+		bool update(const ByteRange & data);
+		
+		/**
+		 Encodes all segments from the |data| list, in the same way as the sequence
+		 of update() calls would do.
+		 */
+		bool update(const ByteRangeList & data)
+		{
+			for (const ByteRange & segment : data) {
+				if (!update(segment)) {
+					return false;
+				}
+			}
+			return true;
+		}
+		
+		/**
+		 Encodes the rest of data, including the padding, and passes all remaining characters
+		 to the sink. After the call, the encoder is ready for encoding of another data.
+		 Returns false only if the encoder has an invalid |wrap_size|.
+		 */
+		bool finish();
+		
+	private:
+		
+		void _encodeTriplets(const cc7::byte * in_p, size_t in_len);
+		void _flush();
+		
+		size_t		_wrap_size;
+		size_t		_line_length;
+		Sink		_sink;
+		bool		_valid;
+		size_t		_pending_size;
+		cc7::byte	_pending[3];
+		size_t		_buffer_size;
+		char		_buffer[BufferSize];
+	};
+	
+	/**
+	 The Base64Decoder class converts Base64 encoded string into data incrementally.
+	 You can provide an input string in multiple chunks with arbitrary size, and the
+	 partial blocks are carried between the chunks. The produced bytes are passed to the
+	 sink function, provided in the constructor, so the memory consumed by the decoder
+	 doesn't depend on the size of the input string.
+	 
+	 The decoder accepts the same strings as the Base64_Decode() function. If the |wrap_size|
+	 is greater than 0, then the multiline input string is expected. In this case, the size
+	 of wrapping is just a hint and the decoder can process strings with a different size of lines.
+	 
+	 Note that if the error is detected, then the sink may already receive a part of the
+	 data. In this case, you should discard all received data.
+	 */
+	class Base64Decoder
+	{
+	public:
+		
+		/**
+		 The sink function receives chunks of the decoded data. The provided
+		 range is valid only during the call.
+		 */
+		typedef std::function<void (const ByteRange & chunk)> Sink;
+		
+		/**
+		 Size of the internal buffer for the produced bytes.
+		 */
+		static const size_t BufferSize = 3072;
+		
+		/**
+		 Constructs a new decoder for the required |wrap_size| and the |sink| function.
+		 The |wrap_size| must be divisible by 4, otherwise all subsequent calls to update()
+		 and finish() will fail.
+		 */
+		Base64Decoder(size_t wrap_size, Sink sink);
+		
+		/**
+		 Destroys the decoder and securely cleans all internal buffers.
+		 */
+		~Base64Decoder();
+		
+		Base64Decoder(const Base64Decoder &) = delete;
+		Base64Decoder & operator=(const Base64Decoder &) = delete;
+		
+		/**
+		 Decodes next chunk of the Base64 encoded string. Returns false if the chunk
+		 contains an invalid character or sequence, or if the decoder already failed
+		 in a previous call.
+		 */
+		bool update(const ByteRange & string);
+		
+		/**
+		 Decodes next chunk of the Base64 encoded string.
+		 */
+		bool update(const std::string & string)
+		{
+			return update(MakeRange(string));
+		}
+		
+		/**
+		 Decodes all segments from the |string| list, in the same way as the sequence
+		 of update() calls would do.
+		 */
+		bool update(const ByteRangeList & string)
+		{
+			for (const ByteRange & segment : string) {
+				if (!update(segment)) {
+					return false;
+				}
+			}
+			return true;
+		}
+		
+		/**
+		 Finishes the decoding and passes all remaining bytes to the sink. Returns false
+		 if the whole string was not a valid Base64 string. After the call, the decoder
+		 is ready for decoding of another string.
+		 */
+		bool finish();
+		
+	private:
+		
+		bool _decodeBlocks(const cc7::byte * block_4, size_t blocks_count);
+		bool _decodeBlock(const cc7::byte * block_4);
+		bool _fail();
+		void _flush();
+		void _reset();
+		
+		size_t		_wrap_size;
+		Sink		_sink;
+		bool		_failed;
+		bool		_end_marker;
+		size_t		_pending_size;
+		cc7::byte	_pending[4];
+		size_t		_buffer_size;
+		cc7::byte	_buffer[BufferSize];
+	};
+	
 } // cc7
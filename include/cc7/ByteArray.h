@@ -136,7 +136,10 @@ namespace cc7
 		}
 		
 		bool readFromBase64String(const std::string & base64_string, size_t wrap_size = 0);
+		bool readFromBase64String(const ByteRange & base64_string, size_t wrap_size = 0);
+		bool readFromBase64String(const char * base64_string, size_t length, size_t wrap_size);
 		bool readFromHexString(const std::string & hex_string);
+		bool readFromHexString(const ByteRange & hex_string);
 		
 		std::string base64String(size_t wrap_size = 0) const;
 		std::string hexString(bool lower_case = false) const;
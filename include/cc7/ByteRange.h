@@ -20,6 +20,8 @@
 
 namespace cc7
 {	
+	class ByteRangeSplit;
+	
 	class ByteRange
 	{
 	public:
@@ -90,6 +92,8 @@ namespace cc7
 		{
 		}
 		
+		ByteRange & operator=(const ByteRange &) noexcept = default;
+		
 		explicit ByteRange(const void * ptr, size_type size) noexcept :
 			_begin (reinterpret_cast<const_pointer>(ptr)),
 			_end   (_begin ? _begin + size : nullptr)
@@ -265,7 +269,7 @@ namespace cc7
 		
 		const_reverse_iterator crend() const
 		{
-			return const_reverse_iterator(_end);
+			return const_reverse_iterator(_begin);
 		}
 		
 		// Non-STL methods
@@ -317,6 +321,56 @@ namespace cc7
 			return _ByteRangeExceptions::out_of_range();
 		}
 			
+		// Search
+		//
+		// All search methods have the same semantics as methods with the same name
+		// in std::string. They return position of the found byte or sequence, or npos,
+		// if there's no match. The search is vectorized when it's possible.
+		
+		size_type find(cc7::byte value, size_type pos = 0) const noexcept
+		{
+			if (pos < size()) {
+				const void * found = memchr(_begin + pos, value, size() - pos);
+				if (found) {
+					return static_cast<const_pointer>(found) - _begin;
+				}
+			}
+			return npos;
+		}
+		
+		size_type find(const ByteRange & sequence, size_type pos = 0) const noexcept;
+		size_type rfind(cc7::byte value, size_type pos = npos) const noexcept;
+		size_type rfind(const ByteRange & sequence, size_type pos = npos) const noexcept;
+		
+		/**
+		 Returns position of the first byte, which is equal to any byte from |set|.
+		 */
+		size_type find_first_of(const ByteRange & set, size_type pos = 0) const noexcept;
+		
+		/**
+		 Returns position of the first byte, which is not equal to any byte from |set|.
+		 */
+		size_type find_first_not_of(const ByteRange & set, size_type pos = 0) const noexcept;
+		
+		/**
+		 Returns a lazy sequence of parts separated by the |delimiter|. Like in other
+		 languages, N delimiters always produce N + 1 parts, so the empty range
+		 produces one empty part. The parts reference the bytes of this range.
+		 
+		      for (const ByteRange & line : data.split('\n')) {
+		          ...
+		      }
+		 */
+		ByteRangeSplit split(cc7::byte delimiter) const;
+		
+		/**
+		 Returns a lazy sequence of parts separated by the |delimiter| sequence.
+		 If the delimiter is empty, then the whole range is returned as one part.
+		 */
+		ByteRangeSplit split(const ByteRange & delimiter) const;
+		
+		// Note that the comparison is not performed in constant time.
+		// Use cc7::SecureCompare() from <cc7/SecureMemory.h> for secrets.
 		int compare(const ByteRange & other) const noexcept
 		{
 			const size_type ts = size();
@@ -343,6 +397,154 @@ namespace cc7
 			
 	};
 		
+	/**
+	 The ByteRangeSplit class is a lazy sequence of parts of the ByteRange, separated
+	 by a delimiter. Each part is found only when the iterator advances to it.
+	 Use ByteRange::split() to create the sequence.
+	 */
+	class ByteRangeSplit
+	{
+	public:
+		
+		class const_iterator
+		{
+		public:
+			
+			typedef std::forward_iterator_tag	iterator_category;
+			typedef ByteRange					value_type;
+			typedef ptrdiff_t					difference_type;
+			typedef const ByteRange *			pointer;
+			typedef const ByteRange &			reference;
+			
+			const_iterator() :
+				_owner	(nullptr),
+				_pos	(ByteRange::npos)
+			{
+			}
+			
+			reference operator*() const
+			{
+				return _part;
+			}
+			
+			pointer operator->() const
+			{
+				return &_part;
+			}
+			
+			const_iterator & operator++()
+			{
+				_owner->_next(*this);
+				return *this;
+			}
+			
+			const_iterator operator++(int)
+			{
+				const_iterator prev = *this;
+				_owner->_next(*this);
+				return prev;
+			}
+			
+			bool operator==(const const_iterator & other) const
+			{
+				return _pos == other._pos;
+			}
+			
+			bool operator!=(const const_iterator & other) const
+			{
+				return _pos != other._pos;
+			}
+			
+		private:
+			
+			friend class ByteRangeSplit;
+			
+			const ByteRangeSplit *	_owner;
+			ByteRange::size_type	_pos;		// position of the current part, or npos at the end
+			ByteRange				_part;
+		};
+		
+		typedef const_iterator iterator;
+		
+		ByteRangeSplit(const ByteRange & range, cc7::byte delimiter) :
+			_range			(range),
+			_single			(true),
+			_delimiter_byte	(delimiter)
+		{
+		}
+		
+		ByteRangeSplit(const ByteRange & range, const ByteRange & delimiter) :
+			_range			(range),
+			_delimiter		(delimiter),
+			_single			(false),
+			_delimiter_byte	(0)
+		{
+		}
+		
+		const_iterator begin() const
+		{
+			const_iterator it;
+			it._owner = this;
+			_setPart(it, 0);
+			return it;
+		}
+		
+		const_iterator end() const
+		{
+			const_iterator it;
+			it._owner = this;
+			return it;
+		}
+		
+	private:
+		
+		ByteRange	_range;
+		ByteRange	_delimiter;
+		bool		_single;
+		cc7::byte	_delimiter_byte;
+		
+		size_t _delimiterSize() const
+		{
+			return _single ? 1 : _delimiter.size();
+		}
+		
+		void _setPart(const_iterator & it, size_t pos) const
+		{
+			size_t part_end = ByteRange::npos;
+			if (_single) {
+				part_end = _range.find(_delimiter_byte, pos);
+			} else if (!_delimiter.empty()) {
+				part_end = _range.find(_delimiter, pos);
+			}
+			if (part_end == ByteRange::npos) {
+				part_end = _range.size();
+			}
+			it._pos  = pos;
+			it._part = ByteRange(_range.data() + pos, part_end - pos);
+		}
+		
+		void _next(const_iterator & it) const
+		{
+			const size_t part_end = it._pos + it._part.size();
+			if (part_end < _range.size()) {
+				_setPart(it, part_end + _delimiterSize());
+			} else {
+				it._pos  = ByteRange::npos;
+				it._part = ByteRange();
+			}
+		}
+	};
+	
+	inline ByteRangeSplit ByteRange::split(cc7::byte delimiter) const
+	{
+		return ByteRangeSplit(*this, delimiter);
+	}
+	
+	inline ByteRangeSplit ByteRange::split(const ByteRange & delimiter) const
+	{
+		return ByteRangeSplit(*this, delimiter);
+	}
+	
 	// ByteRange comparation operators
 	
 	inline bool operator==(const ByteRange & x, const ByteRange & y)
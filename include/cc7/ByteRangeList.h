@@ -0,0 +1,278 @@
+/*
+ * Copyright 2016 Juraj Durech <durech.juraj@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cc7/ByteArray.h>
+#include <algorithm>
+
+namespace cc7
+{
+	/**
+	 The ByteRangeList class is a sequence of ByteRange segments, which are
+	 treated as one continuous block of bytes. The list allows you to assemble
+	 a message from several parts, without copying them into one buffer.
+	 Like the ByteRange, the list doesn't own the memory, so all referenced
+	 bytes must be valid for the whole list's lifetime.
+	 
+	 The list iterates over segments, so you can pass the data to consumers
+	 accepting data in chunks, for example, to the streaming codecs or
+	 to the writev() system call:
+	 
+	      ByteRangeList frame = { header, payload, mac };
+	      struct iovec iov[8];
+	      size_t iov_count = frame.fillIOVec(iov, 8);
+	      writev(fd, iov, (int)iov_count);
+	 
+	 Empty segments are never stored in the list. Methods working with byte
+	 positions have to find the right segment first, so their complexity is
+	 linear with number of segments.
+	 */
+	class ByteRangeList
+	{
+	public:
+		
+		typedef std::vector<ByteRange>			container_type;
+		typedef container_type::const_iterator	const_iterator;
+		typedef const_iterator					iterator;
+		typedef size_t							size_type;
+		
+		typedef cc7::detail::ExceptionsWrapper<cc7::byte> _ValueTypeExceptions;
+		typedef cc7::detail::ExceptionsWrapper<ByteRangeList> _ByteRangeListExceptions;
+		
+		// Constructors
+		
+		ByteRangeList() :
+			_size(0)
+		{
+		}
+		
+		explicit ByteRangeList(const ByteRange & range) :
+			_size(0)
+		{
+			append(range);
+		}
+		
+		ByteRangeList(std::initializer_list<ByteRange> ranges) :
+			_size(0)
+		{
+			_segments.reserve(ranges.size());
+			for (const ByteRange & range : ranges) {
+				append(range);
+			}
+		}
+		
+		// Building the list
+		
+		/**
+		 Appends |range| at the end of the list.
+		 */
+		ByteRangeList & append(const ByteRange & range)
+		{
+			if (!range.empty()) {
+				_segments.push_back(range);
+				_size += range.size();
+			}
+			return *this;
+		}
+		
+		/**
+		 Appends all segments from |list| at the end of this list.
+		 */
+		ByteRangeList & append(const ByteRangeList & list);
+		
+		/**
+		 Inserts |range| at the beginning of the list.
+		 */
+		ByteRangeList & prepend(const ByteRange & range);
+		
+		/**
+		 Reserves space for |segments_count| segments.
+		 */
+		void reserve(size_t segments_count)
+		{
+			_segments.reserve(segments_count);
+		}
+		
+		/**
+		 Removes all segments from the list.
+		 */
+		void clear()
+		{
+			_segments.clear();
+			_size = 0;
+		}
+		
+		// Size & segments
+		
+		/**
+		 Returns total number of bytes in all segments.
+		 */
+		size_type size() const
+		{
+			return _size;
+		}
+		
+		bool empty() const
+		{
+			return _size == 0;
+		}
+		
+		/**
+		 Returns number of segments in the list.
+		 */
+		size_t segmentCount() const
+		{
+			return _segments.size();
+		}
+		
+		/**
+		 Returns segment at |index|.
+		 */
+		const ByteRange & segment(size_t index) const
+		{
+			return _segments.at(index);
+		}
+		
+		/**
+		 Returns vector with all segments.
+		 */
+		const container_type & segments() const
+		{
+			return _segments;
+		}
+		
+		// Segment iterators
+		
+		const_iterator begin() const
+		{
+			return _segments.begin();
+		}
+		
+		const_iterator end() const
+		{
+			return _segments.end();
+		}
+		
+		// Accessing bytes
+		
+		/**
+		 Returns byte at |index|. Throws out_of_range exception if index is
+		 greater or equal than size().
+		 */
+		cc7::byte at(size_t index) const;
+		
+		/**
+		 Returns a new list, which references |count| bytes starting at |from|
+		 position. The segments at both ends are trimmed, all other segments are
+		 shared. Throws out_of_range exception if the range is not in the list.
+		 */
+		ByteRangeList subList(size_t from, size_t count) const;
+		
+		ByteRangeList subListFrom(size_t from) const
+		{
+			if (from <= _size) {
+				return subList(from, _size - from);
+			}
+			return _ByteRangeListExceptions::out_of_range();
+		}
+		
+		ByteRangeList subListTo(size_t to) const
+		{
+			return subList(0, to);
+		}
+		
+		/**
+		 Removes |count| bytes from the beginning of the list. Throws out_of_range
+		 exception if the list has less bytes.
+		 */
+		void removePrefix(size_t count);
+		
+		/**
+		 Removes |count| bytes from the end of the list. Throws out_of_range
+		 exception if the list has less bytes.
+		 */
+		void removeSuffix(size_t count);
+		
+		// Gather
+		
+		/**
+		 Copies up to |capacity| bytes from the beginning of the list into |out|.
+		 Returns number of copied bytes.
+		 */
+		size_t copyTo(void * out, size_t capacity) const;
+		
+		/**
+		 Appends all bytes from the list at the end of |out| array.
+		 */
+		void appendTo(ByteArray & out) const;
+		
+		/**
+		 Returns a new ByteArray with copy of all bytes from the list.
+		 */
+		ByteArray flatten() const
+		{
+			ByteArray result;
+			appendTo(result);
+			return result;
+		}
+		
+		/**
+		 Returns true if both lists contain the same bytes. The segmentation of
+		 lists doesn't matter.
+		 */
+		bool equals(const ByteRangeList & other) const;
+		
+		/**
+		 Fills up to |max_count| I/O vectors at |iov| with the list's segments and
+		 returns number of filled vectors. The IOVec type must have iov_base and
+		 iov_len members, like the POSIX "struct iovec". If the list has more segments
+		 than |max_count|, then you can use subListFrom() to process the rest.
+		 */
+		template <typename IOVec>
+		size_t fillIOVec(IOVec * iov, size_t max_count) const
+		{
+			const size_t count = std::min(max_count, _segments.size());
+			for (size_t i = 0; i < count; i++) {
+				iov[i].iov_base = const_cast<cc7::byte*>(_segments[i].data());
+				iov[i].iov_len  = _segments[i].size();
+			}
+			return count;
+		}
+		
+	private:
+		
+		container_type	_segments;
+		size_t			_size;
+		
+		/*
+		 Returns index of segment containing byte at |position| and changes
+		 the position to offset in that segment.
+		 */
+		size_t _findSegment(size_t & position) const;
+	};
+	
+	inline bool operator==(const ByteRangeList & a, const ByteRangeList & b)
+	{
+		return a.equals(b);
+	}
+	
+	inline bool operator!=(const ByteRangeList & a, const ByteRangeList & b)
+	{
+		return !a.equals(b);
+	}
+	
+} // cc7
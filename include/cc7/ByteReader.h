@@ -0,0 +1,324 @@
+/*
+ * Copyright 2016 Juraj Durech <durech.juraj@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cc7/ByteRange.h>
+#include <cc7/Endian.h>
+
+namespace cc7
+{
+	/**
+	 The ByteReader class is a cursor for parsing binary data from a ByteRange.
+	 The reader doesn't copy the data, so the memory referenced by the range must
+	 be valid for the whole reader's lifetime, including all sub-ranges returned
+	 from the reader.
+	 
+	 Unlike the ByteRange's methods, the reader never throws. Each read checks
+	 the remaining length only once and if there's not enough data, then the reader
+	 switches to the error state and returns zero, or an empty range. The error is
+	 sticky, so all following reads fail too and you can check hasError() only once,
+	 after the whole structure is parsed:
+	 
+	      ByteReader reader(data);
+	      U8  version = reader.readU8();
+	      U32 counter = reader.readU32BE();
+	      ByteRange payload = reader.readRange(ByteReader::U16BE_Length);
+	      if (reader.hasError() || !reader.atEnd()) {
+	          return false;
+	      }
+	 */
+	class ByteReader
+	{
+	public:
+		
+		/**
+		 Format of length prefix for readRange(LengthPrefix) method.
+		 */
+		enum LengthPrefix
+		{
+			U8_Length,
+			U16BE_Length,
+			U16LE_Length,
+			U32BE_Length,
+			U32LE_Length,
+			Varint_Length,		// unsigned LEB128
+		};
+		
+		/**
+		 Constructs an empty reader.
+		 */
+		ByteReader() noexcept :
+			_begin	(nullptr),
+			_cur	(nullptr),
+			_end	(nullptr),
+			_error	(false)
+		{
+		}
+		
+		/**
+		 Constructs a reader for bytes referenced by |range|.
+		 */
+		explicit ByteReader(const ByteRange & range) noexcept :
+			_begin	(range.data()),
+			_cur	(range.data()),
+			_end	(range.data() + range.size()),
+			_error	(false)
+		{
+		}
+		
+		// State
+		
+		/**
+		 Returns true if some read failed, or if setError() was called.
+		 */
+		bool hasError() const
+		{
+			return _error;
+		}
+		
+		/**
+		 Switches the reader to the error state. You can use this method when
+		 the parsed value is not acceptable, so the rest of parsing can be skipped.
+		 */
+		void setError()
+		{
+			_error = true;
+			_cur   = _end;
+		}
+		
+		/**
+		 Returns true if there are no more bytes to read.
+		 */
+		bool atEnd() const
+		{
+			return _cur == _end;
+		}
+		
+		/**
+		 Returns number of bytes already consumed from the beginning of the range.
+		 */
+		size_t position() const
+		{
+			return _cur - _begin;
+		}
+		
+		/**
+		 Returns number of bytes available for reading.
+		 */
+		size_t remaining() const
+		{
+			return _end - _cur;
+		}
+		
+		/**
+		 Returns range with all bytes available for reading.
+		 */
+		ByteRange remainingRange() const
+		{
+			return ByteRange(_cur, remaining());
+		}
+		
+		/**
+		 Returns true if at least |count| bytes are available for reading.
+		 */
+		bool canRead(size_t count) const
+		{
+			return remaining() >= count;
+		}
+		
+		// Integers
+		
+		U8  readU8()    { return _read<U8>(); }
+		U16 readU16BE() { return FromBigEndian(_read<U16>()); }
+		U16 readU16LE() { return FromLittleEndian(_read<U16>()); }
+		U32 readU32BE() { return FromBigEndian(_read<U32>()); }
+		U32 readU32LE() { return FromLittleEndian(_read<U32>()); }
+		U64 readU64BE() { return FromBigEndian(_read<U64>()); }
+		U64 readU64LE() { return FromLittleEndian(_read<U64>()); }
+		
+		/**
+		 Reads unsigned LEB128 encoded integer. The encoding longer than 10 bytes,
+		 or the value which doesn't fit into 64 bits, is treated as an error.
+		 */
+		U64 readVarint()
+		{
+			U64 result = 0;
+			for (unsigned shift = 0; _cur < _end && shift < 64; shift += 7) {
+				const U8 b = *_cur++;
+				if (shift == 63 && b > 1) {
+					break;
+				}
+				result |= U64(b & 0x7F) << shift;
+				if ((b & 0x80) == 0) {
+					return result;
+				}
+			}
+			setError();
+			return 0;
+		}
+		
+		/**
+		 Reads signed LEB128 encoded integer. The encoding longer than 10 bytes
+		 is treated as an error.
+		 */
+		int64_t readSignedVarint()
+		{
+			U64 result = 0;
+			for (unsigned shift = 0; _cur < _end && shift < 64; shift += 7) {
+				const U8 b = *_cur++;
+				result |= U64(b & 0x7F) << shift;
+				if ((b & 0x80) == 0) {
+					if (shift < 57 && (b & 0x40)) {
+						// Extend the sign
+						result |= ~U64(0) << (shift + 7);
+					}
+					return static_cast<int64_t>(result);
+				}
+			}
+			setError();
+			return 0;
+		}
+		
+		/**
+		 Reads |count| integers in big endian into |out| array, converted to machine's
+		 byte order. Returns false and leaves |out| untouched if there's not enough data.
+		 */
+		template <typename T> bool readArrayBE(T * out, size_t count)
+		{
+			if (count > remaining() / sizeof(T)) {
+				setError();
+				return false;
+			}
+			_readBytes(out, count * sizeof(T));
+			FromBigEndian(out, count);
+			return true;
+		}
+		
+		/**
+		 Reads |count| integers in little endian into |out| array, converted to machine's
+		 byte order. Returns false and leaves |out| untouched if there's not enough data.
+		 */
+		template <typename T> bool readArrayLE(T * out, size_t count)
+		{
+			if (count > remaining() / sizeof(T)) {
+				setError();
+				return false;
+			}
+			_readBytes(out, count * sizeof(T));
+			FromLittleEndian(out, count);
+			return true;
+		}
+		
+		// Bytes
+		
+		/**
+		 Copies |count| bytes into |out|. Returns false and leaves |out| untouched
+		 if there's not enough data.
+		 */
+		bool readBytes(void * out, size_t count)
+		{
+			return _readBytes(out, count);
+		}
+		
+		/**
+		 Returns range with next |count| bytes. The bytes are not copied.
+		 */
+		ByteRange readRange(size_t count)
+		{
+			const cc7::byte * ptr = _cur;
+			return _advance(count) ? ByteRange(ptr, count) : ByteRange();
+		}
+		
+		/**
+		 Reads length in format specified by |prefix| and then returns range with
+		 the following bytes of that length. The bytes are not copied.
+		 */
+		ByteRange readRange(LengthPrefix prefix)
+		{
+			U64 length;
+			switch (prefix) {
+				case U8_Length:		length = readU8(); break;
+				case U16BE_Length:	length = readU16BE(); break;
+				case U16LE_Length:	length = readU16LE(); break;
+				case U32BE_Length:	length = readU32BE(); break;
+				case U32LE_Length:	length = readU32LE(); break;
+				case Varint_Length:	length = readVarint(); break;
+				default:			length = 0; setError(); break;
+			}
+			if (length > remaining()) {
+				setError();
+				return ByteRange();
+			}
+			return readRange(static_cast<size_t>(length));
+		}
+		
+		/**
+		 Skips |count| bytes. Returns false if there's not enough data.
+		 */
+		bool skip(size_t count)
+		{
+			return _advance(count);
+		}
+		
+	private:
+		
+		const cc7::byte *	_begin;
+		const cc7::byte *	_cur;
+		const cc7::byte *	_end;
+		bool				_error;
+		
+		/*
+		 Moves the cursor by |count| bytes. Returns false and switches to the error
+		 state when there's not enough data. Note that the cursor is nullptr for
+		 an empty range, so the result must not depend on the pointer.
+		 */
+		bool _advance(size_t count)
+		{
+			if (remaining() < count) {
+				setError();
+				return false;
+			}
+			_cur += count;
+			return true;
+		}
+		
+		bool _readBytes(void * out, size_t size)
+		{
+			const cc7::byte * ptr = _cur;
+			if (!_advance(size)) {
+				return false;
+			}
+			if (size > 0) {
+				memcpy(out, ptr, size);
+			}
+			return true;
+		}
+		
+		template <typename T> T _read()
+		{
+			T value = 0;
+			if (remaining() >= sizeof(T)) {
+				memcpy(&value, _cur, sizeof(T));
+				_cur += sizeof(T);
+			} else {
+				setError();
+			}
+			return value;
+		}
+	};
+	
+} // cc7
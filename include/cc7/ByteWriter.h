@@ -0,0 +1,264 @@
+/*
+ * Copyright 2016 Juraj Durech <durech.juraj@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cc7/ByteArray.h>
+#include <cc7/ByteReader.h>
+
+namespace cc7
+{
+	/**
+	 The ByteWriter class serializes binary data into a ByteArray, or into a fixed
+	 size buffer. It's a counterpart to the ByteReader class.
+	 
+	 When the writer appends to a ByteArray, then the array is resized to its
+	 whole capacity and the writer stores all values directly into that memory,
+	 so each write is just a pointer bump. When there's no space left, then the
+	 capacity grows exponentially. The final size of the array is set in finish(),
+	 or in the writer's destructor. You should not access the target array while
+	 the writer is in use. If you know the size of the message, then you can
+	 reserve the space up-front and the whole message is serialized into one
+	 allocation:
+	 
+	      ByteArray message;
+	      ByteWriter writer(message, 5 + payload.size());
+	      writer.writeU8(version);
+	      size_t length_pos = writer.writePlaceholder(4);
+	      writer.writeRange(payload);
+	      writer.patchU32BE(length_pos, writer.position() - length_pos - 4);
+	      writer.finish();
+	 
+	 When the writer uses a fixed buffer, then writing beyond the buffer's capacity
+	 switches the writer to the error state. Other failures, like a range too long
+	 for its length prefix, switch both kinds of writers to the error state. The error
+	 is sticky, so all following writes fail too and you can check hasError() only
+	 once, at the end.
+	 */
+	class ByteWriter
+	{
+	public:
+		
+		/**
+		 Constructs a writer, which appends data to the |target| array.
+		 The |reserve_size| bytes are reserved up-front.
+		 */
+		explicit ByteWriter(ByteArray & target, size_t reserve_size = 0);
+		
+		/**
+		 Constructs a writer, which stores data to the |buffer| with |capacity| bytes.
+		 */
+		ByteWriter(void * buffer, size_t capacity) noexcept;
+		
+		/**
+		 Destroys the writer. The target array is truncated to the written data.
+		 */
+		~ByteWriter();
+		
+		ByteWriter(const ByteWriter &) = delete;
+		ByteWriter & operator=(const ByteWriter &) = delete;
+		
+		// State
+		
+		/**
+		 Returns true if some write failed.
+		 */
+		bool hasError() const
+		{
+			return _error;
+		}
+		
+		/**
+		 Returns number of bytes written by this writer.
+		 */
+		size_t position() const
+		{
+			return _cur - _begin;
+		}
+		
+		/**
+		 Returns range with all bytes written by this writer. The range is valid
+		 only until the next write, but you can pass it back to writeRange().
+		 */
+		ByteRange writtenRange() const
+		{
+			return ByteRange(_begin, position());
+		}
+		
+		/**
+		 Makes sure that the next |size| bytes can be written without
+		 reallocation. Returns false and switches the writer to the error state
+		 if the fixed buffer has no such capacity.
+		 */
+		bool reserve(size_t size)
+		{
+			return size_t(_end - _cur) >= size || _grow(size, true);
+		}
+		
+		/**
+		 Sets the final size of the target array. The writer can be still used
+		 after this call. The method does nothing for the fixed buffer.
+		 */
+		void finish();
+		
+		// Integers
+		
+		void writeU8(U8 n)     { _write(n); }
+		void writeU16BE(U16 n) { _write(ToBigEndian(n)); }
+		void writeU16LE(U16 n) { _write(ToLittleEndian(n)); }
+		void writeU32BE(U32 n) { _write(ToBigEndian(n)); }
+		void writeU32LE(U32 n) { _write(ToLittleEndian(n)); }
+		void writeU64BE(U64 n) { _write(ToBigEndian(n)); }
+		void writeU64LE(U64 n) { _write(ToLittleEndian(n)); }
+		
+		/**
+		 Writes unsigned LEB128 encoded integer.
+		 */
+		void writeVarint(U64 n);
+		
+		/**
+		 Writes signed LEB128 encoded integer.
+		 */
+		void writeSignedVarint(int64_t n);
+		
+		/**
+		 Returns number of bytes required for unsigned LEB128 encoding of |n|.
+		 */
+		static size_t VarintSize(U64 n);
+		
+		/**
+		 Returns number of bytes required for signed LEB128 encoding of |n|.
+		 */
+		static size_t SignedVarintSize(int64_t n);
+		
+		/**
+		 Writes |count| integers from |in| in big endian byte order.
+		 */
+		template <typename T> void writeArrayBE(const T * in, size_t count)
+		{
+			_writeArray(in, count, true);
+		}
+		
+		/**
+		 Writes |count| integers from |in| in little endian byte order.
+		 */
+		template <typename T> void writeArrayLE(const T * in, size_t count)
+		{
+			_writeArray(in, count, false);
+		}
+		
+		// Bytes
+		
+		/**
+		 Writes |size| bytes from |ptr|.
+		 */
+		void writeBytes(const void * ptr, size_t size)
+		{
+			if (size_t(_end - _cur) < size) {
+				_writeBytesWithGrow(ptr, size);
+			} else if (size > 0) {
+				memcpy(_cur, ptr, size);
+				_cur += size;
+			}
+		}
+		
+		/**
+		 Writes all bytes from |range|.
+		 */
+		void writeRange(const ByteRange & range)
+		{
+			writeBytes(range.data(), range.size());
+		}
+		
+		/**
+		 Writes length of |range| in format specified by |prefix| and then all
+		 bytes from the range. If the length doesn't fit into the prefix, then
+		 the writer switches to the error state.
+		 */
+		void writeRange(const ByteRange & range, ByteReader::LengthPrefix prefix);
+		
+		// Placeholders
+		
+		/**
+		 Writes |size| zero bytes and returns the position of the first byte, which
+		 can be later overwritten by one of patch methods. Returns ByteRange::npos
+		 if the writer is in the error state.
+		 */
+		size_t writePlaceholder(size_t size);
+		
+		/**
+		 Overwrites already written bytes at |position|. Returns false if the bytes
+		 at the position were not written yet.
+		 */
+		bool patchU8(size_t position, U8 n)     { return _patch(position, n); }
+		bool patchU16BE(size_t position, U16 n) { return _patch(position, ToBigEndian(n)); }
+		bool patchU16LE(size_t position, U16 n) { return _patch(position, ToLittleEndian(n)); }
+		bool patchU32BE(size_t position, U32 n) { return _patch(position, ToBigEndian(n)); }
+		bool patchU32LE(size_t position, U32 n) { return _patch(position, ToLittleEndian(n)); }
+		bool patchU64BE(size_t position, U64 n) { return _patch(position, ToBigEndian(n)); }
+		bool patchU64LE(size_t position, U64 n) { return _patch(position, ToLittleEndian(n)); }
+		
+	private:
+		
+		ByteArray *		_target;	// nullptr for the fixed buffer
+		size_t			_base;		// initial size of the target array
+		cc7::byte *		_begin;
+		cc7::byte *		_cur;
+		cc7::byte *		_end;
+		bool			_error;
+		
+		bool _grow(size_t size, bool exact);
+		void _writeBytesWithGrow(const void * ptr, size_t size);
+		
+		/*
+		 Like reserve(), but the array target grows exponentially.
+		 */
+		bool _reserve(size_t size)
+		{
+			return size_t(_end - _cur) >= size || _grow(size, false);
+		}
+		
+		/*
+		 Like _reserve(), but if the |source| points to the target array, then
+		 it's updated to the same bytes in the reallocated array.
+		 */
+		bool _reserve(size_t size, const cc7::byte * & source);
+		void _setError();
+		
+		void _writeArray(const U16 * in, size_t count, bool big_endian);
+		void _writeArray(const U32 * in, size_t count, bool big_endian);
+		void _writeArray(const U64 * in, size_t count, bool big_endian);
+		
+		template <typename T> void _write(T value)
+		{
+			if (size_t(_end - _cur) >= sizeof(T) || _grow(sizeof(T), false)) {
+				memcpy(_cur, &value, sizeof(T));
+				_cur += sizeof(T);
+			}
+		}
+		
+		template <typename T> bool _patch(size_t position, T value)
+		{
+			if (position > this->position() || this->position() - position < sizeof(T)) {
+				_setError();
+				return false;
+			}
+			memcpy(_begin + position, &value, sizeof(T));
+			return true;
+		}
+	};
+	
+} // cc7
@@ -19,8 +19,18 @@
 #include <cc7/Platform.h>
 #include <cc7/DebugFeatures.h>
 #include <cc7/Endian.h>
+#include <cc7/CpuFeatures.h>
 #include <cc7/ByteArray.h>
+#include <cc7/ByteRangeList.h>
+#include <cc7/ByteReader.h>
+#include <cc7/ByteWriter.h>
 #include <cc7/Utilities.h>
 #include <cc7/Base32.h>
 #include <cc7/Base64.h>
 #include <cc7/HexString.h>
+#include <cc7/CodecBatch.h>
+#include <cc7/SmallByteArray.h>
+#include <cc7/SecureArena.h>
+#include <cc7/SecureBuffer.h>
+#include <cc7/SecureHeap.h>
+#include <cc7/SecureMemory.h>
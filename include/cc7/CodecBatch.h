@@ -0,0 +1,88 @@
+/**
+ * Copyright 2018 Wultra s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cc7/Base32.h>
+#include <cc7/Base64.h>
+#include <cc7/HexString.h>
+
+namespace cc7
+{
+	//
+	// The batch functions encode, or decode many small values in one call. All results are
+	// written into one contiguous output string, or byte array, and the |out_offsets| table
+	// contains positions of the results. The table has one more item than the input list,
+	// so the result for i-th input is between out_offsets[i] and out_offsets[i + 1].
+	//
+	// If you reuse the output objects between calls, then the batch functions don't
+	// allocate memory at all.
+	//
+	
+	// MARK: Hexadecimal -
+	
+	/**
+	 Converts all byte ranges from |items| into hexadecimal upper, or lowercase strings.
+	 The function always returns true.
+	 */
+	bool HexString_EncodeBatch(const std::vector<ByteRange> & items, bool use_lowercase,
+							   std::string & out_string, std::vector<size_t> & out_offsets);
+	
+	/**
+	 Converts all hexadecimal strings from |strings| into bytes. Returns false if any string
+	 is not a valid hexadecimal string. In this case, both output objects are empty.
+	 */
+	bool HexString_DecodeBatch(const std::vector<ByteRange> & strings,
+							   ByteArray & out_data, std::vector<size_t> & out_offsets);
+	
+	// MARK: Base64 -
+	
+	/**
+	 Converts all byte ranges from |items| into Base64 encoded strings, with no line wrapping.
+	 The |variant| parameter defines alphabet and padding of the produced strings.
+	 The function always returns true.
+	 */
+	bool Base64_EncodeBatch(const std::vector<ByteRange> & items,
+							std::string & out_string, std::vector<size_t> & out_offsets,
+							Base64_Variant variant = Base64_Standard);
+	
+	/**
+	 Converts all Base64 encoded strings from |strings| into bytes. Returns false if any string
+	 is not a valid Base64 string for the |variant|. In this case, both output objects are empty.
+	 */
+	bool Base64_DecodeBatch(const std::vector<ByteRange> & strings,
+							ByteArray & out_data, std::vector<size_t> & out_offsets,
+							Base64_Variant variant = Base64_Standard);
+	
+	// MARK: Base32 -
+	
+	/**
+	 Converts all byte ranges from |items| into Base32 encoded strings, with the required
+	 padding and alphabet. The function always returns true.
+	 */
+	bool Base32_EncodeBatch(const std::vector<ByteRange> & items, bool use_padding,
+							std::string & out_string, std::vector<size_t> & out_offsets,
+							Base32_Alphabet alphabet = Base32_Standard);
+	
+	/**
+	 Converts all Base32 encoded strings from |strings| into bytes. Returns false if any string
+	 is not a valid Base32 string. In this case, both output objects are empty.
+	 */
+	bool Base32_DecodeBatch(const std::vector<ByteRange> & strings, bool require_padding,
+							ByteArray & out_data, std::vector<size_t> & out_offsets,
+							Base32_Alphabet alphabet = Base32_Standard);
+	
+} // cc7
@@ -0,0 +1,111 @@
+/**
+ * Copyright 2018 Wultra s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cc7/Platform.h>
+#include <string>
+
+namespace cc7
+{
+namespace cpu
+{
+	/**
+	 The Feature enumeration defines flags for CPU features, which are relevant
+	 for the vectorized code. The flags can be combined into the feature mask.
+	 
+	 On x86, the feature is reported only if it's supported by both the CPU and
+	 the operating system, which must preserve the extended registers.
+	 */
+	enum Feature
+	{
+		// x86 & x86_64
+		SSE2		= 1 << 0,
+		SSSE3		= 1 << 1,
+		SSE41		= 1 << 2,
+		SSE42		= 1 << 3,
+		AVX			= 1 << 4,
+		AVX2		= 1 << 5,
+		BMI2		= 1 << 6,
+		AVX512F		= 1 << 7,
+		AVX512BW	= 1 << 8,
+		AVX512VBMI	= 1 << 9,
+		// ARM & ARM64
+		NEON		= 1 << 16,
+	};
+	
+	/**
+	 Returns mask with all features supported by the current CPU. The detection is
+	 performed only once, at the first call, and the function is thread safe.
+	 */
+	U32 GetFeatures();
+	
+	/**
+	 Returns true if all features from the |features| mask are supported by the current CPU.
+	 */
+	inline bool HasFeatures(U32 features)
+	{
+		return (GetFeatures() & features) == features;
+	}
+	
+	/**
+	 Returns comma separated names of features from the |features| mask,
+	 for example "sse2,ssse3,avx2". The function is useful for logs and reports.
+	 */
+	std::string FeaturesToString(U32 features);
+	
+	/**
+	 The Candidate structure describes one implementation of an algorithm, which
+	 requires all |features| from the mask. The |implementation| is typically
+	 a function pointer, or a structure with multiple function pointers.
+	 */
+	template <typename T>
+	struct Candidate
+	{
+		U32	features;
+		T	implementation;
+	};
+	
+	/**
+	 Returns the first implementation from |candidates| whose required features
+	 are all available in the |features| mask. The candidates must be ordered
+	 from the most preferred one and the last candidate is always returned as
+	 the fallback, so it should require no features.
+	 
+	 The typical dispatch keeps the selected implementation in a local static
+	 variable, so the selection is performed only once and is thread safe:
+	 
+		static const cpu::Candidate<Function> s_candidates[] = {
+			{ cpu::AVX2,  _Function_AVX2 },
+			{ cpu::SSSE3, _Function_SSSE3 },
+			{ 0,          _Function_Scalar },
+		};
+		static const Function s_function = cpu::Select(s_candidates);
+	 */
+	template <typename T, size_t N>
+	const T & Select(const Candidate<T> (&candidates)[N], U32 features = GetFeatures())
+	{
+		static_assert(N > 0, "At least one candidate is required");
+		for (size_t i = 0; i < N - 1; i++) {
+			if ((candidates[i].features & features) == candidates[i].features) {
+				return candidates[i].implementation;
+			}
+		}
+		return candidates[N - 1].implementation;
+	}
+	
+} // cc7::cpu
+} // cc7
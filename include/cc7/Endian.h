@@ -18,10 +18,11 @@
 
 #include <cc7/Platform.h>
 
-// Check for clang builtin byte swap functions
-#if defined(__clang__) && __has_builtin(__builtin_bswap16) \
-					   && __has_builtin(__builtin_bswap32) \
-					   && __has_builtin(__builtin_bswap64)
+// Check for clang or gcc builtin byte swap functions
+#if (defined(__clang__) && __has_builtin(__builtin_bswap16) \
+						&& __has_builtin(__builtin_bswap32) \
+						&& __has_builtin(__builtin_bswap64)) || \
+	(!defined(__clang__) && defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 8)))
 	#define CC7_BSWAP_16(n)	__builtin_bswap16(n)
 	#define CC7_BSWAP_32(n)	__builtin_bswap32(n)
 	#define CC7_BSWAP_64(n)	__builtin_bswap64(n)
@@ -71,8 +72,23 @@ namespace cc7
 					( n<<56);
 		#endif
 		}
+		
+		/*
+		 Swaps byte order of |count| elements from |in| and stores them to |out|.
+		 Both pointers may be equal, for the in-place conversion.
+		 */
+		void SwapEndianArray(const cc7::U16 * in, cc7::U16 * out, size_t count);
+		void SwapEndianArray(const cc7::U32 * in, cc7::U32 * out, size_t count);
+		void SwapEndianArray(const cc7::U64 * in, cc7::U64 * out, size_t count);
+		
+		template <typename T> inline void CopyArray(const T * in, T * out, size_t count)
+		{
+			if (in != out && count > 0) {
+				memcpy(out, in, count * sizeof(T));
+			}
+		}
 	}
-
+	
 	/**
 	 Converts integer |n|, which is in machine's byte order, into big endian representation.
 	 Only cc7::U16, cc7::U32 and cc7::U64, or compatible types, are supported in
@@ -100,6 +116,42 @@ namespace cc7
 	 */
 	template <typename T> T FromLittleEndian(T n);
 	
+	//
+	// Array conversions
+	//
+	// All following functions convert |count| integers at once and use vectorized
+	// implementation, when it's available on the current CPU. Each function has
+	// two variants: the first one reads integers from |in| and stores results to |out|,
+	// the second one converts the array in place. The |in| and |out| may point
+	// to the same array, otherwise both arrays must not overlap. If no conversion
+	// is required on the machine, then the array is just copied, or the in-place
+	// variant does nothing.
+	//
+	
+	/**
+	 Converts |count| integers in machine's byte order into big endian representation.
+	 */
+	template <typename T> void ToBigEndian(const T * in, T * out, size_t count);
+	template <typename T> void ToBigEndian(T * data, size_t count);
+	
+	/**
+	 Converts |count| integers in machine's byte order into little endian representation.
+	 */
+	template <typename T> void ToLittleEndian(const T * in, T * out, size_t count);
+	template <typename T> void ToLittleEndian(T * data, size_t count);
+	
+	/**
+	 Converts |count| big endian integers into machine's byte order representation.
+	 */
+	template <typename T> void FromBigEndian(const T * in, T * out, size_t count);
+	template <typename T> void FromBigEndian(T * data, size_t count);
+	
+	/**
+	 Converts |count| little endian integers into machine's byte order representation.
+	 */
+	template <typename T> void FromLittleEndian(const T * in, T * out, size_t count);
+	template <typename T> void FromLittleEndian(T * data, size_t count);
+	
 #if defined(CC7_LITTLE_ENDIAN)
 	
 	template <typename T> inline T ToBigEndian(T n)      { return detail::SwapEndian(n); }
@@ -107,12 +159,32 @@ namespace cc7
 	template <typename T> inline T FromBigEndian(T n)    { return detail::SwapEndian(n); }
 	template <typename T> inline T FromLittleEndian(T n) { return n; }
 	
+	template <typename T> inline void ToBigEndian(const T * in, T * out, size_t count)      { detail::SwapEndianArray(in, out, count); }
+	template <typename T> inline void ToLittleEndian(const T * in, T * out, size_t count)   { detail::CopyArray(in, out, count); }
+	template <typename T> inline void FromBigEndian(const T * in, T * out, size_t count)    { detail::SwapEndianArray(in, out, count); }
+	template <typename T> inline void FromLittleEndian(const T * in, T * out, size_t count) { detail::CopyArray(in, out, count); }
+	
+	template <typename T> inline void ToBigEndian(T * data, size_t count)      { detail::SwapEndianArray(data, data, count); }
+	template <typename T> inline void ToLittleEndian(T *, size_t)              { }
+	template <typename T> inline void FromBigEndian(T * data, size_t count)    { detail::SwapEndianArray(data, data, count); }
+	template <typename T> inline void FromLittleEndian(T *, size_t)            { }
+	
 #elif defined(CC7_BIG_ENDIAN)
 	
 	template <typename T> inline T ToBigEndian(T n)      { return n; }
 	template <typename T> inline T ToLittleEndian(T n)   { return detail::SwapEndian(n); }
 	template <typename T> inline T FromBigEndian(T n)    { return n; }
 	template <typename T> inline T FromLittleEndian(T n) { return detail::SwapEndian(n); }
+	
+	template <typename T> inline void ToBigEndian(const T * in, T * out, size_t count)      { detail::CopyArray(in, out, count); }
+	template <typename T> inline void ToLittleEndian(const T * in, T * out, size_t count)   { detail::SwapEndianArray(in, out, count); }
+	template <typename T> inline void FromBigEndian(const T * in, T * out, size_t count)    { detail::CopyArray(in, out, count); }
+	template <typename T> inline void FromLittleEndian(const T * in, T * out, size_t count) { detail::SwapEndianArray(in, out, count); }
+	
+	template <typename T> inline void ToBigEndian(T *, size_t)                 { }
+	template <typename T> inline void ToLittleEndian(T * data, size_t count)   { detail::SwapEndianArray(data, data, count); }
+	template <typename T> inline void FromBigEndian(T *, size_t)               { }
+	template <typename T> inline void FromLittleEndian(T * data, size_t count) { detail::SwapEndianArray(data, data, count); }
 
 #else
 	#error "Wrong ENDIAN setup in cc7/Platform.h"
@@ -27,10 +27,70 @@ namespace cc7
 	bool HexString_Encode(const ByteRange & in_data, bool use_lowercase, std::string & out_string);
 	
 	/**
-	 Converts hexadecimal encoded string into ByteArray. Returns false if the
-	 input string is not a valid hexadecimal string.
+	 Converts hexadecimal encoded string, captured in the byte range, into ByteArray.
+	 Returns false if the input string is not a valid hexadecimal string.
+	 
+	 If the string has an odd number of characters, then the first character
+	 is decoded as a whole byte.
 	 */
-	bool HexString_Decode(const std::string & in_string, ByteArray & out_data);
+	bool HexString_Decode(const ByteRange & in_string, ByteArray & out_data);
+	
+	/**
+	 Converts hexadecimal encoded string into ByteArray. This is just the convenient
+	 function to HexString_Decode() with ByteRange input.
+	 */
+	inline bool HexString_Decode(const std::string & in_string, ByteArray & out_data)
+	{
+		return HexString_Decode(MakeRange(in_string), out_data);
+	}
+	
+	/**
+	 Converts hexadecimal encoded string, captured in |in_string| pointer with |length|
+	 characters, into ByteArray. This is just the convenient function to HexString_Decode()
+	 with ByteRange input.
+	 */
+	inline bool HexString_Decode(const char * in_string, size_t length, ByteArray & out_data)
+	{
+		return HexString_Decode(ByteRange(in_string, length), out_data);
+	}
+	
+	/**
+	 Returns exact length of hexadecimal string, produced for data with |data_size| bytes.
+	 */
+	inline size_t HexString_EncodedLength(size_t data_size)
+	{
+		return data_size << 1;
+	}
+	
+	/**
+	 Returns exact number of bytes decoded from a valid hexadecimal string
+	 with |string_length| characters.
+	 */
+	inline size_t HexString_DecodedLength(size_t string_length)
+	{
+		return (string_length >> 1) + (string_length & 1);
+	}
+	
+	/**
+	 Converts input byte range into hexadecimal upper, or lowercase string, written to
+	 the caller's buffer |out| with |out_capacity| characters. The function doesn't
+	 allocate memory and doesn't append the NUL terminator to the produced string.
+	 
+	 Returns number of characters written to the buffer, or ByteRange::npos if
+	 the buffer is smaller than HexString_EncodedLength().
+	 */
+	size_t HexString_EncodeTo(const ByteRange & in_data, char * out, size_t out_capacity, bool use_lowercase = false);
+	
+	/**
+	 Converts hexadecimal encoded string into bytes, written to the caller's buffer
+	 |out| with |out_capacity| bytes. The function doesn't allocate memory and accepts
+	 the same strings as HexString_Decode().
+	 
+	 Returns number of bytes written to the buffer, or ByteRange::npos if the string
+	 is not a valid hexadecimal string, or if the buffer is smaller than
+	 HexString_DecodedLength(). The content of the buffer is undefined in case of failure.
+	 */
+	size_t HexString_DecodeTo(const ByteRange & in_string, cc7::byte * out, size_t out_capacity);
 	
 	/**
 	 Converts input byte range into hexadecimal upper, or lowercase string. 
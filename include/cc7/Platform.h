@@ -106,8 +106,8 @@
 	#include <string.h>
 	//
 	#define CC7_ANDROID
-	CC7_EXTERN_C void OPENSSL_cleanse(void *ptr, size_t len);
-	#define CC7_SecureClean(ptr, size)  OPENSSL_cleanse(ptr, size)
+	CC7_EXTERN_C void CC7SecureCleanImpl(void * ptr, size_t size);
+	#define CC7_SecureClean(ptr, size)  CC7SecureCleanImpl(ptr, size)
 	// 64 bit
 	#if __SIZEOF_POINTER__ == 8
 		#define CC7_PLATFORM64
@@ -120,6 +120,37 @@
 	// Interface deprecation
 	#define CC7_DEPRECATED(deprecated_in_version) __attribute__((deprecated))
 	//
+#elif defined(__linux__)
+	// -------------------------------------------------------------------
+	// LINUX PLATFORM (e.g. x86_64 or aarch64 servers)
+	// -------------------------------------------------------------------
+	#include <stdlib.h>
+	#include <string.h>
+	//
+	#define CC7_LINUX
+	#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 25))
+		// glibc 2.25+ provides explicit_bzero(), which is never optimized out
+		#define CC7_SecureClean(ptr, size)  explicit_bzero(ptr, size)
+	#else
+		CC7_EXTERN_C void CC7SecureCleanImpl(void * ptr, size_t size);
+		#define CC7_SecureClean(ptr, size)  CC7SecureCleanImpl(ptr, size)
+	#endif
+	// 64 bit
+	#if __SIZEOF_POINTER__ == 8
+		#define CC7_PLATFORM64
+	#else
+		#define CC7_PLATFORM32
+	#endif
+	// Little / Big endian
+	#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+		#define CC7_BIG_ENDIAN
+	#else
+		#define CC7_LITTLE_ENDIAN
+	#endif
+	#define CC7_UNUSED_VAR	__attribute__((unused))
+	// Interface deprecation
+	#define CC7_DEPRECATED(deprecated_in_version) __attribute__((deprecated))
+	//
 #elif defined(WINAPI_FAMILY) && WINAPI_FAMILY == WINAPI_FAMILY_PHONE_APP
 	// -------------------------------------------------------------------
 	// Windows8+ Phone
@@ -230,6 +261,10 @@
 		#define CC7_BREAKPOINT()
 	#endif // CC7_ANDROID
 
+	#ifdef CC7_LINUX
+		#define CC7_BREAKPOINT()
+	#endif // CC7_LINUX
+
 	#ifdef CC7_WINDOWS
 		#define CC7_BREAKPOINT()
 	#endif // CC7_WINDOWS
@@ -266,6 +301,7 @@
 
 #ifdef __cplusplus
 	// C++
+	#include <stddef.h>
 	#include <string>
 	#include <vector>
 
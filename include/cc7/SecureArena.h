@@ -0,0 +1,130 @@
+/*
+ * Copyright 2016 Juraj Durech <durech.juraj@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cc7/SecureMemoryResource.h>
+
+namespace cc7
+{
+	/**
+	 The SecureArena class is a memory arena for short-living sensitive data.
+	 The memory is allocated from larger blocks, so the allocation is just
+	 a pointer bump. The deallocation doesn't return memory to the system and
+	 the freed memory is securely cleaned later, in one batch, when the arena
+	 is reset or destroyed. Only the most recent allocation can be returned
+	 back to the arena, which helps when the ByteArray grows.
+	 
+	 The arena can be used by the ByteArray in two ways:
+	 
+	 1. You can create ByteArray with explicit allocator:
+	 
+	      SecureArena arena;
+	      ByteArray::allocator_type allocator(&arena);
+	      ByteArray data(allocator);
+	 
+	 2. You can use SecureArena::Scope (inherited from SecureMemoryResource),
+	    which installs the arena as a default for all ByteArray objects,
+	    created in the current thread:
+	 
+	      SecureArena arena;
+	      {
+	          SecureArena::Scope scope(arena);
+	          ByteArray data;    // allocated in the arena
+	          ...
+	      }
+	      arena.reset();         // wipes all data in one batch
+	 
+	 In both cases, the ByteArray keeps the pointer to its arena, so the arena
+	 must outlive all arrays allocated in it. The class is not thread safe, so
+	 each thread should use its own arena, for example, one arena per request.
+	 */
+	class SecureArena : public SecureMemoryResource
+	{
+	public:
+		
+		/**
+		 Default size of one memory block.
+		 */
+		static const size_t DefaultBlockSize = 64 * 1024;
+		
+		/**
+		 Constructs a new arena with required |block_size|. The memory
+		 is allocated later, at the first allocation.
+		 */
+		explicit SecureArena(size_t block_size = DefaultBlockSize);
+		
+		/**
+		 Securely cleans and releases all memory blocks.
+		 */
+		~SecureArena();
+		
+		SecureArena(const SecureArena &) = delete;
+		SecureArena & operator=(const SecureArena &) = delete;
+		
+		/**
+		 Allocates |size| bytes in the arena. The returned pointer is aligned
+		 to 16 bytes. Allocations larger than 1/4 of the block size are placed
+		 in dedicated blocks.
+		 */
+		void * allocate(size_t size) override;
+		
+		/**
+		 Returns memory back to the arena. The memory is not cleaned immediately,
+		 but in the next reset(). Only the most recent allocation and allocations
+		 in dedicated blocks are really released.
+		 */
+		void deallocate(void * ptr, size_t size) override;
+		
+		/**
+		 Securely cleans all used memory and makes the arena empty. The regular
+		 memory blocks are kept for the future allocations. All objects allocated
+		 in the arena must be already destroyed.
+		 */
+		void reset();
+		
+		/**
+		 Returns number of bytes allocated from the arena since the last reset.
+		 */
+		size_t usedSize() const;
+		
+		/**
+		 Returns number of bytes reserved in all memory blocks.
+		 */
+		size_t reservedSize() const;
+		
+	private:
+		
+		struct Block
+		{
+			cc7::byte *	data;
+			size_t		size;
+			size_t		used;		// high water mark, for the cleanup
+			bool		dedicated;	// block for one large allocation
+		};
+		
+		size_t				_block_size;
+		std::vector<Block>	_blocks;
+		size_t				_current;	// index of current regular block
+		size_t				_offset;	// offset in the current regular block
+		cc7::byte *			_last;		// the most recent allocation
+		size_t				_used_size;
+		
+		cc7::byte * _allocateDedicated(size_t size);
+		bool _nextBlock();
+	};
+
+} // cc7
@@ -0,0 +1,360 @@
+/*
+ * Copyright 2016 Juraj Durech <durech.juraj@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cc7/ByteArray.h>
+
+namespace cc7
+{
+	//
+	// The SecureBuffer class is a growable byte buffer, optimized for secrets
+	// which are built incrementally, like decrypted streams or decoded keys.
+	//
+	// Each reallocation of a ByteArray copies the content and then wipes the whole
+	// old capacity, so the wipe traffic grows with every intermediate capacity,
+	// even if most of it was never written. The SecureBuffer keeps track of
+	// the bytes which may contain data and wipes only those. Together with
+	// the geometric growth, appending N bytes wipes O(N) bytes in total.
+	//
+	// Large buffers are, where the system supports it, backed by anonymous
+	// memory mappings, which grow and shrink with mremap(). The kernel moves
+	// the pages instead of copying them, so no stale copy of the secret
+	// is left behind and no wipe is needed at all.
+	//
+	// If there's SecureMemoryResource installed at the construction, then
+	// the buffer allocates from that resource and the resource is responsible
+	// for the cleanup of released memory. The memory mappings are not used
+	// in this case. Like in ByteArray, copies use the current resource and
+	// moved buffers keep the resource of the original.
+	//
+	
+	class SecureBuffer
+	{
+	public:
+		
+		typedef cc7::byte			value_type;
+		typedef cc7::byte*			pointer;
+		typedef const cc7::byte*	const_pointer;
+		typedef cc7::byte&			reference;
+		typedef const cc7::byte&	const_reference;
+		typedef size_t				size_type;
+		typedef ptrdiff_t			difference_type;
+		typedef cc7::byte*			iterator;
+		typedef const cc7::byte*	const_iterator;
+		
+		typedef detail::ExceptionsWrapper<value_type>	_ValueTypeExceptions;
+		
+		/**
+		 The smallest capacity allocated by the buffer. It's enough for
+		 the most of the keys, so short secrets are never reallocated.
+		 */
+		static const size_type MinimumCapacity = 32;
+		
+		/**
+		 Buffers with at least this capacity are backed by memory mappings,
+		 on systems supporting mremap().
+		 */
+		static const size_type MappedCapacity = 64 * 1024;
+		
+		// Construction / Destruction
+		
+		/**
+		 Constructs an empty buffer, which uses SecureMemoryResource::current().
+		 */
+		SecureBuffer() noexcept;
+		
+		/**
+		 Constructs an empty buffer, which uses the |resource|. You can pass
+		 nullptr to use the regular heap.
+		 */
+		explicit SecureBuffer(SecureMemoryResource * resource) noexcept;
+		
+		SecureBuffer(const ByteRange & range);
+		SecureBuffer(const SecureBuffer & other);
+		SecureBuffer(SecureBuffer && other) noexcept;
+		
+		~SecureBuffer();
+		
+		SecureBuffer & operator=(const ByteRange & range)
+		{
+			assign(range);
+			return *this;
+		}
+		
+		SecureBuffer & operator=(const SecureBuffer & other)
+		{
+			if (this != &other) {
+				assign(other.byteRange());
+			}
+			return *this;
+		}
+		
+		SecureBuffer & operator=(SecureBuffer && other) noexcept;
+		
+		
+		//
+		// Interaction with ByteRange class
+		//
+		
+		void assign(const ByteRange & range);
+		
+		SecureBuffer & append(const ByteRange & range)
+		{
+			return append(range.data(), range.size());
+		}
+		
+		ByteRange byteRange() const
+		{
+			return ByteRange(_data, _size);
+		}
+		
+		// dirty.. automatic casting to ByteRange
+		operator ByteRange () const
+		{
+			return byteRange();
+		}
+		
+		
+		//
+		// Appending
+		//
+		
+		// single element, the same as push_back()
+		SecureBuffer & append(const value_type & val)
+		{
+			push_back(val);
+			return *this;
+		}
+		
+		// fill
+		SecureBuffer & append(size_type n, const value_type & val)
+		{
+			// The value may reference this buffer, so it must be copied before the growth.
+			const value_type value = val;
+			pointer room = _makeRoom(n);
+			if (room) {
+				memset(room, value, n);
+			}
+			return *this;
+		}
+		
+		// append [pointer, size]
+		SecureBuffer & append(const_pointer p, size_type size);
+		
+		
+		//
+		// std::vector like interface
+		//
+		
+		const_pointer data() const noexcept		{ return _data; }
+		pointer data() noexcept					{ return _data; }
+		size_type size() const noexcept			{ return _size; }
+		size_type capacity() const noexcept		{ return _capacity; }
+		bool empty() const noexcept				{ return _size == 0; }
+		size_type max_size() const noexcept		{ return size_type(-1) / 2; }
+		
+		iterator begin() noexcept				{ return _data; }
+		iterator end() noexcept					{ return _data + _size; }
+		const_iterator begin() const noexcept	{ return _data; }
+		const_iterator end() const noexcept		{ return _data + _size; }
+		const_iterator cbegin() const noexcept	{ return _data; }
+		const_iterator cend() const noexcept	{ return _data + _size; }
+		
+		reference operator[](size_type index) noexcept				{ return _data[index]; }
+		const_reference operator[](size_type index) const noexcept	{ return _data[index]; }
+		
+		reference at(size_type index)
+		{
+			if (index < _size) {
+				return _data[index];
+			}
+			return _ValueTypeExceptions::out_of_range();
+		}
+		
+		const_reference at(size_type index) const
+		{
+			if (index < _size) {
+				return _data[index];
+			}
+			return _ValueTypeExceptions::out_of_range();
+		}
+		
+		reference front()				{ return _data[0]; }
+		const_reference front() const	{ return _data[0]; }
+		reference back()				{ return _data[_size - 1]; }
+		const_reference back() const	{ return _data[_size - 1]; }
+		
+		void push_back(const value_type & val)
+		{
+			// The value may reference this buffer, so it must be copied before the growth.
+			const value_type value = val;
+			if (_size == _capacity) {
+				_grow(_size + 1);
+				if (_size == _capacity) {
+					// The allocation failed and the exceptions are disabled.
+					return;
+				}
+			}
+			_data[_size++] = value;
+			if (_size > _dirty) {
+				_dirty = _size;
+			}
+		}
+		
+		void pop_back() noexcept
+		{
+			if (_size > 0) {
+				_size--;
+			}
+		}
+		
+		/**
+		 Reserves space for at least |new_capacity| bytes. Unlike std::vector,
+		 the capacity follows the geometric growth policy, so calling reserve()
+		 before each append doesn't lead to reallocation on every call.
+		 */
+		void reserve(size_type new_capacity)
+		{
+			if (new_capacity > _capacity) {
+				_grow(new_capacity);
+			}
+		}
+		
+		/**
+		 Reserves space for exactly |new_capacity| bytes. Use this method when
+		 you know the final size of the secret. The mapped buffers are always
+		 rounded up to the page size.
+		 */
+		void reserve_exact(size_type new_capacity)
+		{
+			if (new_capacity > _capacity) {
+				_reallocate(new_capacity);
+			}
+		}
+		
+		void resize(size_type new_size, const value_type & val = value_type())
+		{
+			if (new_size > _size) {
+				append(new_size - _size, val);
+			} else {
+				_size = new_size;
+			}
+		}
+		
+		/**
+		 Sets size to zero. The content is not wiped until the memory is reused
+		 or released. Use secureClear() to wipe the content immediately.
+		 */
+		void clear() noexcept
+		{
+			_size = 0;
+		}
+		
+		/**
+		 Moves content to the storage which fits its size, or shrinks the memory
+		 mapping in place. All released bytes, which contained data, are securely
+		 cleaned. The bytes beyond the size, which may still contain a previous
+		 content, are cleaned too.
+		 */
+		void shrink_to_fit_secure();
+		
+		void swap(SecureBuffer & other) noexcept;
+		
+		
+		//
+		// Other custom methods
+		//
+		
+		/**
+		 Securely cleans the content and sets size to zero. The capacity
+		 is not changed.
+		 */
+		void secureClear() noexcept;
+		
+		/**
+		 Returns true if the buffer is backed by a memory mapping.
+		 */
+		bool isMapped() const noexcept
+		{
+			return _mapped;
+		}
+		
+		/**
+		 Returns resource used by this buffer, or nullptr for the regular heap.
+		 */
+		SecureMemoryResource * resource() const noexcept
+		{
+			return _resource;
+		}
+		
+	private:
+		
+		pointer					_data;
+		size_type				_size;
+		size_type				_capacity;
+		size_type				_dirty;		// number of bytes which may contain data
+		SecureMemoryResource *	_resource;
+		bool					_mapped;
+		
+		/*
+		 Returns true if the pointer points to the content of this buffer.
+		 */
+		bool _isOwnMemory(const_pointer p) const noexcept
+		{
+			return p != nullptr && p >= _data && p < _data + _size;
+		}
+		
+		void _moveFrom(SecureBuffer & other) noexcept;
+		void _releaseStorage() noexcept;
+		void _reallocate(size_type new_capacity);
+		void _replaceStorage(pointer new_data, size_type new_capacity, bool mapped) noexcept;
+		void _grow(size_type required_capacity);
+		
+		/*
+		 Appends |count| uninitialized bytes and returns pointer to the first one.
+		 Returns nullptr if the storage cannot grow and the exceptions are disabled.
+		 */
+		pointer _makeRoom(size_type count)
+		{
+			if (count > _capacity - _size) {
+				if (count > max_size() - _size) {
+					_ValueTypeExceptions::length_error();
+					return nullptr;
+				}
+				_grow(_size + count);
+				if (count > _capacity - _size) {
+					return nullptr;
+				}
+			}
+			pointer room = _data + _size;
+			_size += count;
+			if (_size > _dirty) {
+				_dirty = _size;
+			}
+			return room;
+		}
+	};
+	
+	/**
+	 Creates a new ByteRange object from given SecureBuffer.
+	 */
+	inline ByteRange MakeRange(const SecureBuffer & buffer)
+	{
+		return buffer.byteRange();
+	}
+
+} // cc7
@@ -0,0 +1,130 @@
+/*
+ * Copyright 2016 Juraj Durech <durech.juraj@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cc7/SecureMemoryResource.h>
+#include <mutex>
+
+namespace cc7
+{
+	/**
+	 The SecureHeap class is a memory resource which keeps sensitive data out
+	 of the swap and, where the system supports it, out of the core dumps.
+	 The heap reserves one memory region at the construction, locks it in
+	 the physical memory and surrounds it with inaccessible guard pages. All
+	 later allocations are served from this region, with no system calls.
+	 
+	 The region is managed by a buddy allocator with per-size free lists,
+	 so the allocation and deallocation costs O(log n). The memory is securely
+	 cleaned at deallocation. If the region is exhausted, then the heap falls
+	 back to the regular heap and counts such allocations in the statistics.
+	 
+	 Typical usage is one heap for the whole process:
+	 
+	      static SecureHeap heap(256 * 1024);
+	      SecureMemoryResource::setDefault(&heap);
+	 
+	 The class is thread safe.
+	 */
+	class SecureHeap : public SecureMemoryResource
+	{
+	public:
+		
+		/**
+		 Default size of the locked region. Note that many systems limit
+		 the amount of locked memory per process to 64KB by default.
+		 */
+		static const size_t DefaultHeapSize = 64 * 1024;
+		
+		/**
+		 The Statistics structure contains usage statistics of the heap.
+		 */
+		struct Statistics
+		{
+			/// Size of the reserved region, in bytes. The value is 0 if the region
+			/// could not be reserved and all allocations fall back to the regular heap.
+			size_t	heap_size;
+			/// Bytes currently allocated in the region, including the rounding
+			size_t	used_size;
+			/// The highest value of used_size
+			size_t	peak_used_size;
+			/// Number of live allocations in the region
+			size_t	allocations_count;
+			/// Number of live allocations served by the regular heap
+			size_t	fallback_allocations_count;
+			/// Number of all allocations since the heap was created
+			size_t	total_allocations_count;
+			/// Number of all fallback allocations since the heap was created
+			size_t	total_fallback_allocations_count;
+			/// True if the region is locked in the physical memory
+			bool	is_locked;
+			/// True if the region is excluded from the core dumps
+			bool	is_excluded_from_dump;
+		};
+		
+		/**
+		 Constructs a new heap with |heap_size| bytes, rounded up to the page size.
+		 If |exclude_from_dump| is true, then the heap also asks the system to
+		 exclude the region from the core dumps.
+		 */
+		explicit SecureHeap(size_t heap_size = DefaultHeapSize, bool exclude_from_dump = true);
+		
+		/**
+		 Securely cleans and releases the region. All objects allocated in
+		 the heap must be already destroyed.
+		 */
+		~SecureHeap();
+		
+		SecureHeap(const SecureHeap &) = delete;
+		SecureHeap & operator=(const SecureHeap &) = delete;
+		
+		/**
+		 Allocates |size| bytes. The returned pointer is aligned to 16 bytes.
+		 */
+		void * allocate(size_t size) override;
+		
+		/**
+		 Securely cleans and releases memory allocated with allocate().
+		 */
+		void deallocate(void * ptr, size_t size) override;
+		
+		/**
+		 Returns true if |ptr| points to the heap's region.
+		 */
+		bool contains(const void * ptr) const;
+		
+		/**
+		 Returns current usage statistics.
+		 */
+		Statistics statistics() const;
+	
+	private:
+		
+		cc7::byte *			_region;
+		size_t				_region_size;
+		size_t				_page_size;
+		size_t				_max_order;
+		std::vector<size_t>	_free_lists;	// offset of the first free block, per order
+		std::vector<byte>	_free_orders;	// order + 1 of a free block starting at the min. block, or 0
+		Statistics			_stats;
+		mutable std::mutex	_mutex;
+		
+		void _pushFree(size_t offset, size_t order);
+		void _removeFree(size_t offset, size_t order);
+	};
+
+} // cc7
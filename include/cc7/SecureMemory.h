@@ -0,0 +1,48 @@
+/*
+ * Copyright 2016 Juraj Durech <durech.juraj@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cc7/ByteRange.h>
+
+namespace cc7
+{
+	/**
+	 Compares two byte ranges in constant time. Returns true if both ranges
+	 have equal length and content. The time spent in the function depends
+	 only on the length of ranges, not on their content, so you should use
+	 this function to verify MACs, tokens and other secrets, instead of
+	 the ByteRange's comparison operators.
+	 
+	 Note that the length of ranges is not considered as a secret, so the
+	 function returns immediately if the lengths are different.
+	 */
+	bool SecureCompare(const ByteRange & a, const ByteRange & b);
+	
+	/**
+	 Compares |size| bytes at |a| and |b| in constant time. Returns true if
+	 both memory blocks are equal.
+	 */
+	bool SecureCompare(const void * a, const void * b, size_t size);
+	
+	/**
+	 Securely cleans |size| bytes at |ptr|. Unlike the regular memset(), the call
+	 cannot be removed by the compiler's optimizer. The CC7_SecureClean() macro
+	 uses this function on platforms with no suitable system function.
+	 */
+	void SecureClean(void * ptr, size_t size);
+
+} // cc7
@@ -0,0 +1,84 @@
+/*
+ * Copyright 2016 Juraj Durech <durech.juraj@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cc7/Platform.h>
+
+namespace cc7
+{
+	/**
+	 The SecureMemoryResource is an abstract source of memory for ByteArray
+	 objects. The resource is responsible for secure cleanup of the memory
+	 returned by deallocate(), but it may postpone the cleanup, like
+	 the SecureArena does.
+	 
+	 By default, ByteArray uses the regular heap and cleans the memory
+	 before each deallocation. You can change this for ByteArray objects,
+	 created later in the current thread, with SecureMemoryResource::Scope,
+	 or for the whole process with setDefault().
+	 */
+	class SecureMemoryResource
+	{
+	public:
+		
+		virtual ~SecureMemoryResource();
+		
+		/**
+		 Allocates |size| bytes. Returns nullptr if the memory cannot be allocated.
+		 */
+		virtual void * allocate(size_t size) = 0;
+		
+		/**
+		 Returns memory allocated with allocate() back to the resource.
+		 The |size| must be equal to the requested size.
+		 */
+		virtual void deallocate(void * ptr, size_t size) = 0;
+		
+		/**
+		 Returns resource installed for the current thread by Scope, or the default
+		 resource set by setDefault(). Returns nullptr if there's no such resource
+		 and the regular heap should be used.
+		 */
+		static SecureMemoryResource * current();
+		
+		/**
+		 Sets the default resource for all threads. You can pass nullptr to switch
+		 back to the regular heap. The resource must outlive all objects allocated
+		 with it, so typically, the default resource lives until the process ends.
+		 */
+		static void setDefault(SecureMemoryResource * resource);
+		
+		/**
+		 The Scope class installs the resource as a default resource for all
+		 ByteArray objects created in the current thread, for the lifetime of
+		 the scope. Scopes can be nested.
+		 */
+		class Scope
+		{
+		public:
+			explicit Scope(SecureMemoryResource & resource);
+			~Scope();
+			
+			Scope(const Scope &) = delete;
+			Scope & operator=(const Scope &) = delete;
+		
+		private:
+			SecureMemoryResource * _previous;
+		};
+	};
+
+} // cc7
@@ -0,0 +1,648 @@
+/*
+ * Copyright 2016 Juraj Durech <durech.juraj@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cc7/ByteArray.h>
+#include <cc7/Base64.h>
+#include <cc7/HexString.h>
+
+namespace cc7
+{
+	//
+	// The SmallByteArray class is a variant of ByteArray, with inline storage
+	// for N bytes. The array doesn't allocate memory until its size exceeds
+	// the inline capacity, so it's ideal for short secrets, like keys, nonces
+	// or MACs.
+	//
+	// Like the ByteArray, the class implements secure data cleanup. Both inline
+	// and heap storages are wiped when the object is destroyed, and also
+	// when the content is moved to a larger storage.
+	//
+	// The class has the same interface for interaction with ByteRange and
+	// for appending, like ByteArray has, and also implements the most used
+	// subset of std::vector interface.
+	//
+	
+	template <size_t N>
+	class SmallByteArray
+	{
+	public:
+		
+		static_assert(N > 0, "Inline capacity must be greater than 0");
+		
+		typedef cc7::byte			value_type;
+		typedef cc7::byte*			pointer;
+		typedef const cc7::byte*	const_pointer;
+		typedef cc7::byte&			reference;
+		typedef const cc7::byte&	const_reference;
+		typedef size_t				size_type;
+		typedef ptrdiff_t			difference_type;
+		typedef cc7::byte*			iterator;
+		typedef const cc7::byte*	const_iterator;
+		typedef std::reverse_iterator<const_iterator>	const_reverse_iterator;
+		typedef std::reverse_iterator<iterator>			reverse_iterator;
+		
+		typedef detail::CleanupAllocator<cc7::byte>		allocator_type;
+		typedef detail::ExceptionsWrapper<value_type>	_ValueTypeExceptions;
+		
+		/**
+		 Number of bytes stored in the object, without the heap allocation.
+		 */
+		static const size_type InlineCapacity = N;
+		
+		// Construction / Destruction
+		
+		SmallByteArray() noexcept :
+			_data(_inline),
+			_size(0),
+			_capacity(N)
+		{
+		}
+		
+		explicit SmallByteArray(size_type n, const value_type & val = value_type()) :
+			SmallByteArray()
+		{
+			append(n, val);
+		}
+		
+		template <class InputIterator, class = typename std::enable_if<!std::is_integral<InputIterator>::value>::type>
+		SmallByteArray(InputIterator first, InputIterator last) :
+			SmallByteArray()
+		{
+			append(first, last);
+		}
+		
+		SmallByteArray(std::initializer_list<value_type> il) :
+			SmallByteArray()
+		{
+			append(il);
+		}
+		
+		SmallByteArray(const SmallByteArray & other) :
+			SmallByteArray()
+		{
+			append(other.data(), other.size());
+		}
+		
+		SmallByteArray(SmallByteArray && other) noexcept :
+			SmallByteArray()
+		{
+			_moveFrom(other);
+		}
+		
+		~SmallByteArray()
+		{
+			_releaseStorage();
+			CC7_SecureClean(_inline, N);
+		}
+		
+		
+		//
+		// Interaction with ByteRange class
+		//
+		SmallByteArray(const ByteRange & range) :
+			SmallByteArray()
+		{
+			append(range);
+		}
+		
+		SmallByteArray & operator=(const ByteRange & range)
+		{
+			assign(range);
+			return *this;
+		}
+		
+		SmallByteArray & operator=(const SmallByteArray & other)
+		{
+			if (this != &other) {
+				assign(other.byteRange());
+			}
+			return *this;
+		}
+		
+		SmallByteArray & operator=(SmallByteArray && other) noexcept
+		{
+			if (this != &other) {
+				_releaseStorage();
+				_moveFrom(other);
+			}
+			return *this;
+		}
+		
+		SmallByteArray & operator=(std::initializer_list<value_type> il)
+		{
+			assign(il);
+			return *this;
+		}
+		
+		void assign(const ByteRange & range)
+		{
+			if (_isOwnMemory(range.data())) {
+				// The range is captured from this array.
+				SmallByteArray copy(range);
+				swap(copy);
+				return;
+			}
+			_size = 0;
+			append(range);
+		}
+		
+		void assign(size_type n, const value_type & val)
+		{
+			_size = 0;
+			append(n, val);
+		}
+		
+		template <class InputIterator, class = typename std::enable_if<!std::is_integral<InputIterator>::value>::type>
+		void assign(InputIterator first, InputIterator last)
+		{
+			SmallByteArray copy(first, last);
+			swap(copy);
+		}
+		
+		void assign(std::initializer_list<value_type> il)
+		{
+			_size = 0;
+			append(il);
+		}
+		
+		SmallByteArray & append(const ByteRange & range)
+		{
+			_insert(_size, range.data(), range.size());
+			return *this;
+		}
+		
+		iterator insert(const_iterator position, const ByteRange & range)
+		{
+			return _insert(position - begin(), range.data(), range.size());
+		}
+		
+		ByteRange byteRange() const
+		{
+			return ByteRange(data(), size());
+		}
+		
+		// dirty.. automatic casting to ByteRange
+		operator ByteRange () const
+		{
+			return byteRange();
+		}
+		
+		
+		//
+		// Appending
+		//
+		
+		// single element, the same as push_back()
+		SmallByteArray & append(const value_type & val)
+		{
+			push_back(val);
+			return *this;
+		}
+		
+		// fill
+		SmallByteArray & append(size_type n, const value_type & val)
+		{
+			insert(end(), n, val);
+			return *this;
+		}
+		
+		// range
+		template <class InputIterator, class = typename std::enable_if<!std::is_integral<InputIterator>::value>::type>
+		SmallByteArray & append(InputIterator first, InputIterator last)
+		{
+			insert(end(), first, last);
+			return *this;
+		}
+		
+		// initializer list
+		SmallByteArray & append(std::initializer_list<value_type> il)
+		{
+			_insert(_size, il.begin(), il.size());
+			return *this;
+		}
+		
+		// append [pointer, size]
+		SmallByteArray & append(const_pointer p, size_type size)
+		{
+			_insert(_size, p, size);
+			return *this;
+		}
+		
+		
+		//
+		// std::vector like interface
+		//
+		
+		const_pointer data() const noexcept		{ return _data; }
+		pointer data() noexcept					{ return _data; }
+		size_type size() const noexcept			{ return _size; }
+		size_type capacity() const noexcept		{ return _capacity; }
+		bool empty() const noexcept				{ return _size == 0; }
+		size_type max_size() const noexcept		{ return size_type(-1) / 2; }
+		
+		/**
+		 Returns true if the content is stored in the inline storage.
+		 */
+		bool isInline() const noexcept			{ return _data == _inline; }
+		
+		iterator begin() noexcept				{ return _data; }
+		iterator end() noexcept					{ return _data + _size; }
+		const_iterator begin() const noexcept	{ return _data; }
+		const_iterator end() const noexcept		{ return _data + _size; }
+		const_iterator cbegin() const noexcept	{ return _data; }
+		const_iterator cend() const noexcept	{ return _data + _size; }
+		reverse_iterator rbegin() noexcept				{ return reverse_iterator(end()); }
+		reverse_iterator rend() noexcept				{ return reverse_iterator(begin()); }
+		const_reverse_iterator rbegin() const noexcept	{ return const_reverse_iterator(end()); }
+		const_reverse_iterator rend() const noexcept	{ return const_reverse_iterator(begin()); }
+		
+		reference operator[](size_type index) noexcept				{ return _data[index]; }
+		const_reference operator[](size_type index) const noexcept	{ return _data[index]; }
+		
+		reference at(size_type index)
+		{
+			if (index < _size) {
+				return _data[index];
+			}
+			return _ValueTypeExceptions::out_of_range();
+		}
+		
+		const_reference at(size_type index) const
+		{
+			if (index < _size) {
+				return _data[index];
+			}
+			return _ValueTypeExceptions::out_of_range();
+		}
+		
+		reference front()				{ return _data[0]; }
+		const_reference front() const	{ return _data[0]; }
+		reference back()				{ return _data[_size - 1]; }
+		const_reference back() const	{ return _data[_size - 1]; }
+		
+		void push_back(const value_type & val)
+		{
+			// The value may reference this array, so it must be copied before the growth.
+			const value_type value = val;
+			if (_size == _capacity) {
+				_grow(_size + 1);
+			}
+			_data[_size++] = value;
+		}
+		
+		void pop_back()
+		{
+			if (_size > 0) {
+				_size--;
+			}
+		}
+		
+		void reserve(size_type new_capacity)
+		{
+			if (new_capacity > _capacity) {
+				_reallocate(new_capacity);
+			}
+		}
+		
+		void resize(size_type new_size, const value_type & val = value_type())
+		{
+			if (new_size > _size) {
+				append(new_size - _size, val);
+			} else {
+				_size = new_size;
+			}
+		}
+		
+		void clear() noexcept
+		{
+			_size = 0;
+		}
+		
+		/**
+		 Moves the content back to the inline storage, if possible, or
+		 to a smaller heap storage. The released memory is securely cleaned.
+		 */
+		void shrink_to_fit()
+		{
+			if (_capacity > N && _size < _capacity) {
+				_reallocate(_size);
+			}
+		}
+		
+		iterator insert(const_iterator position, const value_type & val)
+		{
+			return _insert(position - begin(), &val, 1);
+		}
+		
+		iterator insert(const_iterator position, size_type n, const value_type & val)
+		{
+			// The value may reference this array, so it must be copied before the gap is made.
+			const value_type value = val;
+			size_type index = position - begin();
+			memset(_makeGap(index, n), value, n);
+			return begin() + index;
+		}
+		
+		template <class InputIterator, class = typename std::enable_if<!std::is_integral<InputIterator>::value>::type>
+		iterator insert(const_iterator position, InputIterator first, InputIterator last)
+		{
+			return _insertRange(position - begin(), first, last, _InsertTag<InputIterator>());
+		}
+		
+		iterator insert(const_iterator position, std::initializer_list<value_type> il)
+		{
+			return _insert(position - begin(), il.begin(), il.size());
+		}
+		
+		iterator erase(const_iterator position)
+		{
+			return erase(position, position + 1);
+		}
+		
+		iterator erase(const_iterator first, const_iterator last)
+		{
+			size_type index = first - begin();
+			size_type count = last - first;
+			if (count > 0) {
+				memmove(_data + index, _data + index + count, _size - index - count);
+				_size -= count;
+			}
+			return begin() + index;
+		}
+		
+		void swap(SmallByteArray & other) noexcept
+		{
+			if (!isInline() && !other.isInline()) {
+				std::swap(_data, other._data);
+				std::swap(_size, other._size);
+				std::swap(_capacity, other._capacity);
+				return;
+			}
+			SmallByteArray tmp(std::move(other));
+			other = std::move(*this);
+			*this = std::move(tmp);
+		}
+		
+		
+		//
+		// Other custom methods
+		//
+		
+		void secureClear()
+		{
+			CC7_SecureClean(_data, _capacity);
+			_size = 0;
+		}
+		
+		bool readFromBase64String(const ByteRange & base64_string, size_t wrap_size = 0)
+		{
+			if (_isOwnMemory(base64_string.data())) {
+				SmallByteArray copy;
+				bool result = copy.readFromBase64String(base64_string, wrap_size);
+				swap(copy);
+				return result;
+			}
+			resize(Base64_DecodedMaxLength(base64_string.size()));
+			size_t produced = Base64_DecodeTo(base64_string, wrap_size, _data, _size);
+			_size = produced != ByteRange::npos ? produced : 0;
+			return produced != ByteRange::npos;
+		}
+		
+		bool readFromBase64String(const std::string & base64_string, size_t wrap_size = 0)
+		{
+			return readFromBase64String(MakeRange(base64_string), wrap_size);
+		}
+		
+		bool readFromHexString(const ByteRange & hex_string)
+		{
+			if (_isOwnMemory(hex_string.data())) {
+				SmallByteArray copy;
+				bool result = copy.readFromHexString(hex_string);
+				swap(copy);
+				return result;
+			}
+			resize(HexString_DecodedLength(hex_string.size()));
+			size_t produced = HexString_DecodeTo(hex_string, _data, _size);
+			_size = produced != ByteRange::npos ? produced : 0;
+			return produced != ByteRange::npos;
+		}
+		
+		bool readFromHexString(const std::string & hex_string)
+		{
+			return readFromHexString(MakeRange(hex_string));
+		}
+		
+		std::string base64String(size_t wrap_size = 0) const
+		{
+			return ToBase64String(byteRange(), wrap_size);
+		}
+		
+		std::string hexString(bool lower_case = false) const
+		{
+			return ToHexString(byteRange(), lower_case);
+		}
+	
+	private:
+		
+		pointer		_data;
+		size_type	_size;
+		size_type	_capacity;
+		cc7::byte	_inline[N];
+		
+		/*
+		 Returns true if the pointer points to the storage of this array.
+		 */
+		bool _isOwnMemory(const_pointer p) const noexcept
+		{
+			return p != nullptr && p >= _data && p < _data + _capacity;
+		}
+		
+		/*
+		 Moves the content of |other| array to this array. The storage of this array
+		 must be already released.
+		 */
+		void _moveFrom(SmallByteArray & other) noexcept
+		{
+			if (other.isInline()) {
+				memcpy(_inline, other._inline, other._size);
+				_data = _inline;
+				_size = other._size;
+				_capacity = N;
+				CC7_SecureClean(other._inline, other._size);
+			} else {
+				_data = other._data;
+				_size = other._size;
+				_capacity = other._capacity;
+				other._data = other._inline;
+				other._capacity = N;
+			}
+			other._size = 0;
+		}
+		
+		/*
+		 Releases the heap storage, if allocated, and switches back to the inline storage.
+		 */
+		void _releaseStorage() noexcept
+		{
+			if (!isInline()) {
+				// CleanupAllocator without arena securely cleans the memory before deallocation.
+				allocator_type(nullptr).deallocate(_data, _capacity);
+				_data = _inline;
+				_capacity = N;
+			}
+			_size = 0;
+		}
+		
+		/*
+		 Moves content to the storage with exactly |new_capacity| bytes. If the capacity
+		 is lower or equal than N, then the inline storage is used.
+		 */
+		void _reallocate(size_type new_capacity)
+		{
+			if (new_capacity <= N) {
+				if (!isInline()) {
+					memcpy(_inline, _data, _size);
+					size_type size = _size;
+					_releaseStorage();
+					_size = size;
+				}
+				return;
+			}
+			if (new_capacity > max_size()) {
+				_ValueTypeExceptions::length_error();
+				return;
+			}
+			pointer new_data = allocator_type(nullptr).allocate(new_capacity);
+			memcpy(new_data, _data, _size);
+			if (isInline()) {
+				CC7_SecureClean(_inline, _size);
+			} else {
+				allocator_type(nullptr).deallocate(_data, _capacity);
+			}
+			_data = new_data;
+			_capacity = new_capacity;
+		}
+		
+		/*
+		 Grows the storage, so that it can hold at least |required_capacity| bytes.
+		 */
+		void _grow(size_type required_capacity)
+		{
+			size_type new_capacity = _capacity * 2;
+			if (new_capacity < required_capacity) {
+				new_capacity = required_capacity;
+			}
+			_reallocate(new_capacity);
+		}
+		
+		/*
+		 Makes uninitialized gap with |count| bytes at |index| and returns pointer to the gap.
+		 */
+		pointer _makeGap(size_type index, size_type count)
+		{
+			if (count > _capacity - _size) {
+				_grow(_size + count);
+			}
+			pointer gap = _data + index;
+			memmove(gap + count, gap, _size - index);
+			_size += count;
+			return gap;
+		}
+		
+		/*
+		 Inserts |count| bytes from |p| at |index|. The source may point to this array.
+		 */
+		iterator _insert(size_type index, const_pointer p, size_type count)
+		{
+			if (count > 0) {
+				if (_isOwnMemory(p)) {
+					// Make a copy of source bytes, before the storage is changed.
+					SmallByteArray copy(p, p + count);
+					return _insert(index, copy.data(), count);
+				}
+				memcpy(_makeGap(index, count), p, count);
+			}
+			return begin() + index;
+		}
+		
+		/*
+		 Tag for pointers to 1 byte integral types, which can be inserted with memcpy().
+		 */
+		struct _BytePointerTag {};
+		
+		template <class InputIterator>
+		using _InsertTag = typename std::conditional<
+			std::is_pointer<InputIterator>::value &&
+			std::is_integral<typename std::iterator_traits<InputIterator>::value_type>::value &&
+			sizeof(typename std::iterator_traits<InputIterator>::value_type) == 1,
+			_BytePointerTag,
+			typename std::iterator_traits<InputIterator>::iterator_category>::type;
+		
+		template <class InputIterator>
+		iterator _insertRange(size_type index, InputIterator first, InputIterator last, _BytePointerTag)
+		{
+			return _insert(index, reinterpret_cast<const_pointer>(first), last - first);
+		}
+		
+		template <class ForwardIterator>
+		iterator _insertRange(size_type index, ForwardIterator first, ForwardIterator last, std::forward_iterator_tag)
+		{
+			// Elements are converted one by one, like in the std::vector.
+			size_type count = std::distance(first, last);
+			std::copy(first, last, _makeGap(index, count));
+			return begin() + index;
+		}
+		
+		template <class InputIterator>
+		iterator _insertRange(size_type index, InputIterator first, InputIterator last, std::input_iterator_tag)
+		{
+			// The single pass iterator can be consumed only once, so the number
+			// of elements is not known in advance.
+			if (index == _size) {
+				for (; first != last; ++first) {
+					push_back(*first);
+				}
+				return begin() + index;
+			}
+			SmallByteArray copy;
+			for (; first != last; ++first) {
+				copy.push_back(*first);
+			}
+			return _insert(index, copy.data(), copy.size());
+		}
+	};
+	
+	/**
+	 Copy conversion, from SmallByteArray to std::string
+	 */
+	template <size_t N>
+	std::string CopyToString(const SmallByteArray<N> & array)
+	{
+		return std::string(reinterpret_cast<const char*>(array.data()), array.size());
+	}
+	
+	/**
+	 Creates a new ByteRange object from given SmallByteArray.
+	 */
+	template <size_t N>
+	ByteRange MakeRange(const SmallByteArray<N> & array)
+	{
+		return array.byteRange();
+	}
+
+} // cc7
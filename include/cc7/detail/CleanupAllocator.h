@@ -16,7 +16,8 @@
 
 #pragma once
 
-#include <cc7/Platform.h>
+#include <cc7/SecureMemoryResource.h>
+#include <cc7/detail/ExceptionsWrapper.h>
 
 namespace cc7
 {
@@ -25,6 +26,12 @@ namespace detail
 	/**
 	 The CleanupAllocator is a special std::allocator, which only purpose
 	 is to secure clean the allocated memory, before the deallocation.
+	 
+	 The allocator can optionally use SecureMemoryResource (e.g. SecureArena
+	 or SecureHeap) for the allocations. In this case, the resource is
+	 responsible for the cleanup. The default constructed allocator uses
+	 SecureMemoryResource::current(), or the regular heap, if there's no
+	 such resource.
 	 */
 	template <class T> class CleanupAllocator : public std::allocator<T>
 	{
@@ -35,24 +42,91 @@ namespace detail
 			typedef CleanupAllocator <U> other;
 		};
 		
-		CleanupAllocator() throw()
+		// Allocators with different resources are not equal, so the resource
+		// must follow the content when the container is moved or swapped.
+		typedef std::false_type is_always_equal;
+		typedef std::true_type  propagate_on_container_move_assignment;
+		typedef std::true_type  propagate_on_container_swap;
+		
+		CleanupAllocator() throw() :
+			_resource(SecureMemoryResource::current())
+		{
+		}
+		
+		explicit CleanupAllocator(SecureMemoryResource * resource) throw() :
+			_resource(resource)
+		{
+		}
+		
+		CleanupAllocator(const CleanupAllocator & other) throw() :
+			_resource(other.resource())
+		{
+		}
+		
+		template <class U> CleanupAllocator(const CleanupAllocator <U> & other) throw() :
+			_resource(other.resource())
 		{
 		}
 		
-		CleanupAllocator(const CleanupAllocator &) throw()
+		/**
+		 Returns allocator for a copy of the container. The copy doesn't inherit
+		 the resource from the original, because the original may live in a short
+		 lived arena, so it uses SecureMemoryResource::current(), like a newly
+		 constructed container.
+		 */
+		CleanupAllocator select_on_container_copy_construction() const
 		{
+			return CleanupAllocator();
 		}
 		
-		template <class U> CleanupAllocator(const CleanupAllocator <U> &) throw()
+		T * allocate(size_t n, const void * = nullptr)
 		{
+			if (_resource) {
+				void * p = _resource->allocate(n * sizeof(T));
+				if (!p) {
+					ExceptionsWrapper<T>::allocation_error();
+					return nullptr;
+				}
+				return static_cast<T*>(p);
+			}
+			return std::allocator <T>::allocate(n);
 		}
 		
 		void deallocate(T * p,  size_t n)
 		{
+			if (_resource) {
+				// The resource is responsible for the cleanup.
+				_resource->deallocate(p, n * sizeof(T));
+				return;
+			}
 			CC7_SecureClean(p, n * sizeof(T));
 			std::allocator <T>::deallocate(p, n);
 		}
+		
+		/**
+		 Returns resource used by this allocator, or nullptr for the regular heap.
+		 */
+		SecureMemoryResource * resource() const
+		{
+			return _resource;
+		}
+		
+	private:
+		
+		SecureMemoryResource * _resource;
 	};
 	
+	template <class T, class U>
+	inline bool operator==(const CleanupAllocator<T> & a, const CleanupAllocator<U> & b)
+	{
+		return a.resource() == b.resource();
+	}
+	
+	template <class T, class U>
+	inline bool operator!=(const CleanupAllocator<T> & a, const CleanupAllocator<U> & b)
+	{
+		return a.resource() != b.resource();
+	}
+	
 } // cc7::detail
 } // cc7
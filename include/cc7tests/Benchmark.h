@@ -0,0 +1,166 @@
+/*
+ * Copyright 2016 Juraj Durech <durech.juraj@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cc7tests/PerformanceTimer.h>
+#include <vector>
+
+namespace cc7
+{
+namespace tests
+{
+	/**
+	 The BenchmarkResult structure contains statistics collected for one
+	 benchmarked operation. All times are in milliseconds and are normalized
+	 to one execution of the measured block.
+	 */
+	struct BenchmarkResult
+	{
+		/**
+		 Name of the benchmark, for example "base64.encode.wrap64"
+		 */
+		std::string name;
+		/**
+		 Number of bytes processed in one execution of the block.
+		 */
+		size_t data_size;
+		/**
+		 Number of collected samples.
+		 */
+		size_t samples;
+		/**
+		 Number of block executions in one sample.
+		 */
+		size_t iterations;
+		/**
+		 Median time of one execution.
+		 */
+		double p50;
+		/**
+		 99th percentile of time of one execution.
+		 */
+		double p99;
+		/**
+		 Throughput in MB/s (10^6 bytes per second), calculated from the median.
+		 */
+		double throughput;
+		
+		/**
+		 Returns human readable, one line summary of the result.
+		 */
+		std::string toString() const;
+		
+		/**
+		 Returns the result as a JSON object on one line.
+		 */
+		std::string toJSON() const;
+	};
+	
+	/**
+	 The Benchmark class measures performance of the code blocks. Each benchmarked
+	 block is executed several times to warm up caches, and then the samples are
+	 collected. If one execution of the block is too short for the timer's resolution,
+	 then the block is executed multiple times in one sample.
+	 
+	 All results are collected in the object and can be exported in the machine
+	 readable format, which allows comparison between releases.
+	 */
+	class Benchmark
+	{
+	public:
+		
+		/**
+		 The Config structure contains parameters for the measurement.
+		 */
+		struct Config
+		{
+			Config() :
+				warmup_runs(2),
+				min_samples(10),
+				max_samples(200),
+				min_sample_time(0.5),
+				max_total_time(500.0)
+			{
+			}
+			
+			/**
+			 Number of block executions before the measurement.
+			 */
+			size_t warmup_runs;
+			/**
+			 Minimum number of collected samples.
+			 */
+			size_t min_samples;
+			/**
+			 Maximum number of collected samples.
+			 */
+			size_t max_samples;
+			/**
+			 Minimum time of one sample, in milliseconds.
+			 */
+			double min_sample_time;
+			/**
+			 Time limit for collecting samples over the minimum number, in milliseconds.
+			 */
+			double max_total_time;
+		};
+		
+		/**
+		 Constructs a new benchmark with the default configuration.
+		 */
+		Benchmark();
+		
+		/**
+		 Constructs a new benchmark with the custom configuration.
+		 */
+		Benchmark(const Config & config);
+		
+		/**
+		 Returns current configuration.
+		 */
+		const Config & config() const;
+		
+		/**
+		 Measures the |block|, which processes |data_size| bytes in one execution.
+		 The result is stored to the list of results and returned.
+		 */
+		const BenchmarkResult & run(const std::string & name, size_t data_size, std::function<void()> block);
+		
+		/**
+		 Returns all results collected by this object.
+		 */
+		const std::vector<BenchmarkResult> & results() const;
+		
+		/**
+		 Returns all results in JSON Lines format, one JSON object per line.
+		 */
+		std::string reportJSON() const;
+		
+		/**
+		 Writes all results in JSON Lines format to the file at |path|.
+		 Returns false if the file cannot be written.
+		 */
+		bool writeReport(const std::string & path) const;
+	
+	private:
+		
+		Config _config;
+		std::vector<BenchmarkResult> _results;
+	};
+
+} // cc7::tests
+} // cc7
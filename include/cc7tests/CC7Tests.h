@@ -21,4 +21,5 @@
 #include <cc7tests/TestRegistrationMacros.h>
 #include <cc7tests/TestDirectory.h>
 #include <cc7tests/TestUtils.h>
-#include <cc7tests/JSONReader.h>
\ No newline at end of file
+#include <cc7tests/JSONReader.h>
+#include <cc7tests/Benchmark.h>
\ No newline at end of file
@@ -54,6 +54,12 @@ namespace tests
 		 */
 		static TestManager * createDefaultManager();
 		
+		/**
+		 Creates a new TestManager instance with all embedded benchmarks. The benchmarks
+		 are not part of the default list of tests, because they take a long time.
+		 */
+		static TestManager * createBenchmarkManager();
+		
 		/**
 		 Creates a new empty TestManager instance with no tests added.
 		 */
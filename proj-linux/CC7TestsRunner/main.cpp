@@ -0,0 +1,43 @@
+/*
+ * Copyright 2016 Juraj Durech <durech.juraj@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cc7tests/CC7Tests.h>
+#include <stdio.h>
+#include <string.h>
+
+using namespace cc7;
+
+/*
+ Runs all embedded tests, or benchmarks when the first argument is "bench".
+ Returns 0 if all tests passed.
+ */
+int main(int argc, char * argv[])
+{
+	bool benchmarks = argc > 1 && strcmp(argv[1], "bench") == 0;
+	tests::TestManager * manager = benchmarks
+									? tests::TestManager::createBenchmarkManager()
+									: tests::TestManager::createDefaultManager();
+	bool result = manager->runAllTests();
+	
+	tests::TestLogData log_data = manager->tl().logData();
+	tests::TestManager::releaseManager(manager);
+	
+	if (!result) {
+		fprintf(stderr, "Incidents:\n%s\n", log_data.incidents.c_str());
+	}
+	printf("Full test log:\n%s\n", log_data.log.c_str());
+	return result ? 0 : 1;
+}
@@ -46,4 +46,25 @@ using namespace cc7;
 	XCTAssertTrue(result, @"Test failed. Check debug log for details.");
 }
 
+- (void)testRunCC7Benchmarks
+{
+	// Benchmarks take a long time, so they're executed only on demand.
+	// Set CC7_RUN_BENCHMARKS environment variable in the test scheme to enable them.
+	if (getenv("CC7_RUN_BENCHMARKS") == NULL) {
+		return;
+	}
+	tests::TestManager * manager = tests::TestManager::createBenchmarkManager();
+	manager->tl().setDumpToSystemLogEnabled(true);
+	
+	bool result = manager->runAllTests();
+	
+	tests::TestLogData log_data = manager->tl().logData();
+	tests::TestManager::releaseManager(manager);
+	
+	if (!result) {
+		NSLog(@"Incidents:\n%@", [NSString stringWithUTF8String:log_data.incidents.c_str()]);
+	}
+	XCTAssertTrue(result, @"Benchmark failed. Check debug log for details.");
+}
+
 @end
@@ -49,10 +49,23 @@ LOCAL_C_INCLUDES := \
 LOCAL_SRC_FILES := \
 	cc7/DebugFeatures.cpp \
 	cc7/ByteRange.cpp \
+	cc7/ByteRangeList.cpp \
 	cc7/ByteArray.cpp \
+	cc7/ByteWriter.cpp \
 	cc7/Base32.cpp \
 	cc7/Base64.cpp \
-	cc7/HexString.cpp
+	cc7/Base64Simd.cpp \
+	cc7/CodecBatch.cpp \
+	cc7/CpuFeatures.cpp \
+	cc7/Endian.cpp \
+	cc7/EndianSimd.cpp \
+	cc7/HexString.cpp \
+	cc7/HexStringSimd.cpp \
+	cc7/SecureArena.cpp \
+	cc7/SecureBuffer.cpp \
+	cc7/SecureHeap.cpp \
+	cc7/SecureMemory.cpp \
+	cc7/SecureMemoryResource.cpp
 
 # Android specific sources
 LOCAL_SRC_FILES += \
@@ -90,6 +103,7 @@ LOCAL_SRC_FILES := \
 	cc7tests/TestDirectory.cpp \
 	cc7tests/TestResource.cpp \
 	cc7tests/PerformanceTimer.cpp \
+	cc7tests/Benchmark.cpp \
 	cc7tests/JSONReader.cpp \
 	cc7tests/JSONValue.cpp \
 	cc7tests/detail/StringUtils.cpp
@@ -110,9 +124,23 @@ LOCAL_SRC_FILES += \
 	cc7tests/tests/cc7base/cc7Base32Tests.cpp \
 	cc7tests/tests/cc7base/cc7Base64Tests.cpp \
 	cc7tests/tests/cc7base/cc7ByteArrayTests.cpp \
+	cc7tests/tests/cc7base/cc7SmallByteArrayTests.cpp \
+	cc7tests/tests/cc7base/cc7SecureArenaTests.cpp \
+	cc7tests/tests/cc7base/cc7SecureHeapTests.cpp \
+	cc7tests/tests/cc7base/cc7SecureMemoryTests.cpp \
+	cc7tests/tests/cc7base/cc7SecureBufferTests.cpp \
 	cc7tests/tests/cc7base/cc7ByteRangeTests.cpp \
+	cc7tests/tests/cc7base/cc7ByteRangeListTests.cpp \
+	cc7tests/tests/cc7base/cc7ByteReaderTests.cpp \
+	cc7tests/tests/cc7base/cc7ByteWriterTests.cpp \
 	cc7tests/tests/cc7base/cc7HexStringTests.cpp \
-	cc7tests/tests/cc7base/cc7PlatformTests.cpp
+	cc7tests/tests/cc7base/cc7CodecBatchTests.cpp \
+	cc7tests/tests/cc7base/cc7PlatformTests.cpp \
+	cc7tests/tests/cc7base/cc7CpuFeaturesTests.cpp
+
+# Benchmarks (CC7)
+LOCAL_SRC_FILES += \
+	cc7tests/tests/cc7bench/cc7CodecBenchmarks.cpp
 
 # Generated files
 LOCAL_SRC_FILES += \
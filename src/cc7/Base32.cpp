@@ -15,11 +15,10 @@
  */
 
 #include <cc7/Base32.h>
+#include <cc7/Endian.h>
 
 namespace cc7
 {
-	// MARK: - Encode
-	
 	/*
 	 Sequence of 5 bytes mapped to 8 characters:
 	 +--------+--------+--------+--------+--------+
@@ -39,122 +38,231 @@ namespace cc7
 	 
 	 */
 	
-	/**
+	// MARK: - Alphabets
+	
+	/*
+	 Each alphabet policy provides two constexpr functions: encode() maps a 5 bit digit
+	 to the character and decode() maps a character to the digit, or to 0xFF for
+	 an invalid character. The lookup tables are generated from these functions
+	 at compile time, separately for each alphabet.
+	 */
+	
+	/*
+	 Returns digit for character |c| in the |Alphabet|, or 0xFF if there's no such character.
+	 */
+	template <typename Alphabet>
+	static constexpr U8 _DigitOf(size_t c, size_t digit = 0)
+	{
+		return digit == 32 ? 0xFF : (size_t)(U8)Alphabet::encode(digit) == c ? (U8)digit : _DigitOf<Alphabet>(c, digit + 1);
+	}
+	
+	/// Standard alphabet (RFC 4648, section 6)
+	struct _StandardAlphabet
+	{
+		static constexpr char encode(size_t digit)
+		{
+			return "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567"[digit];
+		}
+		static constexpr U8 decode(size_t c)
+		{
+			return _DigitOf<_StandardAlphabet>(c);
+		}
+	};
+	
+	/// Extended hex alphabet (RFC 4648, section 7), preserving sort order of encoded data.
+	struct _HexAlphabet
+	{
+		static constexpr char encode(size_t digit)
+		{
+			return "0123456789ABCDEFGHIJKLMNOPQRSTUV"[digit];
+		}
+		static constexpr U8 decode(size_t c)
+		{
+			return _DigitOf<_HexAlphabet>(c);
+		}
+	};
+	
+	/// Douglas Crockford's alphabet. The decoder ignores case and accepts 'I', 'L' as '1' and 'O' as '0'.
+	struct _CrockfordAlphabet
+	{
+		static constexpr char encode(size_t digit)
+		{
+			return "0123456789ABCDEFGHJKMNPQRSTVWXYZ"[digit];
+		}
+		static constexpr U8 decode(size_t c)
+		{
+			return (c >= 'a' && c <= 'z') ? decode(c - 'a' + 'A') :
+				   (c == 'O') ? 0 :
+				   (c == 'I' || c == 'L') ? 1 :
+				   _DigitOf<_CrockfordAlphabet>(c);
+		}
+	};
+	
+	template <size_t... I> struct _IndexSequence {};
+	template <size_t N, size_t... I> struct _MakeIndexSequence : _MakeIndexSequence<N - 1, N - 1, I...> {};
+	template <size_t... I> struct _MakeIndexSequence<0, I...> { typedef _IndexSequence<I...> type; };
+	
+	/*
 	 The encoding table, which maps digit to the character.
 	 */
-	static char s_encoding_table[32] =
+	template <typename Alphabet, typename Sequence = typename _MakeIndexSequence<32>::type>
+	struct _EncodingTable;
+	
+	template <typename Alphabet, size_t... I>
+	struct _EncodingTable<Alphabet, _IndexSequence<I...>>
+	{
+		static constexpr char table[sizeof...(I)] = { Alphabet::encode(I)... };
+	};
+	template <typename Alphabet, size_t... I>
+	constexpr char _EncodingTable<Alphabet, _IndexSequence<I...>>::table[sizeof...(I)];
+	
+	/*
+	 The decoding table maps all characters to 5 bit digits. All invalid characters are mapped
+	 to 0xFF, so the upper 3 bits in the combined mask signal an invalid character.
+	 */
+	template <typename Alphabet, typename Sequence = typename _MakeIndexSequence<256>::type>
+	struct _DecodingTable;
+	
+	template <typename Alphabet, size_t... I>
+	struct _DecodingTable<Alphabet, _IndexSequence<I...>>
 	{
-		'A','B','C','D','E','F','G','H','I','J','K','L','M','N','O','P',
-		'Q','R','S','T','U','V','W','X','Y','Z','2','3','4','5','6','7'
+		static constexpr U8 table[sizeof...(I)] = { Alphabet::decode(I)... };
 	};
+	template <typename Alphabet, size_t... I>
+	constexpr U8 _DecodingTable<Alphabet, _IndexSequence<I...>>::table[sizeof...(I)];
 	
 	/// Constant for padding character.
 	static const char s_padding = '=';
 	
+	/// Mask for bits which are set only for invalid characters.
+	static const U8 s_invalid_mask = 0xE0;
+	
+	// MARK: - Encode
+	
 	/*
-	 The main encode function.
+	 Encodes |blocks_count| complete 5 byte blocks into 8 characters each. The block
+	 is loaded as one 40 bit big endian number, so all digits are extracted with shifts.
 	 */
-	bool Base32_Encode(const ByteRange & bytes, bool use_padding, std::string & out_string)
+	template <typename Alphabet>
+	static void _EncodeBlocks(const byte * in, size_t blocks_count, char * out)
 	{
-		out_string.clear();
-		out_string.reserve((bytes.length() * 8 + 4) / 5);
-		
-		size_t index = 0, append = 0;
-		U16 curr_byte, digit;
-		char buffer[8];
-		
-		while (index < bytes.size()) {
-			// insert 5 new bits, leave 3 bits
-			curr_byte = bytes[index++];
-			buffer[0] = s_encoding_table[curr_byte >> 3];
-			digit = (curr_byte & 7) << 2;
-			if (index >= bytes.size()) {
-				buffer[1] = s_encoding_table[digit];
-				append = 2;
-				break;
-			}
-			// Insert 2 new bits, then 5 bits, leave 1 bit
-			curr_byte = bytes[index++];
-			buffer[1] = s_encoding_table[digit | (curr_byte >> 6)];
-			buffer[2] = s_encoding_table[(curr_byte >> 1) & 31];
-			digit = (curr_byte & 1) << 4;
-			if (index >= bytes.size()) {
-				buffer[3] = s_encoding_table[digit];
-				append = 4;
-				break;
+		const char * table = _EncodingTable<Alphabet>::table;
+		while (blocks_count > 0) {
+			U64 block;
+			if (blocks_count > 1) {
+				// At least 10 bytes are available, so the block can be loaded with one wide load.
+				memcpy(&block, in, sizeof(block));
+				block = FromBigEndian(block) >> 24;
+			} else {
+				block = ((U64)in[0] << 32) | ((U64)in[1] << 24) | ((U64)in[2] << 16) | ((U64)in[3] << 8) | (U64)in[4];
 			}
-			// Insert 4 new bits, leave 4 bits
-			curr_byte = bytes[index++];
-			buffer[3] = s_encoding_table[digit | (curr_byte >> 4)];
-			digit = (curr_byte & 15) << 1;
-			if (index >= bytes.size()) {
-				buffer[4] = s_encoding_table[digit];
-				append = 5;
-				break;
-			}
-			// Inser 1 new bit, then 5 bits, leave 2 bits
-			curr_byte = bytes[index++];
-			buffer[4] = s_encoding_table[digit | (curr_byte >> 7)];
-			buffer[5] = s_encoding_table[(curr_byte >> 2) & 31];
-			digit = (curr_byte & 3) << 3;
-			if (index >= bytes.size()) {
-				buffer[6] = s_encoding_table[digit];
-				append = 7;
-				break;
-			}
-			// Last, insert 3 new bits, then 5 bits, leave nothing.
-			curr_byte = bytes[index++];
-			buffer[6] = s_encoding_table[digit | (curr_byte >> 5)];
-			buffer[7] = s_encoding_table[curr_byte & 31];
-			// Now append the whole buffer and reset "append" marker
-			out_string.append(buffer, 8);
-			append = 0;
+			out[0] = table[(block >> 35) & 31];
+			out[1] = table[(block >> 30) & 31];
+			out[2] = table[(block >> 25) & 31];
+			out[3] = table[(block >> 20) & 31];
+			out[4] = table[(block >> 15) & 31];
+			out[5] = table[(block >> 10) & 31];
+			out[6] = table[(block >>  5) & 31];
+			out[7] = table[ block        & 31];
+			in  += 5;
+			out += 8;
+			blocks_count--;
 		}
-		
-		// If append is greater than 0, then there's remaining string in buffer
-		// which has to be appended to the output. That also means that padding
-		// is required.
-		if (append > 0) {
-			out_string.append(buffer, append);
-			if (use_padding) {
-				out_string.append(8 - append, s_padding);
-			}
+	}
+	
+	/*
+	 Encodes the last, incomplete block with |remainder| bytes (1 up to 4) and appends
+	 the padding, if required. Returns number of produced characters.
+	 */
+	template <typename Alphabet>
+	static size_t _EncodeTail(const byte * in, size_t remainder, bool use_padding, char * out)
+	{
+		// Number of characters produced for the remaining bytes: 2, 4, 5 or 7
+		const size_t tail_length = (remainder * 8 + 4) / 5;
+		const size_t length      = use_padding ? 8 : tail_length;
+		// The block is filled with zeros.
+		U64 block = 0;
+		for (size_t i = 0; i < 5; i++) {
+			block = (block << 8) | (i < remainder ? in[i] : 0);
 		}
-		return true;
+		for (size_t i = 0; i < tail_length; i++) {
+			out[i] = _EncodingTable<Alphabet>::table[(block >> (35 - i * 5)) & 31];
+		}
+		for (size_t i = tail_length; i < length; i++) {
+			out[i] = s_padding;
+		}
+		return length;
 	}
 	
-	// MARK: - Decode
+	/*
+	 Encodes whole |bytes| into |out|, which must have space for Base32_EncodedLength() characters.
+	 */
+	template <typename Alphabet>
+	static void _Encode(const ByteRange & bytes, bool use_padding, char * out)
+	{
+		const size_t blocks_count = bytes.size() / 5;
+		const size_t remainder    = bytes.size() % 5;
+		_EncodeBlocks<Alphabet>(bytes.data(), blocks_count, out);
+		if (remainder > 0) {
+			_EncodeTail<Alphabet>(bytes.data() + blocks_count * 5, remainder, use_padding, out + blocks_count * 8);
+		}
+	}
 	
-	/// Constnat returned from `_CharToDigit()` in case of invalid character.
-	static const U8 s_inv = 0xFF;
+	/*
+	 Selects the encoder's implementation for the |alphabet|.
+	 */
+	static void _Encode(const ByteRange & bytes, bool use_padding, char * out, Base32_Alphabet alphabet)
+	{
+		switch (alphabet) {
+			case Base32_Hex:		_Encode<_HexAlphabet>(bytes, use_padding, out); break;
+			case Base32_Crockford:	_Encode<_CrockfordAlphabet>(bytes, use_padding, out); break;
+			default:				_Encode<_StandardAlphabet>(bytes, use_padding, out); break;
+		}
+	}
 	
-	/// The encoding table maps character range from '2' up to 'Z' to
-	/// an appropriate digit. The range between 7 and A contains invalid constant.
-	static const U8 s_decoding_table[41] = {
-		26, 27, 28, 29, 30, 31,	s_inv, s_inv,				// 2 ... 7, 8, 9
-		s_inv, s_inv, s_inv, s_inv, s_inv, s_inv, s_inv,	// :;<=>?@,
-		0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13,		// A ... N
-		14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25		// O ... Z
-	};
+	size_t Base32_EncodedLength(size_t data_size, bool use_padding)
+	{
+		const size_t remainder = data_size % 5;
+		size_t n = (data_size / 5) * 8;
+		if (remainder > 0) {
+			n += use_padding ? 8 : (remainder * 8 + 4) / 5;
+		}
+		return n;
+	}
 	
-
-	/// The private function converts input character into 5 bit digit (0..31). If the character
-	/// is not from Base32 characters, then returns |s_inv| constant.
-	static U8 _CharToDigit(char c)
+	/*
+	 The main encode function.
+	 */
+	bool Base32_Encode(const ByteRange & bytes, bool use_padding, std::string & out_string, Base32_Alphabet alphabet)
 	{
-		int index = c - '2';
-		if (index >= 0 && index < 41) {
-			return s_decoding_table[index];
+		// Characters are written directly to the string's buffer, which has exactly
+		// the length of the final string.
+		out_string.resize(Base32_EncodedLength(bytes.size(), use_padding));
+		if (!out_string.empty()) {
+			_Encode(bytes, use_padding, &out_string[0], alphabet);
 		}
-		return s_inv;
+		return true;
 	}
 	
-
+	size_t Base32_EncodeTo(const ByteRange & bytes, bool use_padding, char * out, size_t out_capacity, Base32_Alphabet alphabet)
+	{
+		const size_t length = Base32_EncodedLength(bytes.size(), use_padding);
+		if (length > out_capacity) {
+			return ByteRange::npos;
+		}
+		if (length > 0) {
+			_Encode(bytes, use_padding, out, alphabet);
+		}
+		return length;
+	}
+	
+	// MARK: - Decode
+	
 	/// The private helper function validates whether the length of the string & padding meets criteria
 	/// for the Base32 string. Returns pair of bool & size_t parameters, where the |bool| means that
 	/// input string is valid and |size_t| is the the new, reduced size of input string,
 	/// without the padding characters.
-	static std::tuple<bool, size_t> _ValidatePadding(const std::string & string, bool required)
+	static std::tuple<bool, size_t> _ValidatePadding(const ByteRange & string, bool required)
 	{
 		size_t new_size = string.size();
 		size_t remainder = new_size % 8;
@@ -190,114 +298,408 @@ namespace cc7
 	}
 	
 	/*
-	 The main decode function.
+	 Decodes |blocks_count| complete 8 character blocks into 5 bytes each. The digits
+	 are merged into one 40 bit number and the invalid characters are accumulated
+	 in |invalid| mask, so the loop has no branches depending on the data.
 	 */
-	bool Base32_Decode(const std::string & in_string, bool require_padding, ByteArray & out_bytes)
+	template <typename Alphabet>
+	static void _DecodeBlocks(const byte * in, size_t blocks_count, byte * out, U8 & invalid)
+	{
+		const U8 * table = _DecodingTable<Alphabet>::table;
+		U8 inv = 0;
+		while (blocks_count > 0) {
+			const U8 d0 = table[in[0]];
+			const U8 d1 = table[in[1]];
+			const U8 d2 = table[in[2]];
+			const U8 d3 = table[in[3]];
+			const U8 d4 = table[in[4]];
+			const U8 d5 = table[in[5]];
+			const U8 d6 = table[in[6]];
+			const U8 d7 = table[in[7]];
+			inv |= d0 | d1 | d2 | d3 | d4 | d5 | d6 | d7;
+			const U64 block = ((U64)(d0 & 31) << 35) | ((U64)(d1 & 31) << 30) | ((U64)(d2 & 31) << 25) |
+							  ((U64)(d3 & 31) << 20) | ((U64)(d4 & 31) << 15) | ((U64)(d5 & 31) << 10) |
+							  ((U64)(d6 & 31) <<  5) |  (U64)(d7 & 31);
+			out[0] = (byte)(block >> 32);
+			out[1] = (byte)(block >> 24);
+			out[2] = (byte)(block >> 16);
+			out[3] = (byte)(block >> 8);
+			out[4] = (byte)(block);
+			in  += 8;
+			out += 5;
+			blocks_count--;
+		}
+		invalid |= inv;
+	}
+	
+	/*
+	 Decodes the last, incomplete block with |remainder| characters (2, 4, 5 or 7) and
+	 returns false if the block is not in the canonical form. The invalid characters
+	 are accumulated in |invalid| mask.
+	 */
+	template <typename Alphabet>
+	static bool _DecodeTail(const byte * in, size_t remainder, byte * out, U8 & invalid)
+	{
+		const size_t tail_length = remainder * 5 / 8;
+		U64 block = 0;
+		for (size_t i = 0; i < remainder; i++) {
+			const U8 digit = _DecodingTable<Alphabet>::table[in[i]];
+			invalid |= digit;
+			block = (block << 5) | (digit & 31);
+		}
+		// The remaining bits, which don't fit to the whole byte, must be zero.
+		const size_t extra_bits = remainder * 5 - tail_length * 8;
+		if ((block & ((1 << extra_bits) - 1)) != 0) {
+			return false;	// non-cannonical end
+		}
+		block >>= extra_bits;
+		for (size_t i = 0; i < tail_length; i++) {
+			out[i] = (byte)(block >> ((tail_length - 1 - i) * 8));
+		}
+		return true;
+	}
+	
+	/*
+	 Decodes |in_string| into |out| buffer with |out_capacity| bytes. Returns number of
+	 produced bytes, or ByteRange::npos in case of failure.
+	 */
+	template <typename Alphabet>
+	static size_t _Decode(const ByteRange & in_string, bool require_padding, byte * out, size_t out_capacity)
 	{
 		bool valid;
 		size_t count;
 		std::tie(valid, count) = _ValidatePadding(in_string, require_padding);
 		if (!valid) {
-			return false;
+			return ByteRange::npos;
+		}
+		const byte * in = in_string.data();
+		const size_t blocks_count = count / 8;
+		const size_t remainder    = count % 8;	// 0, 2, 4, 5 or 7
+		const size_t length       = blocks_count * 5 + remainder * 5 / 8;
+		if (length > out_capacity) {
+			return ByteRange::npos;
 		}
 		
-		// Prepare output byte array.
-		out_bytes.clear();
-		out_bytes.reserve(count * 5 / 8);
-		
-		U8 next_byte, digit;
-		size_t index = 0, append = 0;
-		U8 buffer[8];
+		U8 invalid = 0;
+		_DecodeBlocks<Alphabet>(in, blocks_count, out, invalid);
+		if (remainder > 0) {
+			valid = _DecodeTail<Alphabet>(in + blocks_count * 8, remainder, out + blocks_count * 5, invalid);
+		}
+		if (!valid || (invalid & s_invalid_mask)) {
+			return ByteRange::npos;
+		}
+		return length;
+	}
+	
+	/*
+	 Selects the decoder's implementation for the |alphabet|.
+	 */
+	static size_t _Decode(const ByteRange & in_string, bool require_padding, byte * out, size_t out_capacity, Base32_Alphabet alphabet)
+	{
+		switch (alphabet) {
+			case Base32_Hex:		return _Decode<_HexAlphabet>(in_string, require_padding, out, out_capacity);
+			case Base32_Crockford:	return _Decode<_CrockfordAlphabet>(in_string, require_padding, out, out_capacity);
+			default:				return _Decode<_StandardAlphabet>(in_string, require_padding, out, out_capacity);
+		}
+	}
+	
+	size_t Base32_DecodedMaxLength(size_t string_length)
+	{
+		return string_length * 5 / 8;
+	}
+	
+	/*
+	 The main decode function.
+	 */
+	bool Base32_Decode(const ByteRange & in_string, bool require_padding, ByteArray & out_bytes, Base32_Alphabet alphabet)
+	{
+		// The input string may be captured from the output array. In this case,
+		// decode data into a temporary array, to do not overwrite the input.
+		const byte * out_begin = out_bytes.data();
+		const byte * out_end   = out_begin + out_bytes.capacity();
+		if (!in_string.empty() && in_string.begin() < out_end && out_begin < in_string.end()) {
+			ByteArray temporary;
+			bool result = Base32_Decode(in_string, require_padding, temporary, alphabet);
+			out_bytes.swap(temporary);
+			return result;
+		}
 		
-		while (index < count) {
-			// Read 1st character
-			if ((digit = _CharToDigit(in_string[index++])) == s_inv) {
-				return false;
-			}
-			next_byte = digit << 3;
-			// Read 2nd character
-			if ((digit = _CharToDigit(in_string[index++])) == s_inv) {
-				return false;
+		// Bytes are written directly to the array's buffer, so the array is resized
+		// to the worst case length and then truncated to the final one.
+		out_bytes.clear();
+		out_bytes.resize(Base32_DecodedMaxLength(in_string.size()));
+		size_t produced = _Decode(in_string, require_padding, out_bytes.data(), out_bytes.size(), alphabet);
+		if (produced == ByteRange::npos) {
+			out_bytes.clear();
+			return false;
+		}
+		out_bytes.resize(produced);
+		return true;
+	}
+	
+	size_t Base32_DecodeTo(const ByteRange & in_string, bool require_padding, byte * out, size_t out_capacity, Base32_Alphabet alphabet)
+	{
+		return _Decode(in_string, require_padding, out, out_capacity, alphabet);
+	}
+	
+	// MARK: - Codec selection
+	
+	/*
+	 The _Codec structure contains block functions specialized for one alphabet.
+	 It's used by the streaming encoder and decoder, which select the alphabet
+	 at runtime.
+	 */
+	struct _Codec
+	{
+		void	(*encode_blocks)(const byte * in, size_t blocks_count, char * out);
+		size_t	(*encode_tail)(const byte * in, size_t remainder, bool use_padding, char * out);
+		void	(*decode_blocks)(const byte * in, size_t blocks_count, byte * out, U8 & invalid);
+		bool	(*decode_tail)(const byte * in, size_t remainder, byte * out, U8 & invalid);
+	};
+	
+	template <typename Alphabet>
+	static const _Codec & _GetCodec()
+	{
+		static const _Codec codec =
+		{
+			&_EncodeBlocks<Alphabet>, &_EncodeTail<Alphabet>, &_DecodeBlocks<Alphabet>, &_DecodeTail<Alphabet>
+		};
+		return codec;
+	}
+	
+	static const _Codec & _GetCodec(Base32_Alphabet alphabet)
+	{
+		switch (alphabet) {
+			case Base32_Hex:		return _GetCodec<_HexAlphabet>();
+			case Base32_Crockford:	return _GetCodec<_CrockfordAlphabet>();
+			default:				return _GetCodec<_StandardAlphabet>();
+		}
+	}
+	
+	
+	// MARK: Streaming encoder -
+	
+	Base32Encoder::Base32Encoder(bool use_padding, Sink sink, Base32_Alphabet alphabet) :
+		_use_padding(use_padding),
+		_alphabet(alphabet),
+		_sink(sink),
+		_pending_size(0),
+		_buffer_size(0)
+	{
+	}
+	
+	Base32Encoder::~Base32Encoder()
+	{
+		CC7_SecureClean(_pending, sizeof(_pending));
+		CC7_SecureClean(_buffer, sizeof(_buffer));
+	}
+	
+	bool Base32Encoder::update(const ByteRange & data)
+	{
+		const byte * in_p = data.data();
+		size_t in_len     = data.size();
+		if (_pending_size > 0) {
+			// Complete the block from the previous chunk
+			while (_pending_size < 5 && in_len > 0) {
+				_pending[_pending_size++] = *in_p++;
+				--in_len;
 			}
-			//  store 1st byte, keep 2 bits
-			buffer[0] = next_byte | (digit >> 2);
-			next_byte = digit << 6;
-			// Check end of string
-			if (index >= count) {
-				if (next_byte == 0) {
-					append = 1;	// ignore remaining zero bits, append 1 byte
-					break;
-				}
-				return false;	// non-cannonical end
+			if (_pending_size < 5) {
+				return true;
 			}
-			// Read 3rd character, keep 7 bits
-			if ((digit = _CharToDigit(in_string[index++])) == s_inv) {
-				return false;
+			_encodeBlocks(_pending, 1);
+			_pending_size = 0;
+		}
+		size_t blocks_count = in_len / 5;
+		_encodeBlocks(in_p, blocks_count);
+		// Keep the rest of unaligned bytes for the next round
+		in_p   += blocks_count * 5;
+		in_len -= blocks_count * 5;
+		while (in_len > 0) {
+			_pending[_pending_size++] = *in_p++;
+			--in_len;
+		}
+		return true;
+	}
+	
+	bool Base32Encoder::finish()
+	{
+		if (_pending_size > 0) {
+			if (BufferSize - _buffer_size < 8) {
+				_flush();
 			}
-			next_byte |= digit << 1;	// keep all 5 bits from digit
-			// Read 4th character
-			if ((digit = _CharToDigit(in_string[index++])) == s_inv) {
-				return false;
+			_buffer_size += _GetCodec(_alphabet).encode_tail(_pending, _pending_size, _use_padding, _buffer + _buffer_size);
+			_pending_size = 0;
+			CC7_SecureClean(_pending, sizeof(_pending));
+		}
+		_flush();
+		return true;
+	}
+	
+	void Base32Encoder::_encodeBlocks(const byte * in_p, size_t blocks_count)
+	{
+		const _Codec & codec = _GetCodec(_alphabet);
+		while (blocks_count > 0) {
+			size_t chunk = (BufferSize - _buffer_size) / 8;
+			if (chunk == 0) {
+				_flush();
+				continue;
 			}
-			// store 2nd byte, keep 4 bits
-			buffer[1] = next_byte | digit >> 4;
-			next_byte = (digit & 15) << 4;
-			// Check end of string
-			if (index >= count) {
-				if (next_byte == 0) {
-					append = 2;	// ignore remaining zero bits, append 2 bytes
-					break;
-				}
-				return false;	// non-cannonical end
+			if (chunk > blocks_count) {
+				chunk = blocks_count;
 			}
-			// Read 5th character
-			if ((digit = _CharToDigit(in_string[index++])) == s_inv) {
-				return false;
+			codec.encode_blocks(in_p, chunk, _buffer + _buffer_size);
+			_buffer_size += chunk * 8;
+			in_p         += chunk * 5;
+			blocks_count -= chunk;
+		}
+	}
+	
+	void Base32Encoder::_flush()
+	{
+		if (_buffer_size > 0) {
+			if (_sink) {
+				_sink(ByteRange(_buffer, _buffer_size));
 			}
-			// Store 3rd byte, keep 1 bit
-			buffer[2] = next_byte | (digit >> 1);
-			next_byte = (digit & 1) << 7;
-			// Check end of string
-			if (index >= count) {
-				if (next_byte == 0) {
-					append = 3;	// ignore remaining zero bits, append 3 bytes
-					break;
+			CC7_SecureClean(_buffer, _buffer_size);
+			_buffer_size = 0;
+		}
+	}
+	
+	
+	// MARK: Streaming decoder -
+	
+	Base32Decoder::Base32Decoder(bool require_padding, Sink sink, Base32_Alphabet alphabet) :
+		_require_padding(require_padding),
+		_alphabet(alphabet),
+		_sink(sink),
+		_failed(false),
+		_pending_size(0),
+		_buffer_size(0)
+	{
+	}
+	
+	Base32Decoder::~Base32Decoder()
+	{
+		CC7_SecureClean(_pending, sizeof(_pending));
+		CC7_SecureClean(_buffer, sizeof(_buffer));
+	}
+	
+	bool Base32Decoder::update(const ByteRange & string)
+	{
+		if (_failed) {
+			return false;
+		}
+		const byte * str_p   = string.begin();
+		const byte * str_end = string.end();
+		while (str_p < str_end) {
+			if (_pending_size == 8) {
+				// More characters follow, so the pending block cannot be the last one
+				// and must not contain the padding.
+				_pending_size = 0;
+				if (!_decodeBlocks(_pending, 1)) {
+					return _fail();
 				}
-				return false;	// non-cannonical end
 			}
-			// Read 6th character
-			if ((digit = _CharToDigit(in_string[index++])) == s_inv) {
-				return false;
+			if (_pending_size == 0) {
+				// All complete blocks, except the last one, can be processed directly
+				// from the input string. The last block is always kept for finish().
+				size_t blocks_count = (str_end - str_p - 1) / 8;
+				if (blocks_count > 0) {
+					if (!_decodeBlocks(str_p, blocks_count)) {
+						return _fail();
+					}
+					str_p += blocks_count * 8;
+				}
 			}
-			next_byte |= digit << 2;
-			// Read 7th character
-			if ((digit = _CharToDigit(in_string[index++])) == s_inv) {
-				return false;
+			// Collect characters for the block
+			while (_pending_size < 8 && str_p < str_end) {
+				_pending[_pending_size++] = *str_p++;
 			}
-			buffer[3] = next_byte | (digit >> 3);
-			next_byte = digit << 5;
-			if (index >= count) {
-				if (next_byte == 0) {
-					append = 4;	// ignore remaining zero bits, append 4 bytes
-					break;
+		}
+		return true;
+	}
+	
+	bool Base32Decoder::finish()
+	{
+		bool result = !_failed;
+		if (result && _pending_size > 0) {
+			// The pending block contains the end of the string, so the padding
+			// and the canonical end can be validated now.
+			size_t count;
+			std::tie(result, count) = _ValidatePadding(ByteRange(_pending, _pending_size), _require_padding);
+			if (result) {
+				const _Codec & codec = _GetCodec(_alphabet);
+				if (BufferSize - _buffer_size < 5) {
+					_flush();
 				}
-				return false;	// non-cannonical end
+				U8 invalid = 0;
+				byte * out_p = _buffer + _buffer_size;
+				if (count == 8) {
+					codec.decode_blocks(_pending, 1, out_p, invalid);
+					_buffer_size += 5;
+				} else if (count > 0) {
+					result = codec.decode_tail(_pending, count, out_p, invalid);
+					_buffer_size += count * 5 / 8;
+				}
+				result = result && (invalid & s_invalid_mask) == 0;
+			}
+		}
+		if (result) {
+			_flush();
+		}
+		_reset();
+		return result;
+	}
+	
+	bool Base32Decoder::_decodeBlocks(const byte * block_8, size_t blocks_count)
+	{
+		const _Codec & codec = _GetCodec(_alphabet);
+		while (blocks_count > 0) {
+			size_t chunk = (BufferSize - _buffer_size) / 5;
+			if (chunk == 0) {
+				_flush();
+				continue;
 			}
-			// Read 8th character
-			if ((digit = _CharToDigit(in_string[index++])) == s_inv) {
+			if (chunk > blocks_count) {
+				chunk = blocks_count;
+			}
+			U8 invalid = 0;
+			codec.decode_blocks(block_8, chunk, _buffer + _buffer_size, invalid);
+			if (invalid & s_invalid_mask) {
 				return false;
 			}
-			buffer[4] = next_byte | digit;
-			// Now append the whole buffer & reset the append marker.
-			out_bytes.append(buffer, 5);
-			append = 0;
-		}
-		// Everything looks OK.
-		// Append remained bytes & return true.
-		if (append > 0) {
-			out_bytes.append(buffer, append);
+			_buffer_size += chunk * 5;
+			block_8      += chunk * 8;
+			blocks_count -= chunk;
 		}
 		return true;
 	}
 	
+	bool Base32Decoder::_fail()
+	{
+		_failed = true;
+		return false;
+	}
+	
+	void Base32Decoder::_flush()
+	{
+		if (_buffer_size > 0) {
+			if (_sink) {
+				_sink(ByteRange(_buffer, _buffer_size));
+			}
+			CC7_SecureClean(_buffer, _buffer_size);
+			_buffer_size = 0;
+		}
+	}
+	
+	void Base32Decoder::_reset()
+	{
+		CC7_SecureClean(_pending, sizeof(_pending));
+		CC7_SecureClean(_buffer, sizeof(_buffer));
+		_buffer_size  = 0;
+		_pending_size = 0;
+		_failed       = false;
+	}
+	
 } // cc7
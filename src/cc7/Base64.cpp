@@ -16,6 +16,9 @@
 
 #include <cc7/Base64.h>
 #include <cc7/Utilities.h>
+#include <thread>
+#include <system_error>
+#include "Base64Simd.h"
 
 namespace cc7
 {
@@ -27,265 +30,982 @@ namespace cc7
 	// -----------------------------------------------------------------
 	
 	// MARK: Encoder -
-	static const char * s_enc_table = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
 	
-	static size_t _EstimateEncodedLength(size_t len, size_t wrap_output)
+	/*
+	 Encoder tables, indexed by detail::Base64_Alphabet.
+	 */
+	static const char * s_enc_table[2] =
 	{
-		size_t n = ((len + 2) / 3) * 4;
-		if (wrap_output > 0) {
-			n += strlen("\n") * ((n / wrap_output) + 1);
-		}
-		return n;
-	}
-
-	bool Base64_Encode(const ByteRange & range, size_t wrap_size, std::string & out_string)
+		"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/",
+		"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_",
+	};
+	
+	/*
+	 Returns true if |wrap_size| is 0 or divisible by 4.
+	 */
+	static bool _ValidateWrapSize(size_t wrap_size)
 	{
-		out_string.clear();
-		
 		if (wrap_size > 0) {
 			if (utilities::AlignValue<4>(wrap_size) != wrap_size) {
 				CC7_ASSERT(false, "wrap_size must be divisible by 4");
 				return false;
 			}
 		}
-		
-		out_string.reserve(_EstimateEncodedLength(range.size(), wrap_size));
-		
-		char block_4[4];
+		return true;
+	}
+	
+	/*
+	 Returns true if the variant's alphabet is URL and filename safe.
+	 */
+	static inline bool _IsUrlSafe(Base64_Variant variant)
+	{
+		return (variant & Base64_Url) != 0;
+	}
+	
+	/*
+	 Returns true if the variant uses padding.
+	 */
+	static inline bool _HasPadding(Base64_Variant variant)
+	{
+		return (variant & Base64_NoPadding) == 0;
+	}
+	
+	size_t Base64_EncodedLength(size_t data_size, size_t wrap_size, Base64_Variant variant)
+	{
+		size_t n = (data_size / 3) * 4;
+		size_t tail = data_size % 3;
+		if (tail > 0) {
+			// The last incomplete block has 4 characters with padding, or 1 character
+			// more than the number of remaining bytes without padding.
+			n += _HasPadding(variant) ? 4 : tail + 1;
+		}
+		if (wrap_size > 0) {
+			// New line is appended after each full line, produced from aligned triplets.
+			n += ((data_size / 3) * 4) / wrap_size;
+		}
+		return n;
+	}
+
+	/*
+	 Encodes all aligned triplets from |in_p| into |out_p| and returns pointer to the end
+	 of produced characters. The |in_len| must be divisible by 3. The vectorized kernel,
+	 if available, processes the bulk of the data and the rest is encoded here.
+	 */
+	template <bool UrlSafe>
+	static char * _EncodeTriplets(const byte * in_p, size_t in_len, char * out_p)
+	{
+		const detail::Base64_Kernels & kernels = detail::Base64_GetKernels();
+		if (kernels.encode[UrlSafe]) {
+			size_t processed = kernels.encode[UrlSafe](in_p, in_len, out_p);
+			in_p   += processed;
+			in_len -= processed;
+			out_p  += (processed / 3) * 4;
+		}
+		const char * enc_table = s_enc_table[UrlSafe];
+		while (in_len >= 3) {
+			out_p[0] = enc_table[  (in_p[0] & 0xfc) >> 2                            ];
+			out_p[1] = enc_table[ ((in_p[0] & 0x03) << 4) + ((in_p[1] & 0xf0) >> 4) ];
+			out_p[2] = enc_table[ ((in_p[1] & 0x0f) << 2) + ((in_p[2] & 0xc0) >> 6) ];
+			out_p[3] = enc_table[   in_p[2] & 0x3f                                  ];
+			in_len -= 3;
+			in_p   += 3;
+			out_p  += 4;
+		}
+		return out_p;
+	}
+
+	/*
+	 Encodes the rest of unaligned bytes (1 or 2) into the last block and returns
+	 pointer to the end of produced characters. The block is padded only if the
+	 |Padding| parameter is true.
+	 */
+	template <bool UrlSafe, bool Padding>
+	static char * _EncodeTail(const byte * in_p, size_t in_len, char * out_p)
+	{
+		const char * enc_table = s_enc_table[UrlSafe];
+		out_p[0] = enc_table[  (in_p[0] >> 2) & 0x3f ];
+		if (in_len == 1) {
+			out_p[1] = enc_table[ (in_p[0] << 4) & 0x3f ];
+			if (!Padding) {
+				return out_p + 2;
+			}
+			out_p[2] = '=';
+		} else {
+			out_p[1] = enc_table[ ((in_p[0] << 4) + (in_p[1] >> 4)) & 0x3f ];
+			out_p[2] = enc_table[  (in_p[1] << 2) & 0x3f ];
+			if (!Padding) {
+				return out_p + 3;
+			}
+		}
+		out_p[3] = '=';
+		return out_p + 4;
+	}
+	
+	/*
+	 Encodes whole |range| into |out_p| and returns pointer to the end of produced
+	 characters. The output buffer must have at least Base64_EncodedLength() capacity.
+	 */
+	template <bool UrlSafe, bool Padding>
+	static char * _Encode(const ByteRange & range, size_t wrap_size, char * out_p)
+	{
 		const byte * in_p   = range.data();
 		size_t in_len       = range.size();
-		size_t wrap_pos     = 0;
+		// Number of bytes encoded into one full line
+		const size_t line_size = (wrap_size / 4) * 3;
 		
 		while (in_len >= 3) {
-			// Process all aligned triplets
-			block_4[0] = s_enc_table[  (in_p[0] & 0xfc) >> 2                            ];
-			block_4[1] = s_enc_table[ ((in_p[0] & 0x03) << 4) + ((in_p[1] & 0xf0) >> 4) ];
-			block_4[2] = s_enc_table[ ((in_p[1] & 0x0f) << 2) + ((in_p[2] & 0xc0) >> 6) ];
-			block_4[3] = s_enc_table[   in_p[2] & 0x3f                                  ];
-			in_len -= 3;
-			in_p   += 3;
-			out_string.append(block_4, 4);
-			if (wrap_size) {
-				wrap_pos += 4;
-				if (wrap_pos >= wrap_size) {
-					out_string.append("\n");
-					wrap_pos = 0;
-				}
+			// Process all aligned triplets, line by line
+			size_t chunk = in_len - (in_len % 3);
+			if (wrap_size && chunk > line_size) {
+				chunk = line_size;
+			}
+			out_p   = _EncodeTriplets<UrlSafe>(in_p, chunk, out_p);
+			in_len -= chunk;
+			in_p   += chunk;
+			if (wrap_size && chunk == line_size) {
+				*out_p++ = '\n';
 			}
 		}
 		if (in_len > 0) {
 			// Process the rest of unaligned bytes
-			block_4[0] = s_enc_table[  (in_p[0] >> 2) & 0x3f ];
-			block_4[1] = s_enc_table[ ((in_p[0] << 4) + (--in_len ? in_p[1] >> 4 : 0)) & 0x3f ];
-			block_4[2] = (in_len ? s_enc_table[ ((in_p[1] << 2) + (--in_len ? (in_p[2]) >> 6 : 0)) & 0x3f ] : '=');
-			block_4[3] = '=';
-			out_string.append(block_4, 4);
+			out_p = _EncodeTail<UrlSafe, Padding>(in_p, in_len, out_p);
+		}
+		return out_p;
+	}
+	
+	/*
+	 Selects the encoder's implementation for the |variant|.
+	 */
+	static char * _Encode(const ByteRange & range, size_t wrap_size, char * out_p, Base64_Variant variant)
+	{
+		switch (variant) {
+			case Base64_Url:			return _Encode<true,  true> (range, wrap_size, out_p);
+			case Base64_NoPadding:		return _Encode<false, false>(range, wrap_size, out_p);
+			case Base64_UrlNoPadding:	return _Encode<true,  false>(range, wrap_size, out_p);
+			default:					return _Encode<false, true> (range, wrap_size, out_p);
+		}
+	}
+	
+	bool Base64_Encode(const ByteRange & range, size_t wrap_size, std::string & out_string, Base64_Variant variant)
+	{
+		out_string.clear();
+		
+		if (!_ValidateWrapSize(wrap_size)) {
+			return false;
+		}
+		
+		// Characters are written directly to the string's buffer, which has exactly
+		// the length of the final string.
+		out_string.resize(Base64_EncodedLength(range.size(), wrap_size, variant));
+		if (!out_string.empty()) {
+			_Encode(range, wrap_size, &out_string[0], variant);
 		}
 		return true;
 	}
 	
+	size_t Base64_EncodeTo(const ByteRange & in_data, size_t wrap_size, char * out, size_t out_capacity, Base64_Variant variant)
+	{
+		if (!_ValidateWrapSize(wrap_size)) {
+			return ByteRange::npos;
+		}
+		size_t length = Base64_EncodedLength(in_data.size(), wrap_size, variant);
+		if (length > out_capacity) {
+			return ByteRange::npos;
+		}
+		if (length > 0) {
+			_Encode(in_data, wrap_size, out, variant);
+		}
+		return length;
+	}
+	
 	
 	// MARK: Decoder -
 	
 	/*
-	 Decoder table contains conversion from arbitrary 8 bit character to radix value.
+	 Decoder tables contain conversion from arbitrary 8 bit character to radix value.
 	 If the traslated value is equal to 0xff then the original character is invalid.
+	 Tables are indexed by detail::Base64_Alphabet.
 	 */
-	static const byte s_dec_table[256] =
-	{
-		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
-		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
-		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x3e, 0xff, 0xff, 0xff, 0x3f,
-		0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
-		0xff, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,
-		0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xff, 0xff, 0xff, 0xff, 0xff,
-		0xff, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
-		0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0xff, 0xff, 0xff, 0xff, 0xff,
-		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
-		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
-		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
-		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
-		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
-		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
-		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
-		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	static const byte s_dec_table[2][256] =
+	{
+		{
+			0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+			0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+			0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x3e, 0xff, 0xff, 0xff, 0x3f,
+			0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+			0xff, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,
+			0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xff, 0xff, 0xff, 0xff, 0xff,
+			0xff, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+			0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0xff, 0xff, 0xff, 0xff, 0xff,
+			0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+			0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+			0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+			0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+			0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+			0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+			0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+			0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		},
+		{
+			0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+			0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+			0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x3e, 0xff, 0xff,
+			0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+			0xff, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,
+			0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xff, 0xff, 0xff, 0xff, 0x3f,
+			0xff, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+			0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0xff, 0xff, 0xff, 0xff, 0xff,
+			0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+			0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+			0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+			0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+			0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+			0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+			0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+			0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		},
 	};
 	
-	static bool Base64_DecodeNoWrap(const std::string & str, size_t sequence_start, size_t sequence_length,
-									ByteArray & out_data,
-									bool & end_marker)
+	/*
+	 Decodes |blocks_count| of non-padded blocks from |block_4| into |out_p|. The pointer
+	 to the output is moved to the end of produced bytes. Returns false if any block contains
+	 an invalid character, including the padding marker.
+	 */
+	template <bool UrlSafe>
+	static bool _DecodeBlocks(const byte * block_4, size_t blocks_count, byte * & out_p)
 	{
-		if (sequence_length == 0) {
-			// Not a real end marker, but this is an end of processing.
-			end_marker = true;
-			return true;
+		// Let the vectorized kernel process the bulk of blocks. The kernel
+		// stops at the first invalid character and the rest is validated below.
+		const detail::Base64_Kernels & kernels = detail::Base64_GetKernels();
+		if (kernels.decode[UrlSafe] && blocks_count > 0) {
+			size_t processed = kernels.decode[UrlSafe](block_4, blocks_count * 4, out_p);
+			blocks_count -= processed / 4;
+			block_4      += processed;
+			out_p        += (processed / 4) * 3;
 		}
 		
-		// Check sequence length.
-		if ((sequence_length & 3) != 0) {
-			// Wrong size of the sequence. No assertion, because we're using
-			// this routine also for non-wrapped strings.
-			return false;
-		}
-		if (sequence_start + sequence_length > str.length()) {
-			// Internal error. The provided sequence is out of the input string's range.
-			CC7_ASSERT(false, "Internal error. Provided block size is too long");
-			return false;
-		}
-		
-		//
-		// Reserve bytes in the byte array. The produced_size is a worst case
-		// estimation for length of final data.
-		//
-		size_t blocks_count  = sequence_length / 4;
-		size_t block_size    = blocks_count * 3;
-		out_data.reserve(out_data.size() + block_size);
-		
-		// Input pointer
-		const byte * block_4 = reinterpret_cast<const byte*>(str.c_str()) + sequence_start;
-		
-		// Check if last block contains padding and thus requires additional processing.
-		end_marker = block_4[sequence_length - 1] == '=' || block_4[sequence_length - 2] == '=';
-		if (end_marker) {
-			// Decrease number of "fast" blocks. We will process last one in a separate branch.
-			blocks_count--;
-		}
-		
-		// Process all non-padded blocks in fast way, without padding validation.
-		// If this sequence will contain padding then this will be treated as error.
+		const byte * dec_table = s_dec_table[UrlSafe];
 		byte c[4];
 		while (blocks_count > 0) {
 			
-			c[0] = s_dec_table[ block_4[0] ];
-			c[1] = s_dec_table[ block_4[1] ];
-			c[2] = s_dec_table[ block_4[2] ];
-			c[3] = s_dec_table[ block_4[3] ];
+			c[0] = dec_table[ block_4[0] ];
+			c[1] = dec_table[ block_4[1] ];
+			c[2] = dec_table[ block_4[2] ];
+			c[3] = dec_table[ block_4[3] ];
 			if (c[0] == 0xff || c[1] == 0xff ||
 				c[2] == 0xff || c[3] == 0xff) {
 				// wrong data
 				return false;
 			}
 			
-			out_data.push_back((c[0] << 2) | (c[1] >> 4));
-			out_data.push_back((c[1] << 4) | (c[2] >> 2));
-			out_data.push_back((c[2] << 6) |  c[3]);
+			out_p[0] = (c[0] << 2) | (c[1] >> 4);
+			out_p[1] = (c[1] << 4) | (c[2] >> 2);
+			out_p[2] = (c[2] << 6) |  c[3];
 			
 			blocks_count--;
 			block_4 += 4;
+			out_p   += 3;
 		}
-		
-		if (end_marker) {
-			// Last block contains a padding marker and requires more checks for correct processing.
-			c[0] = s_dec_table[ block_4[0] ];
-			c[1] = s_dec_table[ block_4[1] ];
-			if (c[0] == 0xff || c[1] == 0xff) {
-				// wrong data...
+		return true;
+	}
+	
+	/*
+	 Decodes the last incomplete block, with 2 or 3 characters, into 1 or 2 bytes.
+	 The pointer to the output is moved to the end of produced bytes.
+	 */
+	template <bool UrlSafe>
+	static bool _DecodePartialBlock(const byte * block, size_t length, byte * & out_p)
+	{
+		const byte * dec_table = s_dec_table[UrlSafe];
+		byte c[3];
+		c[0] = dec_table[ block[0] ];
+		c[1] = dec_table[ block[1] ];
+		if (c[0] == 0xff || c[1] == 0xff) {
+			// wrong data...
+			return false;
+		}
+		if (length == 3) {
+			c[2] = dec_table[ block[2] ];
+			if (c[2] == 0xff) {
+				// Last character is invalid. Sequence like 'XY?='
 				return false;
 			}
-			// First byte should be always decoded
-			out_data.push_back((c[0] << 2) | (c[1] >> 4));
+		}
+		// First byte should be always decoded
+		*out_p++ = (c[0] << 2) | (c[1] >> 4);
+		if (length == 3) {
+			*out_p++ = (c[1] << 4) | (c[2] >> 2);
+		}
+		return true;
+	}
+	
+	/*
+	 Decodes the last block, which contains a padding marker and requires more checks
+	 for correct processing. The pointer to the output is moved to the end of produced bytes.
+	 */
+	template <bool UrlSafe>
+	static bool _DecodePaddedBlock(const byte * block_4, byte * & out_p)
+	{
+		if (block_4[2] == '=') {
+			// Last two characters should be padding markers
+			if (block_4[3] != '=') {
+				// Wrong. Seqence like 'XY=Z'
+				return false;
+			}
+			return _DecodePartialBlock<UrlSafe>(block_4, 2, out_p);
 			
-			if (block_4[2] == '=') {
-				// Last two characters should be padding markers
-				if (block_4[3] != '=') {
-					// Wrong. Seqence like 'XY=Z'
-					return false;
-				}
-				// the rest is correct, last byte is already decoded
-				//
-			} else if (block_4[3] == '=') {
-				// Last char is padding marker, translate 3rd. character in the block
-				c[2] = s_dec_table[ block_4[2] ];
-				
-				if (c[2] == 0xff) {
-					// Last non-padded character is invalid. Sequence like 'XY?='
-					return false;
-				}
-				// c3 is correct and last character is padding
-				out_data.push_back((c[1] << 4) | (c[2] >> 2));
-			} else {
-				// This migh never happen. The 'end_marker' claims that the sequence
-				// contains padding marker, but the deep inspection is telling something else.
-				// Seems that we somehow processed less or more bytes as was planned.
-				CC7_ASSERT(false, "Internal error.");
+		} else if (block_4[3] == '=') {
+			// Last char is padding marker, translate 3rd. character in the block
+			return _DecodePartialBlock<UrlSafe>(block_4, 3, out_p);
+		}
+		// This migh never happen. The caller claims that the block
+		// contains padding marker, but the deep inspection is telling something else.
+		// Seems that we somehow processed less or more bytes as was planned.
+		CC7_ASSERT(false, "Internal error.");
+		return false;
+	}
+	
+	/*
+	 Returns true if the block contains a padding marker.
+	 */
+	static inline bool _IsPaddedBlock(const byte * block_4)
+	{
+		return block_4[3] == '=' || block_4[2] == '=';
+	}
+	
+	template <bool UrlSafe, bool Padding>
+	static bool Base64_DecodeNoWrap(const byte * block_4, size_t sequence_length,
+									byte * & out_p, byte * out_end,
+									bool & end_marker)
+	{
+		if (sequence_length == 0) {
+			// Not a real end marker, but this is an end of processing.
+			end_marker = true;
+			return true;
+		}
+		
+		size_t blocks_count  = sequence_length / 4;
+		size_t tail_length   = sequence_length & 3;
+		size_t produced_size = blocks_count * 3;
+		const byte * last_block;
+		
+		if (Padding) {
+			// Check sequence length.
+			if (tail_length != 0) {
+				// Wrong size of the sequence. No assertion, because we're using
+				// this routine also for non-wrapped strings.
+				return false;
+			}
+			// Check if last block contains padding and thus requires additional processing.
+			last_block = block_4 + sequence_length - 4;
+			end_marker = _IsPaddedBlock(last_block);
+			if (end_marker) {
+				// Decrease number of "fast" blocks. We will process last one in a separate branch.
+				blocks_count--;
+				produced_size -= (last_block[2] == '=') + (last_block[3] == '=');
+			}
+		} else {
+			// Without padding, the sequence may end with an incomplete block,
+			// but the single character cannot encode a whole byte.
+			if (tail_length == 1) {
 				return false;
 			}
+			last_block = block_4 + blocks_count * 4;
+			end_marker = tail_length != 0;
+			if (end_marker) {
+				produced_size += tail_length - 1;
+			}
+		}
+		// Check whether the output buffer has enough capacity for the sequence.
+		if (produced_size > size_t(out_end - out_p)) {
+			return false;
+		}
+		
+		// Process all complete, non-padded blocks in fast way, without padding validation.
+		// If this sequence will contain padding then this will be treated as error.
+		if (!_DecodeBlocks<UrlSafe>(block_4, blocks_count, out_p)) {
+			return false;
+		}
+		if (end_marker) {
+			// Last block contains a padding marker, or is incomplete, and requires
+			// more checks for correct processing.
+			if (Padding) {
+				return _DecodePaddedBlock<UrlSafe>(last_block, out_p);
+			}
+			return _DecodePartialBlock<UrlSafe>(last_block, tail_length, out_p);
 		}
 		return true;
 	}
 	
-	bool Base64_Decode(const std::string & string, size_t wrap_size, ByteArray & out_data)
+	/*
+	 Returns whitespace characters, which separate lines of the wrapped string.
+	 The set is equal to characters accepted by isspace() in the "C" locale.
+	 */
+	static inline ByteRange _Whitespace()
 	{
-		bool result = false;
-		out_data.clear();
+		return ByteRange(" \t\n\v\f\r", 6);
+	}
+	
+	/*
+	 Decodes whole Base64 string into the output buffer. Returns number of produced bytes,
+	 or ByteRange::npos if the string is not valid, or the output buffer is too small.
+	 If |out_end_marker| is provided, then it's set to true when the last line of the wrapped
+	 string contains the padding.
+	 */
+	template <bool UrlSafe, bool Padding>
+	static size_t _Decode(const byte * str_p, size_t str_len, size_t wrap_size, byte * out_begin, size_t out_capacity,
+						  bool * out_end_marker = nullptr)
+	{
+		bool result;
+		byte * out_p   = out_begin;
+		byte * out_end = out_begin + out_capacity;
+		
 		if (wrap_size > 0) {
 			//
 			// wrap impl.
 			//
-			if (utilities::AlignValue<4>(wrap_size) != wrap_size) {
-				CC7_ASSERT(false, "wrap_size must be divisible by 4");
-				return false;
-			}
-
-			// Calculate estimated data size (just to eliminate multiple reallocations in the data buffer)
-			size_t size = string.size();
-			size_t div = size / (wrap_size + 1);
-			size_t rem = size % (wrap_size + 1);
-			// subtract a number of possible new line characters
-			size -= div + (rem > 0 ? 1 : 0);
-			// final expected size of data
-			size_t byte_size = ((size + 3) / 4) * 3;
-			out_data.reserve(byte_size);
-			
-			// Current & End pointer
-			const char * str_p   = string.c_str();
-			const char * str_end = string.c_str() + string.length();
+			const ByteRange string(str_p, str_len);
+			const ByteRange whitespace = _Whitespace();
 			result = true;
 			
 			bool end_marker = false;
-			while (result && str_p < str_end) {
+			size_t pos = 0;
+			while (result && pos < str_len) {
 				// Find begin of the line, by skipping leading whitespaces
-				while (str_p < str_end) {
-					char c = *str_p;
-					if (!isspace(c)) {
-						break;
-					}
-					str_p++;
+				const size_t line_begin = string.find_first_not_of(whitespace, pos);
+				if (line_begin == ByteRange::npos) {
+					break;
 				}
 				// Find end of the line, by skipping non-whitespace characters
-				const char * line_begin = str_p;
-				while (str_p < str_end) {
-					char c = *str_p;
-					if (isspace(c)) {
-						break;
-					}
-					str_p++;
-				}
-				const char * line_end = str_p;
-				size_t line_length = line_end - line_begin;
+				pos = std::min(string.find_first_of(whitespace, line_begin), str_len);
+				size_t line_length = pos - line_begin;
 				if (line_length > 0) {
 					// There's some sequence of non-space characters.
 					if (end_marker) {
 						// previous line did end with end-marker. If there's a next line, then this is an error.
-						out_data.clear();
-						return false;
+						return ByteRange::npos;
 					}
 					// The rest of the decoding is handled in the "NoWrap" routine.
-					result = Base64_DecodeNoWrap(string, line_begin - string.c_str(), line_length, out_data, end_marker);
+					result = Base64_DecodeNoWrap<UrlSafe, Padding>(str_p + line_begin, line_length, out_p, out_end, end_marker);
 				}
 			}
+			if (out_end_marker) {
+				*out_end_marker = end_marker;
+			}
 			//
 		} else {
 			//
 			// no wrap impl.
 			//
 			bool foo;
-			result = Base64_DecodeNoWrap(string, 0, string.length(), out_data, foo);
+			result = Base64_DecodeNoWrap<UrlSafe, Padding>(str_p, str_len, out_p, out_end, foo);
+		}
+		return result ? size_t(out_p - out_begin) : ByteRange::npos;
+	}
+	
+	/*
+	 Selects the decoder's implementation for the |variant|.
+	 */
+	static size_t _Decode(const byte * str_p, size_t str_len, size_t wrap_size, byte * out_begin, size_t out_capacity,
+						  Base64_Variant variant)
+	{
+		switch (variant) {
+			case Base64_Url:			return _Decode<true,  true> (str_p, str_len, wrap_size, out_begin, out_capacity);
+			case Base64_NoPadding:		return _Decode<false, false>(str_p, str_len, wrap_size, out_begin, out_capacity);
+			case Base64_UrlNoPadding:	return _Decode<true,  false>(str_p, str_len, wrap_size, out_begin, out_capacity);
+			default:					return _Decode<false, true> (str_p, str_len, wrap_size, out_begin, out_capacity);
+		}
+	}
+	
+	size_t Base64_DecodedMaxLength(size_t string_length, Base64_Variant variant)
+	{
+		// Each line must contain only complete blocks, so the input string's length
+		// divided by 4 is always enough for the wrapped strings, even if the lines
+		// are longer than the |wrap_size| suggests.
+		size_t n = (string_length / 4) * 3;
+		if (!_HasPadding(variant)) {
+			// The last block may be incomplete.
+			size_t tail = string_length & 3;
+			if (tail > 1) {
+				n += tail - 1;
+			}
 		}
-		if (!result) {
+		return n;
+	}
+	
+	bool Base64_Decode(const ByteRange & in_string, size_t wrap_size, ByteArray & out_data, Base64_Variant variant)
+	{
+		if (!_ValidateWrapSize(wrap_size)) {
 			out_data.clear();
+			return false;
+		}
+		
+		// The input string may be captured from the output array. In this case,
+		// decode data into a temporary array, to do not overwrite the input.
+		const byte * out_begin = out_data.data();
+		const byte * out_end   = out_begin + out_data.capacity();
+		if (!in_string.empty() && in_string.begin() < out_end && out_begin < in_string.end()) {
+			ByteArray temporary;
+			bool result = Base64_Decode(in_string, wrap_size, temporary, variant);
+			out_data.swap(temporary);
+			return result;
+		}
+		
+		// Bytes are written directly to the array's buffer, so the array is resized
+		// to the worst case length and then truncated to the final one.
+		out_data.clear();
+		out_data.resize(Base64_DecodedMaxLength(in_string.size(), variant));
+		size_t produced = _Decode(in_string.data(), in_string.size(), wrap_size, out_data.data(), out_data.size(), variant);
+		if (produced == ByteRange::npos) {
+			out_data.clear();
+			return false;
+		}
+		out_data.resize(produced);
+		return true;
+	}
+	
+	size_t Base64_DecodeTo(const ByteRange & in_string, size_t wrap_size, byte * out, size_t out_capacity, Base64_Variant variant)
+	{
+		if (!_ValidateWrapSize(wrap_size)) {
+			return ByteRange::npos;
+		}
+		return _Decode(in_string.data(), in_string.size(), wrap_size, out, out_capacity, variant);
+	}
+
+	
+	// MARK: Parallel codec -
+	
+	/// Minimum number of input bytes processed in one parallel task.
+	static const size_t s_parallel_min_task_size = 64 * 1024;
+	
+	/*
+	 Default executor, which runs each task in a separate thread. The first
+	 task is executed in the calling thread. If the system cannot create more
+	 threads, then the remaining tasks are executed in the calling thread too.
+	 */
+	static void _ThreadExecutor(size_t tasks_count, const std::function<void (size_t)> & task)
+	{
+		std::vector<std::thread> threads;
+		threads.reserve(tasks_count);
+		size_t index = 1;
+#if !defined(CC7_NO_EXCEPTIONS)
+		try {
+#endif
+			for (; index < tasks_count; index++) {
+				threads.push_back(std::thread(task, index));
+			}
+#if !defined(CC7_NO_EXCEPTIONS)
+		} catch (const std::system_error &) {
+			// Already running threads must be joined, so the failure is not propagated.
+		}
+#endif
+		for (; index < tasks_count; index++) {
+			task(index);
+		}
+		task(0);
+		for (auto & thread : threads) {
+			thread.join();
+		}
+	}
+	
+	/*
+	 Returns number of tasks for the parallel processing of |size| bytes.
+	 */
+	static size_t _ParallelTasksCount(size_t size, size_t threads_count)
+	{
+		if (threads_count == 0) {
+			threads_count = std::thread::hardware_concurrency();
+		}
+		size_t tasks_count = size / s_parallel_min_task_size;
+		if (tasks_count > threads_count) {
+			tasks_count = threads_count;
+		}
+		return tasks_count > 0 ? tasks_count : 1;
+	}
+	
+	bool Base64_EncodeParallel(const ByteRange & in_data, size_t wrap_size, std::string & out_string,
+							   size_t threads_count, const Base64_Executor & executor)
+	{
+		size_t tasks_count = _ParallelTasksCount(in_data.size(), threads_count);
+		if (tasks_count == 1) {
+			return Base64_Encode(in_data, wrap_size, out_string);
 		}
+		out_string.clear();
+		if (!_ValidateWrapSize(wrap_size)) {
+			return false;
+		}
+		out_string.resize(Base64_EncodedLength(in_data.size(), wrap_size));
+		
+		// Each task encodes whole lines, or whole triplets if there's no wrapping.
+		// The position of the task's output is then exactly known.
+		const size_t align = wrap_size > 0 ? (wrap_size / 4) * 3 : 3;
+		const size_t task_size = ((in_data.size() / tasks_count + align - 1) / align) * align;
+		char * out_begin = &out_string[0];
+		
+		auto task = [&](size_t index) {
+			size_t from = index * task_size;
+			if (from >= in_data.size()) {
+				return;
+			}
+			// The last task encodes also the rest of unaligned bytes.
+			size_t count = index + 1 < tasks_count ? std::min(task_size, in_data.size() - from) : in_data.size() - from;
+			size_t out_offset = Base64_EncodedLength(from, wrap_size);
+			_Encode<false, true>(ByteRange(in_data.data() + from, count), wrap_size, out_begin + out_offset);
+		};
+		if (executor) {
+			executor(tasks_count, task);
+		} else {
+			_ThreadExecutor(tasks_count, task);
+		}
+		return true;
+	}
+	
+	bool Base64_DecodeParallel(const ByteRange & in_string, size_t wrap_size, ByteArray & out_data,
+							   size_t threads_count, const Base64_Executor & executor)
+	{
+		size_t tasks_count = _ParallelTasksCount(in_string.size(), threads_count);
+		if (tasks_count == 1) {
+			return Base64_Decode(in_string, wrap_size, out_data);
+		}
+		if (!_ValidateWrapSize(wrap_size)) {
+			out_data.clear();
+			return false;
+		}
+		const byte * str_begin = in_string.data();
+		const size_t str_len   = in_string.size();
+		if (wrap_size == 0 && (str_len & 3) != 0) {
+			// Wrong size of the string.
+			out_data.clear();
+			return false;
+		}
+		
+		// Split the string into parts. The string without wrapping is split at block boundaries,
+		// the wrapped string is split at whitespaces, so each part contains only whole lines.
+		const size_t task_size = ((str_len / tasks_count + 3) / 4) * 4;
+		std::vector<size_t> bounds(tasks_count + 1, str_len);
+		bounds[0] = 0;
+		for (size_t index = 1; index < tasks_count; index++) {
+			size_t split = std::max(bounds[index - 1], std::min(index * task_size, str_len));
+			if (wrap_size > 0) {
+				split = std::min(in_string.find_first_of(_Whitespace(), split), str_len);
+			}
+			bounds[index] = split;
+		}
+		
+		// Each task writes its data at the worst case position. The produced parts
+		// are then moved together.
+		ByteArray result(Base64_DecodedMaxLength(str_len));
+		std::vector<size_t> produced(tasks_count, 0);
+		std::vector<char> end_markers(tasks_count, false);
+		
+		auto task = [&](size_t index) {
+			const byte * str_p   = str_begin + bounds[index];
+			const size_t length  = bounds[index + 1] - bounds[index];
+			byte * out_p         = result.data() + Base64_DecodedMaxLength(bounds[index]);
+			const size_t capacity = Base64_DecodedMaxLength(length);
+			if (wrap_size > 0) {
+				bool end_marker = false;
+				produced[index] = _Decode<false, true>(str_p, length, wrap_size, out_p, capacity, &end_marker);
+				end_markers[index] = end_marker;
+			} else if (index + 1 < tasks_count) {
+				// Only the last part of the string can contain the padding.
+				produced[index] = _DecodeBlocks<false>(str_p, length / 4, out_p) ? length / 4 * 3 : ByteRange::npos;
+			} else {
+				produced[index] = _Decode<false, true>(str_p, length, wrap_size, out_p, capacity);
+			}
+		};
+		if (executor) {
+			executor(tasks_count, task);
+		} else {
+			_ThreadExecutor(tasks_count, task);
+		}
+		
+		// Validate results and move all parts together.
+		bool end_marker = false;
+		size_t result_size = 0;
+		for (size_t index = 0; index < tasks_count; index++) {
+			if (produced[index] == ByteRange::npos || (end_marker && produced[index] > 0)) {
+				// Invalid part, or data after the padding.
+				out_data.clear();
+				return false;
+			}
+			if (produced[index] > 0) {
+				end_marker = end_markers[index] != 0;
+				const byte * part = result.data() + Base64_DecodedMaxLength(bounds[index]);
+				if (part != result.data() + result_size) {
+					memmove(result.data() + result_size, part, produced[index]);
+				}
+				result_size += produced[index];
+			}
+		}
+		result.resize(result_size);
+		out_data.swap(result);
+		return true;
+	}
+	
+	
+	// MARK: Streaming encoder -
+	
+	Base64Encoder::Base64Encoder(size_t wrap_size, Sink sink) :
+		_wrap_size(wrap_size),
+		_line_length(0),
+		_sink(sink),
+		_valid(true),
+		_pending_size(0),
+		_buffer_size(0)
+	{
+		_valid = _ValidateWrapSize(wrap_size);
+	}
+	
+	Base64Encoder::~Base64Encoder()
+	{
+		CC7_SecureClean(_pending, sizeof(_pending));
+		CC7_SecureClean(_buffer, sizeof(_buffer));
+	}
+	
+	bool Base64Encoder::update(const ByteRange & data)
+	{
+		if (!_valid) {
+			return false;
+		}
+		const byte * in_p = data.data();
+		size_t in_len     = data.size();
+		if (_pending_size > 0) {
+			// Complete the triplet from the previous chunk
+			while (_pending_size < 3 && in_len > 0) {
+				_pending[_pending_size++] = *in_p++;
+				--in_len;
+			}
+			if (_pending_size < 3) {
+				return true;
+			}
+			_encodeTriplets(_pending, 3);
+			_pending_size = 0;
+		}
+		size_t aligned = in_len - (in_len % 3);
+		_encodeTriplets(in_p, aligned);
+		// Keep the rest of unaligned bytes for the next round
+		in_p   += aligned;
+		in_len -= aligned;
+		while (in_len > 0) {
+			_pending[_pending_size++] = *in_p++;
+			--in_len;
+		}
+		return true;
+	}
+	
+	bool Base64Encoder::finish()
+	{
+		if (!_valid) {
+			return false;
+		}
+		if (_pending_size > 0) {
+			if (BufferSize - _buffer_size < 4) {
+				_flush();
+			}
+			_EncodeTail<false, true>(_pending, _pending_size, _buffer + _buffer_size);
+			_buffer_size += 4;
+			_pending_size = 0;
+			CC7_SecureClean(_pending, sizeof(_pending));
+		}
+		_flush();
+		_line_length = 0;
+		return true;
+	}
+	
+	void Base64Encoder::_encodeTriplets(const byte * in_p, size_t in_len)
+	{
+		while (in_len > 0) {
+			// Number of bytes fitting to the buffer, keep one character for the new line.
+			size_t chunk = ((BufferSize - _buffer_size - 1) / 4) * 3;
+			if (chunk == 0) {
+				_flush();
+				continue;
+			}
+			if (chunk > in_len) {
+				chunk = in_len;
+			}
+			if (_wrap_size) {
+				// Don't cross the end of the current line
+				size_t line_rest = ((_wrap_size - _line_length) / 4) * 3;
+				if (chunk > line_rest) {
+					chunk = line_rest;
+				}
+			}
+			char * out_begin = _buffer + _buffer_size;
+			char * out_p     = _EncodeTriplets<false>(in_p, chunk, out_begin);
+			_buffer_size += out_p - out_begin;
+			in_p   += chunk;
+			in_len -= chunk;
+			if (_wrap_size) {
+				_line_length += out_p - out_begin;
+				if (_line_length == _wrap_size) {
+					_buffer[_buffer_size++] = '\n';
+					_line_length = 0;
+				}
+			}
+		}
+	}
+	
+	void Base64Encoder::_flush()
+	{
+		if (_buffer_size > 0) {
+			if (_sink) {
+				_sink(ByteRange(_buffer, _buffer_size));
+			}
+			CC7_SecureClean(_buffer, _buffer_size);
+			_buffer_size = 0;
+		}
+	}
+	
+	
+	// MARK: Streaming decoder -
+	
+	Base64Decoder::Base64Decoder(size_t wrap_size, Sink sink) :
+		_wrap_size(wrap_size),
+		_sink(sink),
+		_failed(false),
+		_end_marker(false),
+		_pending_size(0),
+		_buffer_size(0)
+	{
+		_failed = !_ValidateWrapSize(wrap_size);
+	}
+	
+	Base64Decoder::~Base64Decoder()
+	{
+		CC7_SecureClean(_buffer, sizeof(_buffer));
+	}
+	
+	bool Base64Decoder::update(const ByteRange & string)
+	{
+		if (_failed) {
+			return false;
+		}
+		const byte * str_p   = string.begin();
+		const byte * str_end = string.end();
+		while (str_p < str_end) {
+			if (_wrap_size > 0 && isspace(*str_p)) {
+				// The whitespace splits lines and each line must contain only complete blocks.
+				if (_pending_size != 0) {
+					return _fail();
+				}
+				str_p++;
+				continue;
+			}
+			if (_end_marker) {
+				// Previous block did end with end-marker. There must be no other character.
+				return _fail();
+			}
+			if (_pending_size == 0) {
+				// Find the end of sequence of non-space characters
+				const byte * line_end = str_end;
+				if (_wrap_size > 0) {
+					const size_t line_length = ByteRange(str_p, str_end - str_p).find_first_of(_Whitespace());
+					if (line_length != ByteRange::npos) {
+						line_end = str_p + line_length;
+					}
+				}
+				// All blocks except the last one must not contain the padding, so they
+				// can be processed in the fast way.
+				size_t blocks_count = (line_end - str_p) / 4;
+				if (blocks_count > 1) {
+					if (!_decodeBlocks(str_p, blocks_count - 1)) {
+						return _fail();
+					}
+					str_p += (blocks_count - 1) * 4;
+					continue;
+				}
+			}
+			// Collect characters for the block
+			_pending[_pending_size++] = *str_p++;
+			if (_pending_size == 4) {
+				_pending_size = 0;
+				if (!_decodeBlock(_pending)) {
+					return _fail();
+				}
+			}
+		}
+		return true;
+	}
+	
+	bool Base64Decoder::finish()
+	{
+		bool result = !_failed && _pending_size == 0;
+		if (result) {
+			_flush();
+		}
+		_reset();
 		return result;
 	}
+	
+	bool Base64Decoder::_decodeBlocks(const byte * block_4, size_t blocks_count)
+	{
+		while (blocks_count > 0) {
+			size_t chunk = (BufferSize - _buffer_size) / 3;
+			if (chunk == 0) {
+				_flush();
+				continue;
+			}
+			if (chunk > blocks_count) {
+				chunk = blocks_count;
+			}
+			byte * out_p = _buffer + _buffer_size;
+			if (!_DecodeBlocks<false>(block_4, chunk, out_p)) {
+				return false;
+			}
+			_buffer_size  = out_p - _buffer;
+			block_4      += chunk * 4;
+			blocks_count -= chunk;
+		}
+		return true;
+	}
+	
+	bool Base64Decoder::_decodeBlock(const byte * block_4)
+	{
+		if (!_IsPaddedBlock(block_4)) {
+			return _decodeBlocks(block_4, 1);
+		}
+		if (BufferSize - _buffer_size < 3) {
+			_flush();
+		}
+		byte * out_p = _buffer + _buffer_size;
+		if (!_DecodePaddedBlock<false>(block_4, out_p)) {
+			return false;
+		}
+		_buffer_size = out_p - _buffer;
+		_end_marker  = true;
+		return true;
+	}
+	
+	bool Base64Decoder::_fail()
+	{
+		_failed = true;
+		return false;
+	}
+	
+	void Base64Decoder::_flush()
+	{
+		if (_buffer_size > 0) {
+			if (_sink) {
+				_sink(ByteRange(_buffer, _buffer_size));
+			}
+			CC7_SecureClean(_buffer, _buffer_size);
+			_buffer_size = 0;
+		}
+	}
+	
+	void Base64Decoder::_reset()
+	{
+		CC7_SecureClean(_buffer, sizeof(_buffer));
+		_buffer_size  = 0;
+		_pending_size = 0;
+		_end_marker   = false;
+		_failed       = false;
+		if (_wrap_size > 0) {
+			// Keep the decoder in failed state, if it has an invalid wrap size.
+			_failed = utilities::AlignValue<4>(_wrap_size) != _wrap_size;
+		}
+	}
 
 } // cc7
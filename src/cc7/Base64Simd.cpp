@@ -0,0 +1,381 @@
+/*
+ * Copyright 2016 Juraj Durech <durech.juraj@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Base64Simd.h"
+
+#if defined(CC7_SIMD_X86)
+	#include <immintrin.h>
+#elif defined(CC7_SIMD_NEON)
+	#include <arm_neon.h>
+	#include <string.h>
+#endif
+
+namespace cc7
+{
+namespace detail
+{
+	// -----------------------------------------------------------------
+	// Vectorized Base64 kernels
+	//
+	// All kernels are processing only complete vectors, and the rest
+	// of the input is left for the scalar implementation in Base64.cpp.
+	// The scalar code is also a reference for all error handling, so if
+	// the kernel finds an invalid character, then simply stops and lets
+	// the scalar decoder report the failure.
+	// -----------------------------------------------------------------
+	
+	// All kernels, which depend on the alphabet, are templates with
+	// C62 and C63 parameters, which are characters for the last two indexes
+	// in the Base64 alphabet.
+
+#if defined(CC7_SIMD_X86)
+	
+	// MARK: SSSE3 -
+	
+	/*
+	 Converts 12 bytes, stored at the beginning of the vector, into 16 indexes
+	 to the Base64 alphabet. Based on the work of Wojciech Mula & Daniel Lemire.
+	 */
+	CC7_TARGET_SSSE3 static inline __m128i _EncodeIndexes_SSSE3(__m128i in)
+	{
+		in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+		const __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+		const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+		const __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+		const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+		return _mm_or_si128(t1, t3);
+	}
+	
+	/*
+	 Translates 16 indexes into the characters. The index range is reduced into
+	 14 classes and then the class-specific offset is added to each index.
+	 */
+	template <char C62, char C63>
+	CC7_TARGET_SSSE3 static inline __m128i _EncodeLookup_SSSE3(__m128i indexes)
+	{
+		const __m128i shift_lut = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+												'0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+												C62 - 62, C63 - 63, 'A', 0, 0);
+		__m128i classes = _mm_subs_epu8(indexes, _mm_set1_epi8(51));
+		const __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indexes);
+		classes = _mm_or_si128(classes, _mm_and_si128(less, _mm_set1_epi8(13)));
+		return _mm_add_epi8(_mm_shuffle_epi8(shift_lut, classes), indexes);
+	}
+	
+	/*
+	 Returns mask with 0xFF for all characters in range <first, first + count>.
+	 */
+	CC7_TARGET_SSSE3 static inline __m128i _InRange_SSSE3(__m128i c, char first, char count)
+	{
+		const __m128i x = _mm_sub_epi8(c, _mm_set1_epi8(first));
+		return _mm_cmpeq_epi8(_mm_min_epu8(x, _mm_set1_epi8(count)), x);
+	}
+	
+	/*
+	 Translates 16 characters into 6-bit values. Returns false if the vector contains
+	 an invalid character.
+	 */
+	template <char C62, char C63>
+	CC7_TARGET_SSSE3 static inline bool _DecodeLookup_SSSE3(__m128i c, __m128i & values)
+	{
+		const __m128i upper = _InRange_SSSE3(c, 'A', 25);
+		const __m128i lower = _InRange_SSSE3(c, 'a', 25);
+		const __m128i digit = _InRange_SSSE3(c, '0', 9);
+		const __m128i eq_62 = _mm_cmpeq_epi8(c, _mm_set1_epi8(C62));
+		const __m128i eq_63 = _mm_cmpeq_epi8(c, _mm_set1_epi8(C63));
+		const __m128i valid = _mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(_mm_or_si128(digit, eq_62), eq_63));
+		if (_mm_movemask_epi8(valid) != 0xFFFF) {
+			return false;
+		}
+		__m128i shift = _mm_and_si128(upper, _mm_set1_epi8(-'A'));
+		shift = _mm_or_si128(shift, _mm_and_si128(lower, _mm_set1_epi8(26 - 'a')));
+		shift = _mm_or_si128(shift, _mm_and_si128(digit, _mm_set1_epi8(52 - '0')));
+		shift = _mm_or_si128(shift, _mm_and_si128(eq_62, _mm_set1_epi8(62 - C62)));
+		shift = _mm_or_si128(shift, _mm_and_si128(eq_63, _mm_set1_epi8(63 - C63)));
+		values = _mm_add_epi8(c, shift);
+		return true;
+	}
+	
+	/*
+	 Packs 16 6-bit values into 12 bytes, stored at the beginning of the vector.
+	 */
+	CC7_TARGET_SSSE3 static inline __m128i _DecodePack_SSSE3(__m128i values)
+	{
+		const __m128i merge_ab_bc = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+		const __m128i merged = _mm_madd_epi16(merge_ab_bc, _mm_set1_epi32(0x00011000));
+		return _mm_shuffle_epi8(merged, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+	}
+	
+	template <char C62, char C63>
+	CC7_TARGET_SSSE3 static size_t _Encode_SSSE3(const cc7::byte * in, size_t in_len, char * out)
+	{
+		size_t processed = 0;
+		// Each step reads 16 bytes, but consumes only 12.
+		while (in_len - processed >= 16) {
+			const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + processed));
+			const __m128i chars = _EncodeLookup_SSSE3<C62, C63>(_EncodeIndexes_SSSE3(data));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out), chars);
+			processed += 12;
+			out += 16;
+		}
+		return processed;
+	}
+	
+	template <char C62, char C63>
+	CC7_TARGET_SSSE3 static size_t _Decode_SSSE3(const cc7::byte * in, size_t in_len, cc7::byte * out)
+	{
+		size_t processed = 0;
+		// Each step writes 16 bytes, but produces only 12. We have to keep
+		// at least 4 bytes of the slack at the end of output buffer.
+		while (in_len - processed >= 24) {
+			const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + processed));
+			__m128i values;
+			if (!_DecodeLookup_SSSE3<C62, C63>(chars, values)) {
+				break;
+			}
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out), _DecodePack_SSSE3(values));
+			processed += 16;
+			out += 12;
+		}
+		return processed;
+	}
+	
+	// MARK: AVX2 -
+	
+	CC7_TARGET_AVX2 static inline __m256i _EncodeIndexes_AVX2(__m256i in)
+	{
+		const __m128i shuffle = _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+		in = _mm256_shuffle_epi8(in, _mm256_broadcastsi128_si256(shuffle));
+		const __m256i t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+		const __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+		const __m256i t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+		const __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+		return _mm256_or_si256(t1, t3);
+	}
+	
+	template <char C62, char C63>
+	CC7_TARGET_AVX2 static inline __m256i _EncodeLookup_AVX2(__m256i indexes)
+	{
+		const __m128i shift_lut = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+												'0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+												C62 - 62, C63 - 63, 'A', 0, 0);
+		__m256i classes = _mm256_subs_epu8(indexes, _mm256_set1_epi8(51));
+		const __m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indexes);
+		classes = _mm256_or_si256(classes, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+		return _mm256_add_epi8(_mm256_shuffle_epi8(_mm256_broadcastsi128_si256(shift_lut), classes), indexes);
+	}
+	
+	CC7_TARGET_AVX2 static inline __m256i _InRange_AVX2(__m256i c, char first, char count)
+	{
+		const __m256i x = _mm256_sub_epi8(c, _mm256_set1_epi8(first));
+		return _mm256_cmpeq_epi8(_mm256_min_epu8(x, _mm256_set1_epi8(count)), x);
+	}
+	
+	template <char C62, char C63>
+	CC7_TARGET_AVX2 static inline bool _DecodeLookup_AVX2(__m256i c, __m256i & values)
+	{
+		const __m256i upper = _InRange_AVX2(c, 'A', 25);
+		const __m256i lower = _InRange_AVX2(c, 'a', 25);
+		const __m256i digit = _InRange_AVX2(c, '0', 9);
+		const __m256i eq_62 = _mm256_cmpeq_epi8(c, _mm256_set1_epi8(C62));
+		const __m256i eq_63 = _mm256_cmpeq_epi8(c, _mm256_set1_epi8(C63));
+		const __m256i valid = _mm256_or_si256(_mm256_or_si256(upper, lower), _mm256_or_si256(_mm256_or_si256(digit, eq_62), eq_63));
+		if (_mm256_movemask_epi8(valid) != -1) {
+			return false;
+		}
+		__m256i shift = _mm256_and_si256(upper, _mm256_set1_epi8(-'A'));
+		shift = _mm256_or_si256(shift, _mm256_and_si256(lower, _mm256_set1_epi8(26 - 'a')));
+		shift = _mm256_or_si256(shift, _mm256_and_si256(digit, _mm256_set1_epi8(52 - '0')));
+		shift = _mm256_or_si256(shift, _mm256_and_si256(eq_62, _mm256_set1_epi8(62 - C62)));
+		shift = _mm256_or_si256(shift, _mm256_and_si256(eq_63, _mm256_set1_epi8(63 - C63)));
+		values = _mm256_add_epi8(c, shift);
+		return true;
+	}
+	
+	/*
+	 Packs 32 6-bit values into 24 bytes, stored at the beginning of the vector.
+	 */
+	CC7_TARGET_AVX2 static inline __m256i _DecodePack_AVX2(__m256i values)
+	{
+		const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+		const __m256i merge_ab_bc = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+		const __m256i merged = _mm256_madd_epi16(merge_ab_bc, _mm256_set1_epi32(0x00011000));
+		const __m256i packed = _mm256_shuffle_epi8(merged, _mm256_broadcastsi128_si256(shuffle));
+		return _mm256_permutevar8x32_epi32(packed, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+	}
+	
+	template <char C62, char C63>
+	CC7_TARGET_AVX2 static size_t _Encode_AVX2(const cc7::byte * in, size_t in_len, char * out)
+	{
+		size_t processed = 0;
+		// Each step reads 28 bytes, but consumes only 24.
+		while (in_len - processed >= 32) {
+			const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + processed));
+			const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + processed + 12));
+			const __m256i data = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+			const __m256i chars = _EncodeLookup_AVX2<C62, C63>(_EncodeIndexes_AVX2(data));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(out), chars);
+			processed += 24;
+			out += 32;
+		}
+		return processed + _Encode_SSSE3<C62, C63>(in + processed, in_len - processed, out);
+	}
+	
+	template <char C62, char C63>
+	CC7_TARGET_AVX2 static size_t _Decode_AVX2(const cc7::byte * in, size_t in_len, cc7::byte * out)
+	{
+		size_t processed = 0;
+		// Each step writes 32 bytes, but produces only 24.
+		while (in_len - processed >= 44) {
+			const __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + processed));
+			__m256i values;
+			if (!_DecodeLookup_AVX2<C62, C63>(chars, values)) {
+				// Let SSSE3 kernel process the first half of the vector
+				break;
+			}
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _DecodePack_AVX2(values));
+			processed += 32;
+			out += 24;
+		}
+		return processed + _Decode_SSSE3<C62, C63>(in + processed, in_len - processed, out);
+	}
+
+#endif // defined(CC7_SIMD_X86)
+
+
+#if defined(CC7_SIMD_NEON)
+	
+	// MARK: NEON -
+	
+	/// First 62 characters of the alphabet, common for all variants.
+	static const char * s_neon_enc_table = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
+	
+	static inline uint8x16_t _InRange_NEON(uint8x16_t c, cc7::byte first, cc7::byte count)
+	{
+		return vcleq_u8(vsubq_u8(c, vdupq_n_u8(first)), vdupq_n_u8(count));
+	}
+	
+	/*
+	 Translates 16 characters into 6-bit values. The |valid| mask is set to 0xFF for
+	 each valid character.
+	 */
+	template <char C62, char C63>
+	static inline uint8x16_t _DecodeLookup_NEON(uint8x16_t c, uint8x16_t & valid)
+	{
+		const uint8x16_t upper = _InRange_NEON(c, 'A', 25);
+		const uint8x16_t lower = _InRange_NEON(c, 'a', 25);
+		const uint8x16_t digit = _InRange_NEON(c, '0', 9);
+		const uint8x16_t eq_62 = vceqq_u8(c, vdupq_n_u8(C62));
+		const uint8x16_t eq_63 = vceqq_u8(c, vdupq_n_u8(C63));
+		valid = vorrq_u8(vorrq_u8(upper, lower), vorrq_u8(vorrq_u8(digit, eq_62), eq_63));
+		uint8x16_t shift = vandq_u8(upper, vdupq_n_u8(cc7::byte(-'A')));
+		shift = vorrq_u8(shift, vandq_u8(lower, vdupq_n_u8(cc7::byte(26 - 'a'))));
+		shift = vorrq_u8(shift, vandq_u8(digit, vdupq_n_u8(cc7::byte(52 - '0'))));
+		shift = vorrq_u8(shift, vandq_u8(eq_62, vdupq_n_u8(cc7::byte(62 - C62))));
+		shift = vorrq_u8(shift, vandq_u8(eq_63, vdupq_n_u8(cc7::byte(63 - C63))));
+		return vaddq_u8(c, shift);
+	}
+	
+	template <char C62, char C63>
+	static size_t _Encode_NEON(const cc7::byte * in, size_t in_len, char * out)
+	{
+		// Build the 64 characters long table for the requested alphabet.
+		cc7::byte table_bytes[64];
+		memcpy(table_bytes, s_neon_enc_table, 62);
+		table_bytes[62] = C62;
+		table_bytes[63] = C63;
+		uint8x16x4_t table;
+		table.val[0] = vld1q_u8(table_bytes);
+		table.val[1] = vld1q_u8(table_bytes + 16);
+		table.val[2] = vld1q_u8(table_bytes + 32);
+		table.val[3] = vld1q_u8(table_bytes + 48);
+		const uint8x16_t mask_3f = vdupq_n_u8(0x3f);
+		
+		size_t processed = 0;
+		while (in_len - processed >= 48) {
+			// Load 16 triplets, deinterleaved into 3 vectors
+			const uint8x16x3_t data = vld3q_u8(in + processed);
+			uint8x16x4_t chars;
+			chars.val[0] = vshrq_n_u8(data.val[0], 2);
+			chars.val[1] = vandq_u8(vorrq_u8(vshlq_n_u8(data.val[0], 4), vshrq_n_u8(data.val[1], 4)), mask_3f);
+			chars.val[2] = vandq_u8(vorrq_u8(vshlq_n_u8(data.val[1], 2), vshrq_n_u8(data.val[2], 6)), mask_3f);
+			chars.val[3] = vandq_u8(data.val[2], mask_3f);
+			chars.val[0] = vqtbl4q_u8(table, chars.val[0]);
+			chars.val[1] = vqtbl4q_u8(table, chars.val[1]);
+			chars.val[2] = vqtbl4q_u8(table, chars.val[2]);
+			chars.val[3] = vqtbl4q_u8(table, chars.val[3]);
+			// Store 64 characters, interleaved
+			vst4q_u8(reinterpret_cast<cc7::byte*>(out), chars);
+			processed += 48;
+			out += 64;
+		}
+		return processed;
+	}
+	
+	template <char C62, char C63>
+	static size_t _Decode_NEON(const cc7::byte * in, size_t in_len, cc7::byte * out)
+	{
+		size_t processed = 0;
+		while (in_len - processed >= 64) {
+			// Load 16 blocks, deinterleaved into 4 vectors
+			const uint8x16x4_t chars = vld4q_u8(in + processed);
+			uint8x16_t v0, v1, v2, v3, valid0, valid1, valid2, valid3;
+			v0 = _DecodeLookup_NEON<C62, C63>(chars.val[0], valid0);
+			v1 = _DecodeLookup_NEON<C62, C63>(chars.val[1], valid1);
+			v2 = _DecodeLookup_NEON<C62, C63>(chars.val[2], valid2);
+			v3 = _DecodeLookup_NEON<C62, C63>(chars.val[3], valid3);
+			const uint8x16_t valid = vandq_u8(vandq_u8(valid0, valid1), vandq_u8(valid2, valid3));
+			if (vminvq_u8(valid) != 0xFF) {
+				break;
+			}
+			uint8x16x3_t data;
+			data.val[0] = vorrq_u8(vshlq_n_u8(v0, 2), vshrq_n_u8(v1, 4));
+			data.val[1] = vorrq_u8(vshlq_n_u8(v1, 4), vshrq_n_u8(v2, 2));
+			data.val[2] = vorrq_u8(vshlq_n_u8(v2, 6), v3);
+			// Store 48 bytes, interleaved
+			vst3q_u8(out, data);
+			processed += 64;
+			out += 48;
+		}
+		return processed;
+	}
+
+#endif // defined(CC7_SIMD_NEON)
+	
+	
+	// MARK: Kernel selection -
+	
+	const Base64_Kernels & Base64_GetKernels()
+	{
+		// Candidates are ordered from the most preferred one. The kernel tables are indexed
+		// by Base64_Alphabet, so the standard alphabet is always the first one.
+		static const cpu::Candidate<Base64_Kernels> s_candidates[] =
+		{
+#if defined(CC7_SIMD_X86)
+			{ cpu::AVX2,	{ { _Encode_AVX2<'+', '/'>,  _Encode_AVX2<'-', '_'>  }, { _Decode_AVX2<'+', '/'>,  _Decode_AVX2<'-', '_'>  }, "avx2"  } },
+			{ cpu::SSSE3,	{ { _Encode_SSSE3<'+', '/'>, _Encode_SSSE3<'-', '_'> }, { _Decode_SSSE3<'+', '/'>, _Decode_SSSE3<'-', '_'> }, "ssse3" } },
+#elif defined(CC7_SIMD_NEON)
+			{ cpu::NEON,	{ { _Encode_NEON<'+', '/'>,  _Encode_NEON<'-', '_'>  }, { _Decode_NEON<'+', '/'>,  _Decode_NEON<'-', '_'>  }, "neon"  } },
+#endif
+			{ 0,			{ { nullptr, nullptr }, { nullptr, nullptr }, "scalar" } },
+		};
+		// C++11 guarantees thread safe initialization of the local static variable.
+		static const Base64_Kernels & s_kernels = cpu::Select(s_candidates);
+		return s_kernels;
+	}
+
+} // cc7::detail
+} // cc7
@@ -0,0 +1,73 @@
+/*
+ * Copyright 2016 Juraj Durech <durech.juraj@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Simd.h"
+
+//
+// Private header, shared between Base64.cpp and Base64Simd.cpp.
+//
+
+namespace cc7
+{
+namespace detail
+{
+	/**
+	 Encode kernel converts as many aligned triplets from |in| as possible into
+	 Base64 characters written to |out|. The |in_len| must be divisible by 3.
+	 Returns number of consumed input bytes, which is always divisible by 3.
+	 The caller is responsible to process the rest of the input.
+	 */
+	typedef size_t (*Base64_EncodeKernel)(const cc7::byte * in, size_t in_len, char * out);
+
+	/**
+	 Decode kernel converts as many 4 character blocks from |in| as possible into bytes
+	 written to |out|. The |in_len| must be divisible by 4 and the input must not contain
+	 padding characters. The kernel stops before the first vector containing an invalid
+	 character, so the scalar decoder can process the rest and report the error.
+	 Returns number of consumed input characters, which is always divisible by 4.
+	 */
+	typedef size_t (*Base64_DecodeKernel)(const cc7::byte * in, size_t in_len, cc7::byte * out);
+
+	/**
+	 Indexes to the kernel tables, for supported alphabets.
+	 */
+	enum Base64_Alphabet
+	{
+		Base64_Alphabet_Standard	= 0,	// "+/" as last two characters
+		Base64_Alphabet_Url			= 1,	// "-_" as last two characters
+	};
+	
+	/**
+	 The Base64_Kernels structure contains kernels selected for the current CPU, for each
+	 supported alphabet. All pointers are nullptr when there's no vectorized implementation available.
+	 */
+	struct Base64_Kernels
+	{
+		Base64_EncodeKernel	encode[2];
+		Base64_DecodeKernel	decode[2];
+		const char *		name;
+	};
+
+	/**
+	 Returns kernels selected for the current CPU. The selection is performed only once,
+	 at the first call, and the function is thread safe.
+	 */
+	const Base64_Kernels & Base64_GetKernels();
+
+} // cc7::detail
+} // cc7
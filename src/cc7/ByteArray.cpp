@@ -25,11 +25,26 @@ namespace cc7
 		return Base64_Decode(base64_string, wrap_size, *this);
 	}
 	
+	bool ByteArray::readFromBase64String(const ByteRange & base64_string, size_t wrap_size)
+	{
+		return Base64_Decode(base64_string, wrap_size, *this);
+	}
+	
+	bool ByteArray::readFromBase64String(const char * base64_string, size_t length, size_t wrap_size)
+	{
+		return Base64_Decode(base64_string, length, wrap_size, *this);
+	}
+	
 	bool ByteArray::readFromHexString(const std::string & hex_string)
 	{
 		return HexString_Decode(hex_string, *this);
 	}
 	
+	bool ByteArray::readFromHexString(const ByteRange & hex_string)
+	{
+		return HexString_Decode(hex_string, *this);
+	}
+	
 	std::string ByteArray::base64String(size_t wrap_size) const
 	{
 		std::string result;
@@ -18,8 +18,270 @@
 #include <cc7/Base64.h>
 #include <cc7/HexString.h>
 
+// Both SSE2 and NEON are part of the base instruction set on all supported
+// 64 bit CPUs, so no runtime detection is required.
+#if !defined(CC7_NO_SIMD)
+	#if defined(__SSE2__)
+		#include <emmintrin.h>
+		#define CC7_SEARCH_SSE2
+	#elif defined(__aarch64__) && defined(__ARM_NEON)
+		#include <arm_neon.h>
+		#define CC7_SEARCH_NEON
+	#endif
+#endif
+
 namespace cc7
 {
+	// MARK: Vector helpers -
+	
+#if defined(CC7_SEARCH_SSE2)
+	
+	typedef __m128i _Vector;
+	
+	static inline _Vector _Load(const byte * p)						{ return _mm_loadu_si128((const __m128i*)p); }
+	static inline _Vector _Splat(byte b)							{ return _mm_set1_epi8((char)b); }
+	static inline _Vector _Equal(_Vector a, _Vector b)				{ return _mm_cmpeq_epi8(a, b); }
+	static inline _Vector _Or(_Vector a, _Vector b)					{ return _mm_or_si128(a, b); }
+	static inline _Vector _And(_Vector a, _Vector b)				{ return _mm_and_si128(a, b); }
+	static inline _Vector _Zero()									{ return _mm_setzero_si128(); }
+	
+	/*
+	 Returns mask with one bit per byte, set for all matching bytes.
+	 */
+	static inline U64 _Mask(_Vector v)
+	{
+		return (U32)_mm_movemask_epi8(v);
+	}
+	static const unsigned s_mask_shift = 0;
+	static const U64 s_mask_all = 0xFFFF;
+	
+#elif defined(CC7_SEARCH_NEON)
+	
+	typedef uint8x16_t _Vector;
+	
+	static inline _Vector _Load(const byte * p)						{ return vld1q_u8(p); }
+	static inline _Vector _Splat(byte b)							{ return vdupq_n_u8(b); }
+	static inline _Vector _Equal(_Vector a, _Vector b)				{ return vceqq_u8(a, b); }
+	static inline _Vector _Or(_Vector a, _Vector b)					{ return vorrq_u8(a, b); }
+	static inline _Vector _And(_Vector a, _Vector b)				{ return vandq_u8(a, b); }
+	static inline _Vector _Zero()									{ return vdupq_n_u8(0); }
+	
+	/*
+	 Returns mask with one bit in each nibble, set for all matching bytes.
+	 The narrowing shift is faster than the emulation of x86 movemask.
+	 */
+	static inline U64 _Mask(_Vector v)
+	{
+		return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(v), 4)), 0) & 0x8888888888888888ULL;
+	}
+	static const unsigned s_mask_shift = 2;
+	static const U64 s_mask_all = 0x8888888888888888ULL;
+	
+#endif
+	
+#if defined(CC7_SEARCH_SSE2) || defined(CC7_SEARCH_NEON)
+	#define CC7_SEARCH_SIMD
+	
+	/*
+	 Returns index of the first and the last matching byte in the non-zero mask.
+	 */
+	static inline size_t _FirstIndex(U64 mask)
+	{
+		return (size_t)__builtin_ctzll(mask) >> s_mask_shift;
+	}
+	
+	static inline size_t _LastIndex(U64 mask)
+	{
+		return (size_t)(63 - __builtin_clzll(mask)) >> s_mask_shift;
+	}
+	
+	/*
+	 Removes the first matching byte from the mask.
+	 */
+	static inline U64 _ClearFirst(U64 mask)
+	{
+		return mask & (mask - 1);
+	}
+	
+#endif
+	
+	// MARK: Search -
+	
+	/*
+	 Returns pointer to the last |value| in the memory block, or nullptr.
+	 */
+	static const byte * _FindLastByte(const byte * begin, const byte * end, byte value)
+	{
+#if defined(CC7_SEARCH_SIMD)
+		const _Vector v_value = _Splat(value);
+		while (end - begin >= 16) {
+			const U64 mask = _Mask(_Equal(_Load(end - 16), v_value));
+			if (mask) {
+				return end - 16 + _LastIndex(mask);
+			}
+			end -= 16;
+		}
+#endif
+		while (end > begin) {
+			if (*--end == value) {
+				return end;
+			}
+		}
+		return nullptr;
+	}
+	
+	/*
+	 Returns pointer to the first byte, which is (or is not, when |Negate| is true)
+	 contained in the |set|, or nullptr.
+	 */
+	template <bool Negate>
+	static const byte * _FindFirstOf(const byte * begin, const byte * end, const ByteRange & set)
+	{
+#if defined(CC7_SEARCH_SIMD)
+		// Small sets, like whitespace characters, are compared with each byte in the vector.
+		if (set.size() <= 8 && end - begin >= 16) {
+			_Vector v_set[8];
+			const size_t set_size = set.size();
+			for (size_t i = 0; i < set_size; i++) {
+				v_set[i] = _Splat(set[i]);
+			}
+			while (end - begin >= 16) {
+				const _Vector v = _Load(begin);
+				_Vector found = _Zero();
+				for (size_t i = 0; i < set_size; i++) {
+					found = _Or(found, _Equal(v, v_set[i]));
+				}
+				const U64 mask = Negate ? ~_Mask(found) & s_mask_all : _Mask(found);
+				if (mask) {
+					return begin + _FirstIndex(mask);
+				}
+				begin += 16;
+			}
+		}
+#endif
+		bool table[256] = { false };
+		for (byte b : set) {
+			table[b] = true;
+		}
+		while (begin < end) {
+			if (table[*begin] != Negate) {
+				return begin;
+			}
+			begin++;
+		}
+		return nullptr;
+	}
+	
+	/*
+	 Returns pointer to the first occurrence of the |sequence|, which must have
+	 at least 2 bytes, or nullptr.
+	 */
+	static const byte * _FindSequence(const byte * begin, const byte * end, const ByteRange & sequence)
+	{
+		const byte * seq = sequence.data();
+		const size_t seq_size = sequence.size();
+		const byte first = seq[0];
+		const byte last  = seq[seq_size - 1];
+		// The last possible position of the sequence
+		const byte * last_pos = end - seq_size;
+#if defined(CC7_SEARCH_SIMD)
+		// The vectors with the first and the last byte of the sequence are compared
+		// at once, so only positions matching both bytes are verified with memcmp().
+		const _Vector v_first = _Splat(first);
+		const _Vector v_last  = _Splat(last);
+		while (last_pos - begin >= 15) {
+			const _Vector eq_first = _Equal(_Load(begin), v_first);
+			const _Vector eq_last  = _Equal(_Load(begin + seq_size - 1), v_last);
+			U64 mask = _Mask(_And(eq_first, eq_last));
+			while (mask) {
+				const byte * candidate = begin + _FirstIndex(mask);
+				if (memcmp(candidate + 1, seq + 1, seq_size - 2) == 0) {
+					return candidate;
+				}
+				mask = _ClearFirst(mask);
+			}
+			begin += 16;
+		}
+#endif
+		while (begin <= last_pos) {
+			begin = static_cast<const byte*>(memchr(begin, first, last_pos - begin + 1));
+			if (!begin) {
+				break;
+			}
+			if (begin[seq_size - 1] == last && memcmp(begin + 1, seq + 1, seq_size - 2) == 0) {
+				return begin;
+			}
+			begin++;
+		}
+		return nullptr;
+	}
+	
+	ByteRange::size_type ByteRange::find(const ByteRange & sequence, size_type pos) const noexcept
+	{
+		if (pos > size() || sequence.size() > size() - pos) {
+			return npos;
+		}
+		if (sequence.size() <= 1) {
+			return sequence.empty() ? pos : find(sequence[0], pos);
+		}
+		const byte * found = _FindSequence(_begin + pos, _end, sequence);
+		return found ? found - _begin : npos;
+	}
+	
+	ByteRange::size_type ByteRange::rfind(cc7::byte value, size_type pos) const noexcept
+	{
+		if (empty()) {
+			return npos;
+		}
+		const_pointer end = _begin + std::min(pos, size() - 1) + 1;
+		const byte * found = _FindLastByte(_begin, end, value);
+		return found ? found - _begin : npos;
+	}
+	
+	ByteRange::size_type ByteRange::rfind(const ByteRange & sequence, size_type pos) const noexcept
+	{
+		if (sequence.size() > size()) {
+			return npos;
+		}
+		// The last possible position of the sequence
+		size_type last_pos = std::min(pos, size() - sequence.size());
+		if (sequence.empty()) {
+			return last_pos;
+		}
+		// Find the first byte from the end and verify the rest of the sequence.
+		const_pointer end = _begin + last_pos + 1;
+		while (const byte * found = _FindLastByte(_begin, end, sequence[0])) {
+			if (memcmp(found + 1, sequence.data() + 1, sequence.size() - 1) == 0) {
+				return found - _begin;
+			}
+			end = found;
+		}
+		return npos;
+	}
+	
+	ByteRange::size_type ByteRange::find_first_of(const ByteRange & set, size_type pos) const noexcept
+	{
+		if (pos >= size() || set.empty()) {
+			return npos;
+		}
+		if (set.size() == 1) {
+			return find(set[0], pos);
+		}
+		const byte * found = _FindFirstOf<false>(_begin + pos, _end, set);
+		return found ? found - _begin : npos;
+	}
+	
+	ByteRange::size_type ByteRange::find_first_not_of(const ByteRange & set, size_type pos) const noexcept
+	{
+		if (pos >= size()) {
+			return npos;
+		}
+		const byte * found = _FindFirstOf<true>(_begin + pos, _end, set);
+		return found ? found - _begin : npos;
+	}
+	
+	// MARK: Conversions -
+	
 	std::string ByteRange::base64String(size_t wrap_size) const
 	{
 		std::string result;
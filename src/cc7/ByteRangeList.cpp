@@ -0,0 +1,185 @@
+/*
+ * Copyright 2016 Juraj Durech <durech.juraj@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cc7/ByteRangeList.h>
+
+namespace cc7
+{
+	// MARK: Building -
+	
+	ByteRangeList & ByteRangeList::append(const ByteRangeList & list)
+	{
+		if (&list == this) {
+			// Appending to itself would invalidate the iterators.
+			const ByteRangeList copy(list);
+			return append(copy);
+		}
+		_segments.insert(_segments.end(), list._segments.begin(), list._segments.end());
+		_size += list._size;
+		return *this;
+	}
+	
+	ByteRangeList & ByteRangeList::prepend(const ByteRange & range)
+	{
+		if (!range.empty()) {
+			_segments.insert(_segments.begin(), range);
+			_size += range.size();
+		}
+		return *this;
+	}
+	
+	// MARK: Accessing bytes -
+	
+	size_t ByteRangeList::_findSegment(size_t & position) const
+	{
+		size_t index = 0;
+		for (const ByteRange & segment : _segments) {
+			if (position < segment.size()) {
+				break;
+			}
+			position -= segment.size();
+			index++;
+		}
+		return index;
+	}
+	
+	cc7::byte ByteRangeList::at(size_t index) const
+	{
+		if (index < _size) {
+			const size_t segment_index = _findSegment(index);
+			return _segments[segment_index][index];
+		}
+		return _ValueTypeExceptions::out_of_range();
+	}
+	
+	ByteRangeList ByteRangeList::subList(size_t from, size_t count) const
+	{
+		if (from > _size || count > _size - from) {
+			return _ByteRangeListExceptions::out_of_range();
+		}
+		ByteRangeList result;
+		result._size = count;
+		size_t offset = from;
+		size_t index = _findSegment(offset);
+		while (count > 0) {
+			const ByteRange & segment = _segments[index++];
+			const size_t available = std::min(count, segment.size() - offset);
+			result._segments.push_back(ByteRange(segment.data() + offset, available));
+			count  -= available;
+			offset  = 0;
+		}
+		return result;
+	}
+	
+	void ByteRangeList::removePrefix(size_t count)
+	{
+		if (count > _size) {
+			_ValueTypeExceptions::out_of_range();
+			return;
+		}
+		_size -= count;
+		size_t index = _findSegment(count);
+		if (index < _segments.size() && count > 0) {
+			_segments[index].removePrefix(count);
+		}
+		_segments.erase(_segments.begin(), _segments.begin() + index);
+	}
+	
+	void ByteRangeList::removeSuffix(size_t count)
+	{
+		if (count > _size) {
+			_ValueTypeExceptions::out_of_range();
+			return;
+		}
+		_size -= count;
+		while (count > 0) {
+			ByteRange & last = _segments.back();
+			if (count < last.size()) {
+				last.removeSuffix(count);
+				break;
+			}
+			count -= last.size();
+			_segments.pop_back();
+		}
+	}
+	
+	// MARK: Gather -
+	
+	size_t ByteRangeList::copyTo(void * out, size_t capacity) const
+	{
+		cc7::byte * out_ptr = static_cast<cc7::byte*>(out);
+		size_t copied = 0;
+		for (const ByteRange & segment : _segments) {
+			const size_t size = std::min(segment.size(), capacity - copied);
+			if (size == 0) {
+				break;
+			}
+			memcpy(out_ptr + copied, segment.data(), size);
+			copied += size;
+		}
+		return copied;
+	}
+	
+	void ByteRangeList::appendTo(ByteArray & out) const
+	{
+		// Segments may be captured from the output array, which can be reallocated
+		// by the resize. In this case, gather data into a temporary array first.
+		const cc7::byte * out_begin = out.data();
+		const cc7::byte * out_end   = out_begin + out.capacity();
+		for (const ByteRange & segment : _segments) {
+			if (segment.begin() < out_end && out_begin < segment.end()) {
+				ByteArray temporary(_size);
+				copyTo(temporary.data(), _size);
+				out.append(temporary.byteRange());
+				return;
+			}
+		}
+		// One allocation for the whole content
+		const size_t offset = out.size();
+		out.resize(offset + _size);
+		copyTo(out.data() + offset, _size);
+	}
+	
+	bool ByteRangeList::equals(const ByteRangeList & other) const
+	{
+		if (_size != other._size) {
+			return false;
+		}
+		// Compare the longest common chunks from both lists
+		auto it_a = _segments.begin(), it_b = other._segments.begin();
+		size_t off_a = 0, off_b = 0;
+		size_t remaining = _size;
+		while (remaining > 0) {
+			const size_t size = std::min(it_a->size() - off_a, it_b->size() - off_b);
+			if (memcmp(it_a->data() + off_a, it_b->data() + off_b, size) != 0) {
+				return false;
+			}
+			off_a += size;
+			off_b += size;
+			remaining -= size;
+			if (off_a == it_a->size()) {
+				++it_a;
+				off_a = 0;
+			}
+			if (off_b == it_b->size()) {
+				++it_b;
+				off_b = 0;
+			}
+		}
+		return true;
+	}
+	
+} // cc7
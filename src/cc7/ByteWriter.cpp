@@ -0,0 +1,281 @@
+/*
+ * Copyright 2016 Juraj Durech <durech.juraj@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cc7/ByteWriter.h>
+#include <algorithm>
+
+namespace cc7
+{
+	// MARK: Construction / Destruction -
+	
+	ByteWriter::ByteWriter(ByteArray & target, size_t reserve_size) :
+		_target(&target),
+		_base(target.size()),
+		_begin(nullptr),
+		_cur(nullptr),
+		_end(nullptr),
+		_error(false)
+	{
+		if (reserve_size > 0) {
+			_grow(reserve_size, true);
+		}
+	}
+	
+	ByteWriter::ByteWriter(void * buffer, size_t capacity) noexcept :
+		_target(nullptr),
+		_base(0),
+		_begin(static_cast<cc7::byte*>(buffer)),
+		_cur(static_cast<cc7::byte*>(buffer)),
+		_end(buffer ? static_cast<cc7::byte*>(buffer) + capacity : nullptr),
+		_error(false)
+	{
+	}
+	
+	ByteWriter::~ByteWriter()
+	{
+		finish();
+	}
+	
+	void ByteWriter::finish()
+	{
+		if (_target) {
+			// Shrinking doesn't reallocate, so all pointers are still valid.
+			_target->resize(_base + position());
+			_end = _cur;
+		}
+	}
+	
+	// MARK: Private methods -
+	
+	bool ByteWriter::_grow(size_t size, bool exact)
+	{
+		if (!_target || _error) {
+			_setError();
+			return false;
+		}
+		const size_t written  = position();
+		const size_t required = _base + written + size;
+		if (required < size) {
+			// size_t overflow
+			_setError();
+			return false;
+		}
+		if (required > _target->capacity()) {
+			// The exponential growth is applied only for regular writes. The explicit
+			// reservation allocates exactly the requested size.
+			_target->reserve(exact ? required : std::max(required, _target->capacity() * 2));
+		}
+		// Use the whole capacity, so the next writes don't need to grow the array.
+		_target->resize(_target->capacity());
+		_begin = _target->data() + _base;
+		_cur   = _begin + written;
+		_end   = _target->data() + _target->size();
+		return true;
+	}
+	
+	bool ByteWriter::_reserve(size_t size, const cc7::byte * & source)
+	{
+		if (size_t(_end - _cur) >= size) {
+			return true;
+		}
+		// The source may be captured from the target array, which is reallocated
+		// by the growth, so only its offset is kept.
+		const cc7::byte * target = _target ? _target->data() : nullptr;
+		const bool is_own_memory = target && source >= target && source < target + _target->capacity();
+		const size_t offset = is_own_memory ? source - target : 0;
+		if (!_grow(size, false)) {
+			return false;
+		}
+		if (is_own_memory) {
+			source = _target->data() + offset;
+		}
+		return true;
+	}
+	
+	void ByteWriter::_writeBytesWithGrow(const void * ptr, size_t size)
+	{
+		const cc7::byte * source = static_cast<const cc7::byte*>(ptr);
+		if (_reserve(size, source)) {
+			memcpy(_cur, source, size);
+			_cur += size;
+		}
+	}
+	
+	void ByteWriter::_setError()
+	{
+		_error = true;
+		// No more writes, the array target is not allowed to grow in the error state.
+		_end = _cur;
+	}
+	
+	// MARK: Varint -
+	
+	void ByteWriter::writeVarint(U64 n)
+	{
+		cc7::byte buffer[10];
+		size_t size = 0;
+		while (n >= 0x80) {
+			buffer[size++] = cc7::byte(n) | 0x80;
+			n >>= 7;
+		}
+		buffer[size++] = cc7::byte(n);
+		writeBytes(buffer, size);
+	}
+	
+	void ByteWriter::writeSignedVarint(int64_t n)
+	{
+		cc7::byte buffer[10];
+		size_t size = 0;
+		while (true) {
+			const cc7::byte b = cc7::byte(n) & 0x7F;
+			// Arithmetic shift keeps the sign
+			n >>= 7;
+			if ((n == 0 && (b & 0x40) == 0) || (n == -1 && (b & 0x40) != 0)) {
+				buffer[size++] = b;
+				break;
+			}
+			buffer[size++] = b | 0x80;
+		}
+		writeBytes(buffer, size);
+	}
+	
+	size_t ByteWriter::VarintSize(U64 n)
+	{
+		size_t size = 1;
+		while (n >= 0x80) {
+			n >>= 7;
+			size++;
+		}
+		return size;
+	}
+	
+	size_t ByteWriter::SignedVarintSize(int64_t n)
+	{
+		size_t size = 1;
+		while (n >= 0x40 || n < -0x40) {
+			n >>= 7;
+			size++;
+		}
+		return size;
+	}
+	
+	// MARK: Ranges & placeholders -
+	
+	void ByteWriter::writeRange(const ByteRange & range, ByteReader::LengthPrefix prefix)
+	{
+		const size_t length = range.size();
+		// Reserve space for the longest prefix and the range at once, so the prefix
+		// cannot reallocate the target array, if the range is captured from it.
+		const cc7::byte * source = range.data();
+		if (!_reserve(length + 10, source)) {
+			return;
+		}
+		switch (prefix) {
+			case ByteReader::U8_Length:
+				if (length > 0xFF) { _setError(); return; }
+				writeU8(U8(length));
+				break;
+			case ByteReader::U16BE_Length:
+			case ByteReader::U16LE_Length:
+				if (length > 0xFFFF) { _setError(); return; }
+				prefix == ByteReader::U16BE_Length ? writeU16BE(U16(length)) : writeU16LE(U16(length));
+				break;
+			case ByteReader::U32BE_Length:
+			case ByteReader::U32LE_Length:
+				if (U64(length) > 0xFFFFFFFFULL) { _setError(); return; }
+				prefix == ByteReader::U32BE_Length ? writeU32BE(U32(length)) : writeU32LE(U32(length));
+				break;
+			case ByteReader::Varint_Length:
+				writeVarint(length);
+				break;
+			default:
+				_setError();
+				return;
+		}
+		writeBytes(source, length);
+	}
+	
+	size_t ByteWriter::writePlaceholder(size_t size)
+	{
+		if (size_t(_end - _cur) >= size || _grow(size, false)) {
+			const size_t result = position();
+			if (size > 0) {
+				memset(_cur, 0, size);
+				_cur += size;
+			}
+			return result;
+		}
+		return ByteRange::npos;
+	}
+	
+	// MARK: Arrays -
+	
+	/*
+	 Writes |count| integers from |in| in required byte order. The integers are converted
+	 in small chunks on stack, because the position in the writer is not aligned.
+	 The space for all integers must be already reserved.
+	 */
+	template <typename T>
+	static void _WriteArray(ByteWriter & writer, const T * in, size_t count, bool big_endian)
+	{
+		T chunk[64];
+		while (count > 0) {
+			const size_t chunk_count = std::min(count, sizeof(chunk) / sizeof(T));
+			if (big_endian) {
+				ToBigEndian(in, chunk, chunk_count);
+			} else {
+				ToLittleEndian(in, chunk, chunk_count);
+			}
+			writer.writeBytes(chunk, chunk_count * sizeof(T));
+			in    += chunk_count;
+			count -= chunk_count;
+		}
+	}
+	
+	void ByteWriter::_writeArray(const U16 * in, size_t count, bool big_endian)
+	{
+		if (count > ByteRange::npos / sizeof(U16)) {
+			_setError();
+			return;
+		}
+		if (_reserve(count * sizeof(U16))) {
+			_WriteArray(*this, in, count, big_endian);
+		}
+	}
+	
+	void ByteWriter::_writeArray(const U32 * in, size_t count, bool big_endian)
+	{
+		if (count > ByteRange::npos / sizeof(U32)) {
+			_setError();
+			return;
+		}
+		if (_reserve(count * sizeof(U32))) {
+			_WriteArray(*this, in, count, big_endian);
+		}
+	}
+	
+	void ByteWriter::_writeArray(const U64 * in, size_t count, bool big_endian)
+	{
+		if (count > ByteRange::npos / sizeof(U64)) {
+			_setError();
+			return;
+		}
+		if (_reserve(count * sizeof(U64))) {
+			_WriteArray(*this, in, count, big_endian);
+		}
+	}
+	
+} // cc7
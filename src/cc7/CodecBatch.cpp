@@ -0,0 +1,258 @@
+/**
+ * Copyright 2018 Wultra s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cc7/CodecBatch.h>
+
+namespace cc7
+{
+	// MARK: Common -
+	
+	/*
+	 Encodes all |items| into |out_string|. The |length_fn| returns exact length of encoded
+	 item and the |encode_fn| encodes one item into the provided buffer.
+	 */
+	template <typename LengthFn, typename EncodeFn>
+	static bool _EncodeBatch(const std::vector<ByteRange> & items, std::string & out_string, std::vector<size_t> & out_offsets,
+							 LengthFn length_fn, EncodeFn encode_fn)
+	{
+		// Calculate the final layout, so the output string is allocated only once.
+		const size_t count = items.size();
+		out_offsets.resize(count + 1);
+		size_t total = 0;
+		for (size_t i = 0; i < count; i++) {
+			out_offsets[i] = total;
+			total += length_fn(items[i].size());
+		}
+		out_offsets[count] = total;
+		out_string.resize(total);
+		if (total > 0) {
+			encode_fn(&out_string[0]);
+		}
+		return true;
+	}
+	
+	/*
+	 Returns true if any string from |strings| is captured from the |out_data| array.
+	 */
+	static bool _IsCapturedFrom(const std::vector<ByteRange> & strings, const ByteArray & out_data)
+	{
+		const byte * out_begin = out_data.data();
+		const byte * out_end   = out_begin + out_data.capacity();
+		for (const ByteRange & string : strings) {
+			if (!string.empty() && string.begin() < out_end && out_begin < string.end()) {
+				return true;
+			}
+		}
+		return false;
+	}
+	
+	/*
+	 Decodes all |strings| into |out_data|. The |max_length_fn| returns maximum number
+	 of bytes decoded from the string and the |decode_fn| decodes one string into the
+	 provided buffer and returns number of produced bytes, or ByteRange::npos.
+	 */
+	template <typename MaxLengthFn, typename DecodeFn>
+	static bool _DecodeBatch(const std::vector<ByteRange> & strings, ByteArray & out_data, std::vector<size_t> & out_offsets,
+							 MaxLengthFn max_length_fn, DecodeFn decode_fn)
+	{
+		// The input strings may be captured from the output array. In this case,
+		// decode data into a temporary array, to do not overwrite the input.
+		if (_IsCapturedFrom(strings, out_data)) {
+			ByteArray temporary;
+			bool result = _DecodeBatch(strings, temporary, out_offsets, max_length_fn, decode_fn);
+			out_data.swap(temporary);
+			return result;
+		}
+		// Bytes are written directly to the array's buffer, so the array is resized
+		// to the worst case length and then truncated to the final one.
+		size_t max_total = 0;
+		for (const ByteRange & string : strings) {
+			max_total += max_length_fn(string.size());
+		}
+		out_data.clear();
+		out_data.resize(max_total);
+		out_offsets.resize(strings.size() + 1);
+		
+		size_t offset = decode_fn(out_data.data(), max_total, out_offsets.data());
+		if (offset == ByteRange::npos) {
+			out_data.clear();
+			out_offsets.clear();
+			return false;
+		}
+		out_offsets[strings.size()] = offset;
+		out_data.resize(offset);
+		return true;
+	}
+	
+	/*
+	 Decodes |strings| one by one, with |decode_fn| decoding a single string. Returns total
+	 number of produced bytes, or ByteRange::npos if any string is invalid.
+	 */
+	template <typename DecodeFn>
+	static size_t _DecodeItems(const std::vector<ByteRange> & strings, byte * out, size_t out_capacity, size_t * offsets,
+							   DecodeFn decode_fn)
+	{
+		size_t offset = 0;
+		for (size_t i = 0; i < strings.size(); i++) {
+			offsets[i] = offset;
+			size_t produced = decode_fn(strings[i], out + offset, out_capacity - offset);
+			if (produced == ByteRange::npos) {
+				return ByteRange::npos;
+			}
+			offset += produced;
+		}
+		return offset;
+	}
+	
+	
+	// MARK: Hexadecimal -
+	
+	/// Size of the buffer, where the short items are gathered before they're processed
+	/// by the vectorized codec.
+	static const size_t s_gather_buffer_size = 1024;
+	
+	bool HexString_EncodeBatch(const std::vector<ByteRange> & items, bool use_lowercase,
+							   std::string & out_string, std::vector<size_t> & out_offsets)
+	{
+		return _EncodeBatch(items, out_string, out_offsets, HexString_EncodedLength, [&](char * out) {
+			// The hexadecimal string of concatenated items is equal to the concatenation
+			// of the item's strings, so the short items are gathered into one buffer and
+			// encoded at once. This keeps the vectorized encoder busy, even for items
+			// shorter than its vector size.
+			byte buffer[s_gather_buffer_size];
+			size_t buffer_size = 0;
+			auto encode = [&](const ByteRange & range) {
+				out += HexString_EncodeTo(range, out, HexString_EncodedLength(range.size()), use_lowercase);
+			};
+			for (const ByteRange & item : items) {
+				if (buffer_size + item.size() > sizeof(buffer)) {
+					encode(ByteRange(buffer, buffer_size));
+					buffer_size = 0;
+					if (item.size() > sizeof(buffer)) {
+						encode(item);
+						continue;
+					}
+				}
+				if (!item.empty()) {
+					memcpy(buffer + buffer_size, item.data(), item.size());
+					buffer_size += item.size();
+				}
+			}
+			encode(ByteRange(buffer, buffer_size));
+			CC7_SecureClean(buffer, sizeof(buffer));
+		});
+	}
+	
+	bool HexString_DecodeBatch(const std::vector<ByteRange> & strings,
+							   ByteArray & out_data, std::vector<size_t> & out_offsets)
+	{
+		return _DecodeBatch(strings, out_data, out_offsets, HexString_DecodedLength, [&](byte * out, size_t, size_t * offsets) -> size_t {
+			// Like in the encoder, strings with even length are gathered into one buffer
+			// and decoded at once. The string with odd length has a special meaning of
+			// the first character, so it has to be decoded alone.
+			byte buffer[s_gather_buffer_size];
+			size_t buffer_size = 0;
+			size_t offset = 0;
+			bool result = true;
+			auto decode = [&](const ByteRange & range) {
+				const size_t length = HexString_DecodedLength(range.size());
+				result = result && HexString_DecodeTo(range, out, length) != ByteRange::npos;
+				out += length;
+			};
+			for (size_t i = 0; i < strings.size(); i++) {
+				const ByteRange & string = strings[i];
+				offsets[i] = offset;
+				offset += HexString_DecodedLength(string.size());
+				const bool alone = (string.size() & 1) || string.size() > sizeof(buffer);
+				if (alone || buffer_size + string.size() > sizeof(buffer)) {
+					decode(ByteRange(buffer, buffer_size));
+					buffer_size = 0;
+					if (alone) {
+						decode(string);
+						continue;
+					}
+				}
+				if (!string.empty()) {
+					memcpy(buffer + buffer_size, string.data(), string.size());
+					buffer_size += string.size();
+				}
+			}
+			decode(ByteRange(buffer, buffer_size));
+			CC7_SecureClean(buffer, sizeof(buffer));
+			return result ? offset : ByteRange::npos;
+		});
+	}
+	
+	
+	// MARK: Base64 -
+	
+	bool Base64_EncodeBatch(const std::vector<ByteRange> & items,
+							std::string & out_string, std::vector<size_t> & out_offsets,
+							Base64_Variant variant)
+	{
+		auto length_fn = [variant](size_t size) {
+			return Base64_EncodedLength(size, 0, variant);
+		};
+		return _EncodeBatch(items, out_string, out_offsets, length_fn, [&](char * out) {
+			for (size_t i = 0; i < items.size(); i++) {
+				Base64_EncodeTo(items[i], 0, out + out_offsets[i], out_offsets[i + 1] - out_offsets[i], variant);
+			}
+		});
+	}
+	
+	bool Base64_DecodeBatch(const std::vector<ByteRange> & strings,
+							ByteArray & out_data, std::vector<size_t> & out_offsets,
+							Base64_Variant variant)
+	{
+		auto max_length_fn = [variant](size_t size) {
+			return Base64_DecodedMaxLength(size, variant);
+		};
+		return _DecodeBatch(strings, out_data, out_offsets, max_length_fn, [&](byte * out, size_t out_capacity, size_t * offsets) {
+			return _DecodeItems(strings, out, out_capacity, offsets, [variant](const ByteRange & string, byte * item_out, size_t item_capacity) {
+				return Base64_DecodeTo(string, 0, item_out, item_capacity, variant);
+			});
+		});
+	}
+	
+	
+	// MARK: Base32 -
+	
+	bool Base32_EncodeBatch(const std::vector<ByteRange> & items, bool use_padding,
+							std::string & out_string, std::vector<size_t> & out_offsets,
+							Base32_Alphabet alphabet)
+	{
+		auto length_fn = [use_padding](size_t size) {
+			return Base32_EncodedLength(size, use_padding);
+		};
+		return _EncodeBatch(items, out_string, out_offsets, length_fn, [&](char * out) {
+			for (size_t i = 0; i < items.size(); i++) {
+				Base32_EncodeTo(items[i], use_padding, out + out_offsets[i], out_offsets[i + 1] - out_offsets[i], alphabet);
+			}
+		});
+	}
+	
+	bool Base32_DecodeBatch(const std::vector<ByteRange> & strings, bool require_padding,
+							ByteArray & out_data, std::vector<size_t> & out_offsets,
+							Base32_Alphabet alphabet)
+	{
+		return _DecodeBatch(strings, out_data, out_offsets, Base32_DecodedMaxLength, [&](byte * out, size_t out_capacity, size_t * offsets) {
+			return _DecodeItems(strings, out, out_capacity, offsets, [=](const ByteRange & string, byte * item_out, size_t item_capacity) {
+				return Base32_DecodeTo(string, require_padding, item_out, item_capacity, alphabet);
+			});
+		});
+	}
+	
+} // cc7
@@ -0,0 +1,188 @@
+/**
+ * Copyright 2018 Wultra s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cc7/CpuFeatures.h>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+	#define CC7_CPU_X86
+	#if defined(_MSC_VER)
+		#include <intrin.h>
+	#else
+		#include <cpuid.h>
+	#endif
+#elif defined(__arm__) && (defined(__linux__) || defined(__ANDROID__))
+	#define CC7_CPU_ARM_LINUX
+	#include <sys/auxv.h>
+#endif
+
+namespace cc7
+{
+namespace cpu
+{
+#if defined(CC7_CPU_X86)
+	
+	// MARK: x86 -
+	
+	/*
+	 Executes CPUID instruction for the |leaf| and |subleaf| and stores EAX, EBX, ECX
+	 and EDX registers to |regs|. Returns false if the leaf is not supported.
+	 */
+	static bool _Cpuid(U32 leaf, U32 subleaf, U32 regs[4])
+	{
+	#if defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 0);
+		if ((U32)info[0] < leaf) {
+			return false;
+		}
+		__cpuidex(info, (int)leaf, (int)subleaf);
+		for (size_t i = 0; i < 4; i++) {
+			regs[i] = (U32)info[i];
+		}
+		return true;
+	#else
+		if (__get_cpuid_max(0, nullptr) < leaf) {
+			return false;
+		}
+		__cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+		return true;
+	#endif
+	}
+	
+	/*
+	 Returns content of the XCR0 register, which contains state components
+	 enabled by the operating system.
+	 */
+	static U64 _Xgetbv()
+	{
+	#if defined(_MSC_VER)
+		return _xgetbv(0);
+	#else
+		U32 eax, edx;
+		__asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+		return ((U64)edx << 32) | eax;
+	#endif
+	}
+	
+	static U32 _DetectFeatures()
+	{
+		U32 features = 0;
+		U32 regs[4];
+		if (!_Cpuid(1, 0, regs)) {
+			return features;
+		}
+		const U32 ecx1 = regs[2];
+		const U32 edx1 = regs[3];
+		if (edx1 & (1 << 26)) features |= SSE2;
+		if (ecx1 & (1 << 9))  features |= SSSE3;
+		if (ecx1 & (1 << 19)) features |= SSE41;
+		if (ecx1 & (1 << 20)) features |= SSE42;
+		
+		// AVX registers must be preserved by the operating system.
+		const bool os_xsave = (ecx1 & (1 << 27)) != 0;
+		const U64 xcr0      = os_xsave ? _Xgetbv() : 0;
+		const bool os_avx    = (xcr0 & 0x06) == 0x06;		// XMM & YMM state
+		const bool os_avx512 = (xcr0 & 0xe6) == 0xe6;		// XMM, YMM, opmask & ZMM state
+		if (os_avx && (ecx1 & (1 << 28))) {
+			features |= AVX;
+		}
+		if (_Cpuid(7, 0, regs)) {
+			const U32 ebx7 = regs[1];
+			const U32 ecx7 = regs[2];
+			if (ebx7 & (1 << 8)) features |= BMI2;
+			if (os_avx && (features & AVX) && (ebx7 & (1 << 5))) {
+				features |= AVX2;
+			}
+			if (os_avx512 && (ebx7 & (1 << 16))) {
+				features |= AVX512F;
+				if (ebx7 & (1 << 30)) features |= AVX512BW;
+				if (ecx7 & (1 << 1))  features |= AVX512VBMI;
+			}
+		}
+		return features;
+	}
+	
+#elif defined(__aarch64__) || defined(_M_ARM64)
+	
+	// MARK: ARM64 -
+	
+	static U32 _DetectFeatures()
+	{
+		// NEON is a mandatory part of ARMv8-A
+		return NEON;
+	}
+	
+#elif defined(CC7_CPU_ARM_LINUX)
+	
+	// MARK: ARM -
+	
+	static U32 _DetectFeatures()
+	{
+		// NEON is optional on ARMv7, so the kernel's HWCAP has to be checked.
+		const unsigned long hwcap_neon = 1 << 12;
+		return (getauxval(AT_HWCAP) & hwcap_neon) ? NEON : 0;
+	}
+	
+#else
+	
+	// MARK: Other -
+	
+	static U32 _DetectFeatures()
+	{
+	#if defined(__ARM_NEON)
+		// NEON is enabled at compile time
+		return NEON;
+	#else
+		return 0;
+	#endif
+	}
+	
+#endif
+	
+	// MARK: Public interface -
+	
+	U32 GetFeatures()
+	{
+		// C++11 guarantees thread safe initialization of the local static variable.
+		static const U32 s_features = _DetectFeatures();
+		return s_features;
+	}
+	
+	std::string FeaturesToString(U32 features)
+	{
+		static const struct {
+			U32				feature;
+			const char *	name;
+		} s_names[] = {
+			{ SSE2, "sse2" }, { SSSE3, "ssse3" }, { SSE41, "sse4.1" }, { SSE42, "sse4.2" },
+			{ AVX, "avx" }, { AVX2, "avx2" }, { BMI2, "bmi2" },
+			{ AVX512F, "avx512f" }, { AVX512BW, "avx512bw" }, { AVX512VBMI, "avx512vbmi" },
+			{ NEON, "neon" },
+		};
+		std::string result;
+		for (const auto & item : s_names) {
+			if (features & item.feature) {
+				if (!result.empty()) {
+					result.push_back(',');
+				}
+				result.append(item.name);
+			}
+		}
+		return result;
+	}
+	
+} // cc7::cpu
+} // cc7
@@ -15,6 +15,8 @@
  */
 
 #include <cc7/DebugFeatures.h>
+#include <stdarg.h>
+#include <stdio.h>
 
 namespace cc7
 {
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2016 Juraj Durech <durech.juraj@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cc7/Endian.h>
+#include "EndianSimd.h"
+
+namespace cc7
+{
+namespace detail
+{
+	/*
+	 Swaps byte order of |count| elements. The vectorized kernel for the element
+	 size, selected by |kernel_index|, processes the most of the array.
+	 */
+	template <typename T>
+	static void _SwapArray(const T * in, T * out, size_t count, int kernel_index)
+	{
+		const Endian_Kernels & kernels = Endian_GetKernels();
+		if (kernels.swap[kernel_index] && count > 0) {
+			const size_t processed = kernels.swap[kernel_index](reinterpret_cast<const cc7::byte*>(in), count * sizeof(T), reinterpret_cast<cc7::byte*>(out)) / sizeof(T);
+			in    += processed;
+			out   += processed;
+			count -= processed;
+		}
+		while (count > 0) {
+			*out++ = SwapEndian(*in++);
+			count--;
+		}
+	}
+	
+	void SwapEndianArray(const cc7::U16 * in, cc7::U16 * out, size_t count)
+	{
+		_SwapArray(in, out, count, 0);
+	}
+	
+	void SwapEndianArray(const cc7::U32 * in, cc7::U32 * out, size_t count)
+	{
+		_SwapArray(in, out, count, 1);
+	}
+	
+	void SwapEndianArray(const cc7::U64 * in, cc7::U64 * out, size_t count)
+	{
+		_SwapArray(in, out, count, 2);
+	}
+
+} // cc7::detail
+} // cc7
@@ -0,0 +1,149 @@
+/*
+ * Copyright 2016 Juraj Durech <durech.juraj@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "EndianSimd.h"
+
+#if defined(CC7_SIMD_X86)
+	#include <immintrin.h>
+#elif defined(CC7_SIMD_NEON)
+	#include <arm_neon.h>
+#endif
+
+namespace cc7
+{
+namespace detail
+{
+	// -----------------------------------------------------------------
+	// Vectorized byte order swap
+	//
+	// On x86, each vector is permuted with one byte shuffle, where the mask
+	// reverses bytes within every element. NEON has dedicated instructions
+	// for all element sizes.
+	// -----------------------------------------------------------------
+
+#if defined(CC7_SIMD_X86)
+	
+	// Shuffle masks for 2, 4 and 8 byte elements
+	static const cc7::byte s_swap_masks[3][16] =
+	{
+		{ 1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14 },
+		{ 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12 },
+		{ 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8 },
+	};
+	
+	// MARK: SSSE3 -
+	
+	template <int Index>
+	CC7_TARGET_SSSE3 static size_t _Swap_SSSE3(const cc7::byte * in, size_t in_len, cc7::byte * out)
+	{
+		const __m128i mask = _mm_loadu_si128((const __m128i*)s_swap_masks[Index]);
+		size_t processed = 0;
+		while (in_len - processed >= 32) {
+			const __m128i v0 = _mm_loadu_si128((const __m128i*)(in + processed));
+			const __m128i v1 = _mm_loadu_si128((const __m128i*)(in + processed + 16));
+			_mm_storeu_si128((__m128i*)(out + processed),      _mm_shuffle_epi8(v0, mask));
+			_mm_storeu_si128((__m128i*)(out + processed + 16), _mm_shuffle_epi8(v1, mask));
+			processed += 32;
+		}
+		if (in_len - processed >= 16) {
+			const __m128i v = _mm_loadu_si128((const __m128i*)(in + processed));
+			_mm_storeu_si128((__m128i*)(out + processed), _mm_shuffle_epi8(v, mask));
+			processed += 16;
+		}
+		return processed;
+	}
+	
+	// MARK: AVX2 -
+	
+	template <int Index>
+	CC7_TARGET_AVX2 static size_t _Swap_AVX2(const cc7::byte * in, size_t in_len, cc7::byte * out)
+	{
+		// Shuffle works within 128 bit lanes, so the same mask is used in both lanes.
+		const __m256i mask = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)s_swap_masks[Index]));
+		size_t processed = 0;
+		while (in_len - processed >= 64) {
+			const __m256i v0 = _mm256_loadu_si256((const __m256i*)(in + processed));
+			const __m256i v1 = _mm256_loadu_si256((const __m256i*)(in + processed + 32));
+			_mm256_storeu_si256((__m256i*)(out + processed),      _mm256_shuffle_epi8(v0, mask));
+			_mm256_storeu_si256((__m256i*)(out + processed + 32), _mm256_shuffle_epi8(v1, mask));
+			processed += 64;
+		}
+		if (in_len - processed >= 32) {
+			const __m256i v = _mm256_loadu_si256((const __m256i*)(in + processed));
+			_mm256_storeu_si256((__m256i*)(out + processed), _mm256_shuffle_epi8(v, mask));
+			processed += 32;
+		}
+		if (in_len - processed >= 16) {
+			const __m128i v = _mm_loadu_si128((const __m128i*)(in + processed));
+			_mm_storeu_si128((__m128i*)(out + processed), _mm_shuffle_epi8(v, _mm256_castsi256_si128(mask)));
+			processed += 16;
+		}
+		return processed;
+	}
+
+#endif // defined(CC7_SIMD_X86)
+
+#if defined(CC7_SIMD_NEON)
+	
+	// MARK: NEON -
+	
+	static inline uint8x16_t _Reverse_NEON(uint8x16_t v, int index)
+	{
+		return index == 0 ? vrev16q_u8(v) : (index == 1 ? vrev32q_u8(v) : vrev64q_u8(v));
+	}
+	
+	template <int Index>
+	static size_t _Swap_NEON(const cc7::byte * in, size_t in_len, cc7::byte * out)
+	{
+		size_t processed = 0;
+		while (in_len - processed >= 32) {
+			const uint8x16_t v0 = vld1q_u8(in + processed);
+			const uint8x16_t v1 = vld1q_u8(in + processed + 16);
+			vst1q_u8(out + processed,      _Reverse_NEON(v0, Index));
+			vst1q_u8(out + processed + 16, _Reverse_NEON(v1, Index));
+			processed += 32;
+		}
+		if (in_len - processed >= 16) {
+			vst1q_u8(out + processed, _Reverse_NEON(vld1q_u8(in + processed), Index));
+			processed += 16;
+		}
+		return processed;
+	}
+
+#endif // defined(CC7_SIMD_NEON)
+	
+	
+	// MARK: Kernel selection -
+	
+	const Endian_Kernels & Endian_GetKernels()
+	{
+		// Candidates are ordered from the most preferred one.
+		static const cpu::Candidate<Endian_Kernels> s_candidates[] =
+		{
+#if defined(CC7_SIMD_X86)
+			{ cpu::AVX2,	{ { _Swap_AVX2<0>,  _Swap_AVX2<1>,  _Swap_AVX2<2>  }, "avx2"  } },
+			{ cpu::SSSE3,	{ { _Swap_SSSE3<0>, _Swap_SSSE3<1>, _Swap_SSSE3<2> }, "ssse3" } },
+#elif defined(CC7_SIMD_NEON)
+			{ cpu::NEON,	{ { _Swap_NEON<0>,  _Swap_NEON<1>,  _Swap_NEON<2>  }, "neon"  } },
+#endif
+			{ 0,			{ { nullptr, nullptr, nullptr }, "scalar" } },
+		};
+		// C++11 guarantees thread safe initialization of the local static variable.
+		static const Endian_Kernels & s_kernels = cpu::Select(s_candidates);
+		return s_kernels;
+	}
+
+} // cc7::detail
+} // cc7
@@ -0,0 +1,55 @@
+/*
+ * Copyright 2016 Juraj Durech <durech.juraj@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "Simd.h"
+
+//
+// Private header, shared between Endian.cpp and EndianSimd.cpp.
+//
+
+namespace cc7
+{
+namespace detail
+{
+	/**
+	 Swap kernel reverses the byte order of as many elements from |in| as possible
+	 and writes them to |out|. The |in| and |out| may point to the same buffer.
+	 The |in_len| is in bytes and must be a multiple of the element size. Returns
+	 number of processed bytes. The caller is responsible to process the rest
+	 of the input.
+	 */
+	typedef size_t (*Endian_SwapKernel)(const cc7::byte * in, size_t in_len, cc7::byte * out);
+	
+	/**
+	 The Endian_Kernels structure contains kernels selected for the current CPU.
+	 The swap table is indexed by 0 for U16, 1 for U32 and 2 for U64 elements.
+	 All pointers are nullptr when there's no vectorized implementation available.
+	 */
+	struct Endian_Kernels
+	{
+		Endian_SwapKernel	swap[3];
+		const char *		name;
+	};
+	
+	/**
+	 Returns kernels selected for the current CPU. The selection is performed only once,
+	 at the first call, and the function is thread safe.
+	 */
+	const Endian_Kernels & Endian_GetKernels();
+
+} // cc7::detail
+} // cc7
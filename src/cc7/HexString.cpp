@@ -15,6 +15,7 @@
  */
 
 #include <cc7/HexString.h>
+#include "HexStringSimd.h"
 
 namespace cc7
 {
@@ -23,87 +24,144 @@ namespace cc7
 	static const char s_hex_table_uc[16] = { '0','1','2','3','4','5','6','7','8','9','A','B','C','D','E','F' };
 	static const char s_hex_table_lc[16] = { '0','1','2','3','4','5','6','7','8','9','a','b','c','d','e','f' };
 	
-	bool HexString_Encode(const ByteRange & in_data, bool use_lowercase, std::string & out_string)
+	/*
+	 Encodes |in_len| bytes into |out|, which must have space for 2 * |in_len| characters.
+	 */
+	static void _Encode(const byte * in, size_t in_len, bool use_lowercase, char * out)
 	{
+		const detail::HexString_Kernels & kernels = detail::HexString_GetKernels();
+		if (kernels.encode[use_lowercase]) {
+			size_t processed = kernels.encode[use_lowercase](in, in_len, out);
+			in     += processed;
+			in_len -= processed;
+			out    += processed << 1;
+		}
 		const char * table = use_lowercase ? s_hex_table_lc : s_hex_table_uc;
-		
-		out_string.clear();
-		out_string.reserve(in_data.size() << 1);
-		auto data_it  = in_data.cbegin();
-		auto data_end = in_data.cend();
-		byte val;
-		while (data_it != data_end) {
-			val = *data_it;
-			out_string.push_back(table[val >> 4]);
-			out_string.push_back(table[val & 15]);
-			data_it++;
+		while (in_len > 0) {
+			const byte val = *in++;
+			out[0] = table[val >> 4];
+			out[1] = table[val & 15];
+			out += 2;
+			in_len--;
+		}
+	}
+	
+	bool HexString_Encode(const ByteRange & in_data, bool use_lowercase, std::string & out_string)
+	{
+		out_string.resize(HexString_EncodedLength(in_data.size()));
+		if (!in_data.empty()) {
+			_Encode(in_data.data(), in_data.size(), use_lowercase, &out_string[0]);
 		}
 		return true;
 	}
 	
+	size_t HexString_EncodeTo(const ByteRange & in_data, char * out, size_t out_capacity, bool use_lowercase)
+	{
+		const size_t length = HexString_EncodedLength(in_data.size());
+		if (out_capacity < length) {
+			return ByteRange::npos;
+		}
+		_Encode(in_data.data(), in_data.size(), use_lowercase, out);
+		return length;
+	}
+	
 	// MARK: Decoder -
 	
-	bool HexString_Decode(const std::string & in_string, ByteArray & out_data)
+	// Values for all hexadecimal characters, 0xff for invalid characters.
+	static const byte s_hex_dec_table[256] =
 	{
-		size_t str_len = in_string.length();
-		
-		// Reserve buffer for data
-		out_data.clear();
-		out_data.reserve((str_len >> 1) + (str_len & 1));
-		
-		const char * str_p = in_string.c_str();
-		char lc, uc;
-		byte lv, uv;
-		if (str_len & 1) {
-			// odd number of hexadecimal characters
-			lc = *str_p++;
-			if (lc >= '0' && lc <= '9') {
-				lv = lc - '0';
-			} else if (lc >= 'A' && lc <= 'F') {
-				lv = lc - 'A' + 10;
-			} else if (lc >= 'a' && lc <= 'f') {
-				lv = lc - 'a' + 10;
-			} else {
-				// failure
-				out_data.clear();
-				return false;
-			}
-			out_data.push_back(lv);
-			str_len--;
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff
+	};
+	
+	/*
+	 Decodes |in_len| characters into |out|. The |in_len| must be even.
+	 The scalar loop has no branches depending on the data. The invalid
+	 characters are accumulated and checked only once, at the end.
+	 */
+	static bool _DecodePairs(const byte * in, size_t in_len, byte * out)
+	{
+		const detail::HexString_Kernels & kernels = detail::HexString_GetKernels();
+		if (kernels.decode) {
+			size_t processed = kernels.decode(in, in_len, out);
+			in     += processed;
+			in_len -= processed;
+			out    += processed >> 1;
+		}
+		byte invalid = 0;
+		while (in_len >= 2) {
+			const byte uv = s_hex_dec_table[in[0]];
+			const byte lv = s_hex_dec_table[in[1]];
+			invalid |= uv | lv;
+			*out++ = (uv << 4) | (lv & 15);
+			in     += 2;
+			in_len -= 2;
+		}
+		return (invalid & 0xF0) == 0;
+	}
+	
+	/*
+	 Decodes |in_len| characters into |out|, which must have space for
+	 HexString_DecodedLength() bytes.
+	 */
+	static bool _Decode(const byte * in, size_t in_len, byte * out)
+	{
+		byte invalid = 0;
+		if (in_len & 1) {
+			// odd number of hexadecimal characters, the first one
+			// is decoded as a whole byte
+			invalid = s_hex_dec_table[*in++];
+			*out++ = invalid;
+			in_len--;
+		}
+		return ((invalid & 0xF0) == 0) && _DecodePairs(in, in_len, out);
+	}
+	
+	bool HexString_Decode(const ByteRange & in_string, ByteArray & out_data)
+	{
+		// The input string may be captured from the output array. In this case,
+		// decode data into a temporary array, to do not overwrite the input.
+		const byte * out_begin = out_data.data();
+		const byte * out_end   = out_begin + out_data.capacity();
+		if (!in_string.empty() && in_string.begin() < out_end && out_begin < in_string.end()) {
+			ByteArray temporary;
+			bool result = HexString_Decode(in_string, temporary);
+			out_data.swap(temporary);
+			return result;
 		}
 		
-		while (str_len >= 2) {
-			uc = str_p[0];
-			if (uc >= '0' && uc <= '9') {
-				uv = uc - '0';
-			} else if (uc >= 'A' && uc <= 'F') {
-				uv = uc - 'A' + 10;
-			} else if (uc >= 'a' && uc <= 'f') {
-				uv = uc - 'a' + 10;
-			} else {
-				// failure
-				out_data.clear();
-				return false;
-			}
-			
-			lc = str_p[1];
-			if (lc >= '0' && lc <= '9') {
-				lv = lc - '0';
-			} else if (lc >= 'A' && lc <= 'F') {
-				lv = lc - 'A' + 10;
-			} else if (lc >= 'a' && lc <= 'f') {
-				lv = lc - 'a' + 10;
-			} else {
-				// failure
-				out_data.clear();
-				return false;
-			}
-			out_data.push_back((uv << 4) | lv);
-			str_p	+= 2;
-			str_len -= 2;
+		out_data.clear();
+		out_data.resize(HexString_DecodedLength(in_string.size()));
+		if (!_Decode(in_string.data(), in_string.size(), out_data.data())) {
+			// failure
+			out_data.clear();
+			return false;
 		}
 		// success
 		return true;
 	}
-
+	
+	size_t HexString_DecodeTo(const ByteRange & in_string, cc7::byte * out, size_t out_capacity)
+	{
+		const size_t length = HexString_DecodedLength(in_string.size());
+		if (out_capacity < length || !_Decode(in_string.data(), in_string.size(), out)) {
+			return ByteRange::npos;
+		}
+		return length;
+	}
+	
 }
\ No newline at end of file
@@ -0,0 +1,233 @@
+/*
+ * Copyright 2016 Juraj Durech <durech.juraj@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "HexStringSimd.h"
+
+#if defined(CC7_SIMD_X86)
+	#include <immintrin.h>
+#elif defined(CC7_SIMD_NEON)
+	#include <arm_neon.h>
+#endif
+
+namespace cc7
+{
+namespace detail
+{
+	// -----------------------------------------------------------------
+	// Vectorized hexadecimal kernels
+	//
+	// Each byte is split into two nibbles, which are translated into
+	// characters with one table lookup. The decoder validates the whole
+	// vector at once: a character is valid if it is a decimal digit, or
+	// if it's a letter from 'a' to 'f' after folding to lowercase.
+	// -----------------------------------------------------------------
+	
+	static const char s_simd_hex_uc[16] = { '0','1','2','3','4','5','6','7','8','9','A','B','C','D','E','F' };
+	static const char s_simd_hex_lc[16] = { '0','1','2','3','4','5','6','7','8','9','a','b','c','d','e','f' };
+
+#if defined(CC7_SIMD_X86)
+	
+	// MARK: SSSE3 -
+	
+	template <bool Lowercase>
+	CC7_TARGET_SSSE3 static size_t _Encode_SSSE3(const cc7::byte * in, size_t in_len, char * out)
+	{
+		const __m128i table = _mm_loadu_si128((const __m128i*)(Lowercase ? s_simd_hex_lc : s_simd_hex_uc));
+		const __m128i mask_0f = _mm_set1_epi8(0x0f);
+		size_t processed = 0;
+		while (in_len - processed >= 16) {
+			const __m128i data = _mm_loadu_si128((const __m128i*)(in + processed));
+			const __m128i hi = _mm_shuffle_epi8(table, _mm_and_si128(_mm_srli_epi16(data, 4), mask_0f));
+			const __m128i lo = _mm_shuffle_epi8(table, _mm_and_si128(data, mask_0f));
+			_mm_storeu_si128((__m128i*)out,        _mm_unpacklo_epi8(hi, lo));
+			_mm_storeu_si128((__m128i*)(out + 16), _mm_unpackhi_epi8(hi, lo));
+			processed += 16;
+			out += 32;
+		}
+		return processed;
+	}
+	
+	/*
+	 Translates 16 characters into nibbles. The |valid| mask contains 0xFF
+	 for all valid characters.
+	 */
+	CC7_TARGET_SSSE3 static inline __m128i _DecodeNibbles_SSSE3(__m128i c, __m128i & valid)
+	{
+		const __m128i digit  = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+		const __m128i letter = _mm_sub_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+		const __m128i is_digit  = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+		const __m128i is_letter = _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter);
+		valid = _mm_or_si128(is_digit, is_letter);
+		return _mm_or_si128(_mm_and_si128(is_digit, digit),
+							_mm_and_si128(is_letter, _mm_add_epi8(letter, _mm_set1_epi8(10))));
+	}
+	
+	CC7_TARGET_SSSE3 static size_t _Decode_SSSE3(const cc7::byte * in, size_t in_len, cc7::byte * out)
+	{
+		// Multiplier for the high and low nibble in each pair
+		const __m128i merge = _mm_set1_epi16(0x0110);
+		size_t processed = 0;
+		while (in_len - processed >= 32) {
+			__m128i valid0, valid1;
+			const __m128i n0 = _DecodeNibbles_SSSE3(_mm_loadu_si128((const __m128i*)(in + processed)), valid0);
+			const __m128i n1 = _DecodeNibbles_SSSE3(_mm_loadu_si128((const __m128i*)(in + processed + 16)), valid1);
+			if (_mm_movemask_epi8(_mm_and_si128(valid0, valid1)) != 0xFFFF) {
+				break;
+			}
+			const __m128i w0 = _mm_maddubs_epi16(n0, merge);
+			const __m128i w1 = _mm_maddubs_epi16(n1, merge);
+			_mm_storeu_si128((__m128i*)out, _mm_packus_epi16(w0, w1));
+			processed += 32;
+			out += 16;
+		}
+		return processed;
+	}
+	
+	// MARK: AVX2 -
+	
+	template <bool Lowercase>
+	CC7_TARGET_AVX2 static size_t _Encode_AVX2(const cc7::byte * in, size_t in_len, char * out)
+	{
+		const __m256i table = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)(Lowercase ? s_simd_hex_lc : s_simd_hex_uc)));
+		const __m256i mask_0f = _mm256_set1_epi8(0x0f);
+		size_t processed = 0;
+		while (in_len - processed >= 32) {
+			const __m256i data = _mm256_loadu_si256((const __m256i*)(in + processed));
+			const __m256i hi = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(data, 4), mask_0f));
+			const __m256i lo = _mm256_shuffle_epi8(table, _mm256_and_si256(data, mask_0f));
+			// Unpack works within 128 bit lanes, so the halves must be reordered.
+			const __m256i chars_lo = _mm256_unpacklo_epi8(hi, lo);
+			const __m256i chars_hi = _mm256_unpackhi_epi8(hi, lo);
+			_mm256_storeu_si256((__m256i*)out,        _mm256_permute2x128_si256(chars_lo, chars_hi, 0x20));
+			_mm256_storeu_si256((__m256i*)(out + 32), _mm256_permute2x128_si256(chars_lo, chars_hi, 0x31));
+			processed += 32;
+			out += 64;
+		}
+		return processed;
+	}
+	
+	CC7_TARGET_AVX2 static inline __m256i _DecodeNibbles_AVX2(__m256i c, __m256i & valid)
+	{
+		const __m256i digit  = _mm256_sub_epi8(c, _mm256_set1_epi8('0'));
+		const __m256i letter = _mm256_sub_epi8(_mm256_or_si256(c, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+		const __m256i is_digit  = _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+		const __m256i is_letter = _mm256_cmpeq_epi8(_mm256_min_epu8(letter, _mm256_set1_epi8(5)), letter);
+		valid = _mm256_or_si256(is_digit, is_letter);
+		return _mm256_or_si256(_mm256_and_si256(is_digit, digit),
+							   _mm256_and_si256(is_letter, _mm256_add_epi8(letter, _mm256_set1_epi8(10))));
+	}
+	
+	CC7_TARGET_AVX2 static size_t _Decode_AVX2(const cc7::byte * in, size_t in_len, cc7::byte * out)
+	{
+		const __m256i merge = _mm256_set1_epi16(0x0110);
+		size_t processed = 0;
+		while (in_len - processed >= 64) {
+			__m256i valid0, valid1;
+			const __m256i n0 = _DecodeNibbles_AVX2(_mm256_loadu_si256((const __m256i*)(in + processed)), valid0);
+			const __m256i n1 = _DecodeNibbles_AVX2(_mm256_loadu_si256((const __m256i*)(in + processed + 32)), valid1);
+			if (_mm256_movemask_epi8(_mm256_and_si256(valid0, valid1)) != -1) {
+				break;
+			}
+			const __m256i w0 = _mm256_maddubs_epi16(n0, merge);
+			const __m256i w1 = _mm256_maddubs_epi16(n1, merge);
+			// Pack works within 128 bit lanes, so the 64 bit quarters must be reordered.
+			const __m256i packed = _mm256_packus_epi16(w0, w1);
+			_mm256_storeu_si256((__m256i*)out, _mm256_permute4x64_epi64(packed, 0xD8));
+			processed += 64;
+			out += 32;
+		}
+		return processed;
+	}
+
+#endif // defined(CC7_SIMD_X86)
+
+#if defined(CC7_SIMD_NEON)
+	
+	// MARK: NEON -
+	
+	template <bool Lowercase>
+	static size_t _Encode_NEON(const cc7::byte * in, size_t in_len, char * out)
+	{
+		const uint8x16_t table = vld1q_u8(reinterpret_cast<const cc7::byte*>(Lowercase ? s_simd_hex_lc : s_simd_hex_uc));
+		const uint8x16_t mask_0f = vdupq_n_u8(0x0f);
+		size_t processed = 0;
+		while (in_len - processed >= 16) {
+			const uint8x16_t data = vld1q_u8(in + processed);
+			uint8x16x2_t chars;
+			chars.val[0] = vqtbl1q_u8(table, vshrq_n_u8(data, 4));
+			chars.val[1] = vqtbl1q_u8(table, vandq_u8(data, mask_0f));
+			// Store 32 characters, interleaved
+			vst2q_u8(reinterpret_cast<cc7::byte*>(out), chars);
+			processed += 16;
+			out += 32;
+		}
+		return processed;
+	}
+	
+	static inline uint8x16_t _DecodeNibbles_NEON(uint8x16_t c, uint8x16_t & valid)
+	{
+		const uint8x16_t digit  = vsubq_u8(c, vdupq_n_u8('0'));
+		const uint8x16_t letter = vsubq_u8(vorrq_u8(c, vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+		const uint8x16_t is_digit  = vcltq_u8(digit, vdupq_n_u8(10));
+		const uint8x16_t is_letter = vcltq_u8(letter, vdupq_n_u8(6));
+		valid = vorrq_u8(is_digit, is_letter);
+		return vorrq_u8(vandq_u8(is_digit, digit), vandq_u8(is_letter, vaddq_u8(letter, vdupq_n_u8(10))));
+	}
+	
+	static size_t _Decode_NEON(const cc7::byte * in, size_t in_len, cc7::byte * out)
+	{
+		size_t processed = 0;
+		while (in_len - processed >= 32) {
+			// Load 16 pairs, deinterleaved into high and low nibbles
+			const uint8x16x2_t chars = vld2q_u8(in + processed);
+			uint8x16_t valid_hi, valid_lo;
+			const uint8x16_t hi = _DecodeNibbles_NEON(chars.val[0], valid_hi);
+			const uint8x16_t lo = _DecodeNibbles_NEON(chars.val[1], valid_lo);
+			if (vminvq_u8(vandq_u8(valid_hi, valid_lo)) != 0xFF) {
+				break;
+			}
+			vst1q_u8(out, vorrq_u8(vshlq_n_u8(hi, 4), lo));
+			processed += 32;
+			out += 16;
+		}
+		return processed;
+	}
+
+#endif // defined(CC7_SIMD_NEON)
+	
+	
+	// MARK: Kernel selection -
+	
+	const HexString_Kernels & HexString_GetKernels()
+	{
+		// Candidates are ordered from the most preferred one.
+		static const cpu::Candidate<HexString_Kernels> s_candidates[] =
+		{
+#if defined(CC7_SIMD_X86)
+			{ cpu::AVX2,	{ { _Encode_AVX2<false>,  _Encode_AVX2<true>  }, _Decode_AVX2,  "avx2"  } },
+			{ cpu::SSSE3,	{ { _Encode_SSSE3<false>, _Encode_SSSE3<true> }, _Decode_SSSE3, "ssse3" } },
+#elif defined(CC7_SIMD_NEON)
+			{ cpu::NEON,	{ { _Encode_NEON<false>,  _Encode_NEON<true>  }, _Decode_NEON,  "neon"  } },
+#endif
+			{ 0,			{ { nullptr, nullptr }, nullptr, "scalar" } },
+		};
+		// C++11 guarantees thread safe initialization of the local static variable.
+		static const HexString_Kernels & s_kernels = cpu::Select(s_candidates);
+		return s_kernels;
+	}
+
+} // cc7::detail
+} // cc7
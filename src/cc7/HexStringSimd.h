@@ -0,0 +1,64 @@
+/*
+ * Copyright 2016 Juraj Durech <durech.juraj@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Simd.h"
+
+//
+// Private header, shared between HexString.cpp and HexStringSimd.cpp.
+//
+
+namespace cc7
+{
+namespace detail
+{
+	/**
+	 Encode kernel converts as many bytes from |in| as possible into hexadecimal
+	 characters written to |out|. Returns number of consumed input bytes.
+	 The caller is responsible to process the rest of the input.
+	 */
+	typedef size_t (*HexString_EncodeKernel)(const cc7::byte * in, size_t in_len, char * out);
+	
+	/**
+	 Decode kernel converts as many character pairs from |in| as possible into bytes
+	 written to |out|. The |in_len| must be even. The kernel stops before the first
+	 vector containing an invalid character, so the scalar decoder can process
+	 the rest and report the error. Returns number of consumed input characters,
+	 which is always even.
+	 */
+	typedef size_t (*HexString_DecodeKernel)(const cc7::byte * in, size_t in_len, cc7::byte * out);
+	
+	/**
+	 The HexString_Kernels structure contains kernels selected for the current CPU.
+	 The encode table is indexed by the lowercase flag. All pointers are nullptr when
+	 there's no vectorized implementation available.
+	 */
+	struct HexString_Kernels
+	{
+		HexString_EncodeKernel	encode[2];
+		HexString_DecodeKernel	decode;
+		const char *			name;
+	};
+	
+	/**
+	 Returns kernels selected for the current CPU. The selection is performed only once,
+	 at the first call, and the function is thread safe.
+	 */
+	const HexString_Kernels & HexString_GetKernels();
+
+} // cc7::detail
+} // cc7
@@ -0,0 +1,165 @@
+/*
+ * Copyright 2016 Juraj Durech <durech.juraj@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cc7/SecureArena.h>
+#include <cc7/Utilities.h>
+
+namespace cc7
+{
+	/// Alignment of all allocations
+	static const size_t s_alignment = 16;
+	
+	static inline size_t _AlignSize(size_t size)
+	{
+		return (size + (s_alignment - 1)) & ~(s_alignment - 1);
+	}
+	
+	// MARK: Construction / Destruction -
+	
+	SecureArena::SecureArena(size_t block_size) :
+		_block_size(_AlignSize(block_size > 0 ? block_size : DefaultBlockSize)),
+		_current(0),
+		_offset(0),
+		_last(nullptr),
+		_used_size(0)
+	{
+	}
+	
+	SecureArena::~SecureArena()
+	{
+		for (Block & block : _blocks) {
+			CC7_SecureClean(block.data, block.used);
+			delete [] block.data;
+		}
+	}
+	
+	// MARK: Allocation -
+	
+	void * SecureArena::allocate(size_t size)
+	{
+		size_t aligned_size = _AlignSize(size > 0 ? size : 1);
+		_used_size += aligned_size;
+		if (aligned_size > _block_size / 4) {
+			return _allocateDedicated(aligned_size);
+		}
+		if (_blocks.empty() || _blocks[_current].dedicated || _offset + aligned_size > _blocks[_current].size) {
+			if (!_nextBlock()) {
+				return nullptr;
+			}
+		}
+		Block & block = _blocks[_current];
+		_last    = block.data + _offset;
+		_offset += aligned_size;
+		if (_offset > block.used) {
+			block.used = _offset;
+		}
+		return _last;
+	}
+	
+	void SecureArena::deallocate(void * ptr, size_t size)
+	{
+		if (!ptr) {
+			return;
+		}
+		size_t aligned_size = _AlignSize(size > 0 ? size : 1);
+		_used_size -= aligned_size < _used_size ? aligned_size : _used_size;
+		if (ptr == _last) {
+			// The most recent allocation can be returned back to the current block.
+			// The memory will be cleaned in reset(), because the high water mark
+			// is not changed.
+			_offset -= aligned_size;
+			_last = nullptr;
+			return;
+		}
+		if (aligned_size > _block_size / 4) {
+			// Dedicated blocks are released immediately.
+			for (auto it = _blocks.begin(); it != _blocks.end(); ++it) {
+				if (it->dedicated && it->data == ptr) {
+					CC7_SecureClean(it->data, it->used);
+					delete [] it->data;
+					size_t index = it - _blocks.begin();
+					_blocks.erase(it);
+					if (index < _current) {
+						_current--;
+					}
+					return;
+				}
+			}
+			CC7_ASSERT(false, "The pointer was not allocated in this arena.");
+		}
+		// Other allocations stay in the arena until the reset.
+	}
+	
+	void SecureArena::reset()
+	{
+		size_t index = 0;
+		while (index < _blocks.size()) {
+			Block & block = _blocks[index];
+			CC7_SecureClean(block.data, block.used);
+			if (block.dedicated) {
+				delete [] block.data;
+				_blocks.erase(_blocks.begin() + index);
+				continue;
+			}
+			block.used = 0;
+			index++;
+		}
+		_current   = 0;
+		_offset    = 0;
+		_last      = nullptr;
+		_used_size = 0;
+	}
+	
+	size_t SecureArena::usedSize() const
+	{
+		return _used_size;
+	}
+	
+	size_t SecureArena::reservedSize() const
+	{
+		size_t size = 0;
+		for (const Block & block : _blocks) {
+			size += block.size;
+		}
+		return size;
+	}
+	
+	cc7::byte * SecureArena::_allocateDedicated(size_t size)
+	{
+		Block block = { new cc7::byte[size], size, size, true };
+		_blocks.push_back(block);
+		return block.data;
+	}
+	
+	bool SecureArena::_nextBlock()
+	{
+		// Look for the next regular block, which is already allocated. The blocks
+		// are empty after the reset, or when the dedicated block was skipped.
+		size_t index = _blocks.empty() ? 0 : _current + 1;
+		while (index < _blocks.size() && _blocks[index].dedicated) {
+			index++;
+		}
+		if (index == _blocks.size()) {
+			Block block = { new cc7::byte[_block_size], _block_size, 0, false };
+			_blocks.push_back(block);
+		}
+		_current = index;
+		_offset  = 0;
+		_last    = nullptr;
+		return true;
+	}
+	
+} // cc7
@@ -0,0 +1,332 @@
+/*
+ * Copyright 2016 Juraj Durech <durech.juraj@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cc7/SecureBuffer.h>
+#include <new>
+
+#if defined(CC7_LINUX) || defined(CC7_ANDROID)
+#include <sys/mman.h>
+#include <unistd.h>
+	#if defined(MREMAP_MAYMOVE)
+		#define CC7_SECURE_BUFFER_MREMAP
+	#endif
+#endif
+
+namespace cc7
+{
+	// MARK: Memory blocks -
+	
+	/*
+	 Allocates |size| bytes from the |resource|, or from the regular heap.
+	 Returns nullptr if the memory cannot be allocated.
+	 */
+	static byte * _AllocateBlock(SecureMemoryResource * resource, size_t size)
+	{
+		void * p = resource ? resource->allocate(size) : ::operator new(size, std::nothrow);
+		return static_cast<byte*>(p);
+	}
+	
+	/*
+	 Releases block allocated with _AllocateBlock(). The first |dirty| bytes are
+	 securely cleaned, unless the resource is responsible for the cleanup.
+	 */
+	static void _ReleaseBlock(SecureMemoryResource * resource, byte * p, size_t size, size_t dirty)
+	{
+		if (resource) {
+			resource->deallocate(p, size);
+			return;
+		}
+		CC7_SecureClean(p, dirty);
+		::operator delete(p);
+	}
+	
+#if defined(CC7_SECURE_BUFFER_MREMAP)
+	
+	static size_t _RoundUpToPages(size_t size)
+	{
+		static const long s_page_size = sysconf(_SC_PAGESIZE);
+		const size_t page_size = s_page_size > 0 ? (size_t)s_page_size : 4096;
+		return ((size + page_size - 1) / page_size) * page_size;
+	}
+	
+	/*
+	 Maps |size| bytes of anonymous memory, excluded from the core dumps.
+	 Returns nullptr on failure.
+	 */
+	static byte * _MapBlock(size_t size)
+	{
+		void * p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+		if (p == MAP_FAILED) {
+			return nullptr;
+		}
+	#if defined(MADV_DONTDUMP)
+		madvise(p, size, MADV_DONTDUMP);
+	#endif
+		return static_cast<byte*>(p);
+	}
+	
+	/*
+	 Resizes the mapping. The kernel moves the pages, if the mapping cannot grow
+	 in place, so the content is never copied. Returns nullptr on failure.
+	 */
+	static byte * _RemapBlock(byte * p, size_t old_size, size_t new_size)
+	{
+		void * new_p = mremap(p, old_size, new_size, MREMAP_MAYMOVE);
+		return new_p != MAP_FAILED ? static_cast<byte*>(new_p) : nullptr;
+	}
+	
+#endif // defined(CC7_SECURE_BUFFER_MREMAP)
+	
+	
+	// MARK: Construction / Destruction -
+	
+	SecureBuffer::SecureBuffer() noexcept :
+		SecureBuffer(SecureMemoryResource::current())
+	{
+	}
+	
+	SecureBuffer::SecureBuffer(SecureMemoryResource * resource) noexcept :
+		_data(nullptr),
+		_size(0),
+		_capacity(0),
+		_dirty(0),
+		_resource(resource),
+		_mapped(false)
+	{
+	}
+	
+	SecureBuffer::SecureBuffer(const ByteRange & range) :
+		SecureBuffer()
+	{
+		reserve_exact(range.size());
+		append(range);
+	}
+	
+	SecureBuffer::SecureBuffer(const SecureBuffer & other) :
+		SecureBuffer()
+	{
+		reserve_exact(other._size);
+		append(other._data, other._size);
+	}
+	
+	SecureBuffer::SecureBuffer(SecureBuffer && other) noexcept :
+		SecureBuffer(other._resource)
+	{
+		_moveFrom(other);
+	}
+	
+	SecureBuffer::~SecureBuffer()
+	{
+		_releaseStorage();
+	}
+	
+	SecureBuffer & SecureBuffer::operator=(SecureBuffer && other) noexcept
+	{
+		if (this != &other) {
+			// The resource follows the content, like in the ByteArray.
+			_releaseStorage();
+			_resource = other._resource;
+			_moveFrom(other);
+		}
+		return *this;
+	}
+	
+	
+	// MARK: Public methods -
+	
+	void SecureBuffer::assign(const ByteRange & range)
+	{
+		if (_isOwnMemory(range.data())) {
+			// The range is captured from this buffer.
+			SecureBuffer copy(_resource);
+			copy.reserve_exact(range.size());
+			copy.append(range);
+			swap(copy);
+			return;
+		}
+		_size = 0;
+		append(range);
+	}
+	
+	SecureBuffer & SecureBuffer::append(const_pointer p, size_type size)
+	{
+		if (size > 0) {
+			if (_isOwnMemory(p)) {
+				// The source may be moved by the reallocation, so keep its offset only.
+				// The source can't overlap with the appended bytes.
+				const size_type offset = p - _data;
+				pointer room = _makeRoom(size);
+				if (room) {
+					memcpy(room, _data + offset, size);
+				}
+			} else {
+				pointer room = _makeRoom(size);
+				if (room) {
+					memcpy(room, p, size);
+				}
+			}
+		}
+		return *this;
+	}
+	
+	void SecureBuffer::shrink_to_fit_secure()
+	{
+		if (_dirty > _size) {
+			CC7_SecureClean(_data + _size, _dirty - _size);
+			_dirty = _size;
+		}
+		if (_size < _capacity) {
+			_reallocate(_size);
+		}
+	}
+	
+	void SecureBuffer::swap(SecureBuffer & other) noexcept
+	{
+		std::swap(_data, other._data);
+		std::swap(_size, other._size);
+		std::swap(_capacity, other._capacity);
+		std::swap(_dirty, other._dirty);
+		std::swap(_resource, other._resource);
+		std::swap(_mapped, other._mapped);
+	}
+	
+	void SecureBuffer::secureClear() noexcept
+	{
+		CC7_SecureClean(_data, _dirty);
+		_size = 0;
+		_dirty = 0;
+	}
+	
+	
+	// MARK: Private methods -
+	
+	void SecureBuffer::_moveFrom(SecureBuffer & other) noexcept
+	{
+		_data     = other._data;
+		_size     = other._size;
+		_capacity = other._capacity;
+		_dirty    = other._dirty;
+		_mapped   = other._mapped;
+		other._data     = nullptr;
+		other._size     = 0;
+		other._capacity = 0;
+		other._dirty    = 0;
+		other._mapped   = false;
+	}
+	
+	void SecureBuffer::_releaseStorage() noexcept
+	{
+		if (_data) {
+#if defined(CC7_SECURE_BUFFER_MREMAP)
+			if (_mapped) {
+				CC7_SecureClean(_data, _dirty);
+				munmap(_data, _capacity);
+			} else {
+				_ReleaseBlock(_resource, _data, _capacity, _dirty);
+			}
+#else
+			_ReleaseBlock(_resource, _data, _capacity, _dirty);
+#endif
+		}
+		_data     = nullptr;
+		_size     = 0;
+		_capacity = 0;
+		_dirty    = 0;
+		_mapped   = false;
+	}
+	
+	void SecureBuffer::_replaceStorage(pointer new_data, size_type new_capacity, bool mapped) noexcept
+	{
+		// Only the content is copied, so only the copied bytes will need
+		// the cleanup in the new storage.
+		const size_type size = _size;
+		if (size > 0) {
+			memcpy(new_data, _data, size);
+		}
+		_releaseStorage();
+		_data     = new_data;
+		_size     = size;
+		_capacity = new_capacity;
+		_dirty    = size;
+		_mapped   = mapped;
+	}
+	
+	void SecureBuffer::_reallocate(size_type new_capacity)
+	{
+		if (new_capacity > max_size()) {
+			_ValueTypeExceptions::length_error();
+			return;
+		}
+		if (new_capacity == 0) {
+			_releaseStorage();
+			return;
+		}
+#if defined(CC7_SECURE_BUFFER_MREMAP)
+		if (!_resource && new_capacity >= MappedCapacity) {
+			new_capacity = _RoundUpToPages(new_capacity);
+			if (_mapped) {
+				if (new_capacity == _capacity) {
+					return;
+				}
+				if (_dirty > new_capacity) {
+					// Pages returned to the system must not contain data.
+					CC7_SecureClean(_data + new_capacity, _dirty - new_capacity);
+					_dirty = new_capacity;
+				}
+				pointer new_data = _RemapBlock(_data, _capacity, new_capacity);
+				if (!new_data) {
+					_ValueTypeExceptions::allocation_error();
+					return;
+				}
+				_data     = new_data;
+				_capacity = new_capacity;
+				return;
+			}
+			pointer new_data = _MapBlock(new_capacity);
+			if (!new_data) {
+				_ValueTypeExceptions::allocation_error();
+				return;
+			}
+			_replaceStorage(new_data, new_capacity, true);
+			return;
+		}
+#endif
+		pointer new_data = _AllocateBlock(_resource, new_capacity);
+		if (!new_data) {
+			_ValueTypeExceptions::allocation_error();
+			return;
+		}
+		_replaceStorage(new_data, new_capacity, false);
+	}
+	
+	void SecureBuffer::_grow(size_type required_capacity)
+	{
+		// The doubling keeps the number of intermediate copies of the secret,
+		// and the total amount of cleaned memory, proportional to the final size.
+		size_type new_capacity = _capacity * 2;
+		if (new_capacity < required_capacity) {
+			new_capacity = required_capacity;
+		}
+		if (new_capacity < MinimumCapacity) {
+			new_capacity = MinimumCapacity;
+		}
+		if (new_capacity > max_size() && required_capacity <= max_size()) {
+			new_capacity = max_size();
+		}
+		_reallocate(new_capacity);
+	}
+
+} // cc7
@@ -0,0 +1,295 @@
+/*
+ * Copyright 2016 Juraj Durech <durech.juraj@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cc7/SecureHeap.h>
+#include <new>
+
+#if !defined(CC7_WINDOWS)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace cc7
+{
+	/// Size of the smallest block, must be enough for the _FreeNode
+	static const size_t s_min_block_size = 16;
+	
+	/// Marks end of the free list
+	static const size_t s_no_block = (size_t)-1;
+	
+	/// Header of a free block, stored directly in the region
+	struct _FreeNode
+	{
+		size_t next;
+		size_t prev;
+	};
+	
+	static inline size_t _BlockSize(size_t order)
+	{
+		return s_min_block_size << order;
+	}
+	
+	static inline size_t _OrderForSize(size_t size)
+	{
+		size_t order = 0;
+		while (_BlockSize(order) < size) {
+			order++;
+		}
+		return order;
+	}
+	
+	// MARK: Region -
+	
+	/*
+	 Returns size of the memory page.
+	 */
+	static size_t _GetPageSize()
+	{
+#if defined(CC7_WINDOWS)
+		SYSTEM_INFO info;
+		GetSystemInfo(&info);
+		return info.dwPageSize;
+#else
+		long page_size = sysconf(_SC_PAGESIZE);
+		return page_size > 0 ? (size_t)page_size : 4096;
+#endif
+	}
+	
+	/*
+	 Reserves |size| bytes surrounded by two guard pages and locks the memory.
+	 Returns pointer to the usable part, or nullptr on failure.
+	 */
+	static byte * _ReserveRegion(size_t size, size_t page_size, bool exclude_from_dump, bool & out_locked, bool & out_excluded)
+	{
+		out_locked   = false;
+		out_excluded = false;
+		size_t total_size = size + 2 * page_size;
+#if defined(CC7_WINDOWS)
+		byte * memory = (byte*)VirtualAlloc(nullptr, total_size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+		if (!memory) {
+			return nullptr;
+		}
+		byte * region = memory + page_size;
+		DWORD old_protect;
+		VirtualProtect(memory, page_size, PAGE_NOACCESS, &old_protect);
+		VirtualProtect(region + size, page_size, PAGE_NOACCESS, &old_protect);
+		out_locked = VirtualLock(region, size) != FALSE;
+#else
+		void * memory = mmap(nullptr, total_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+		if (memory == MAP_FAILED) {
+			return nullptr;
+		}
+		byte * region = (byte*)memory + page_size;
+		mprotect(memory, page_size, PROT_NONE);
+		mprotect(region + size, page_size, PROT_NONE);
+		out_locked = mlock(region, size) == 0;
+		if (exclude_from_dump) {
+	#if defined(MADV_DONTDUMP)
+			out_excluded = madvise(region, size, MADV_DONTDUMP) == 0;
+	#elif defined(MADV_NOCORE)
+			out_excluded = madvise(region, size, MADV_NOCORE) == 0;
+	#endif
+		}
+#endif
+		return region;
+	}
+	
+	/*
+	 Unlocks and releases region reserved by _ReserveRegion().
+	 */
+	static void _ReleaseRegion(byte * region, size_t size, size_t page_size, bool locked)
+	{
+#if defined(CC7_WINDOWS)
+		if (locked) {
+			VirtualUnlock(region, size);
+		}
+		VirtualFree(region - page_size, 0, MEM_RELEASE);
+#else
+		if (locked) {
+			munlock(region, size);
+		}
+		munmap(region - page_size, size + 2 * page_size);
+#endif
+	}
+	
+	// MARK: Construction / Destruction -
+	
+	SecureHeap::SecureHeap(size_t heap_size, bool exclude_from_dump) :
+		_region(nullptr),
+		_region_size(0),
+		_page_size(_GetPageSize()),
+		_max_order(0)
+	{
+		memset(&_stats, 0, sizeof(_stats));
+		size_t size = ((heap_size + _page_size - 1) / _page_size) * _page_size;
+		if (size == 0) {
+			return;
+		}
+		_region = _ReserveRegion(size, _page_size, exclude_from_dump, _stats.is_locked, _stats.is_excluded_from_dump);
+		if (!_region) {
+			CC7_LOG("SecureHeap: Unable to reserve %u bytes.\n", (unsigned)size);
+			return;
+		}
+		if (!_stats.is_locked) {
+			CC7_LOG("SecureHeap: Unable to lock %u bytes. The memory can be swapped.\n", (unsigned)size);
+		}
+		_region_size     = size;
+		_stats.heap_size = size;
+		_max_order       = _OrderForSize(size);
+		_free_lists.assign(_max_order + 1, s_no_block);
+		_free_orders.assign(size / s_min_block_size, 0);
+		// Split the region to the largest aligned blocks. The page size is
+		// a power of two, so the region is always fully covered.
+		size_t offset = 0;
+		while (offset < size) {
+			size_t order = _max_order;
+			while (order > 0 && ((offset & (_BlockSize(order) - 1)) != 0 || offset + _BlockSize(order) > size)) {
+				order--;
+			}
+			_pushFree(offset, order);
+			offset += _BlockSize(order);
+		}
+	}
+	
+	SecureHeap::~SecureHeap()
+	{
+		CC7_ASSERT(_stats.allocations_count == 0 && _stats.fallback_allocations_count == 0, "SecureHeap is destroyed with live allocations.");
+		if (_region) {
+			CC7_SecureClean(_region, _region_size);
+			_ReleaseRegion(_region, _region_size, _page_size, _stats.is_locked);
+		}
+	}
+	
+	// MARK: Allocation -
+	
+	void * SecureHeap::allocate(size_t size)
+	{
+		size_t order = _OrderForSize(size > 0 ? size : 1);
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_stats.total_allocations_count++;
+			if (_region && order <= _max_order) {
+				// Find the smallest free block which is large enough
+				size_t free_order = order;
+				while (free_order <= _max_order && _free_lists[free_order] == s_no_block) {
+					free_order++;
+				}
+				if (free_order <= _max_order) {
+					size_t offset = _free_lists[free_order];
+					_removeFree(offset, free_order);
+					// Split the block and keep the upper halves free
+					while (free_order > order) {
+						free_order--;
+						_pushFree(offset + _BlockSize(free_order), free_order);
+					}
+					// Clear the free list node
+					CC7_SecureClean(_region + offset, sizeof(_FreeNode));
+					_stats.allocations_count++;
+					_stats.used_size += _BlockSize(order);
+					if (_stats.used_size > _stats.peak_used_size) {
+						_stats.peak_used_size = _stats.used_size;
+					}
+					return _region + offset;
+				}
+			}
+			_stats.fallback_allocations_count++;
+			_stats.total_fallback_allocations_count++;
+		}
+		cc7::byte * fallback = new (std::nothrow) cc7::byte[size > 0 ? size : 1];
+		if (!fallback) {
+			std::lock_guard<std::mutex> lock(_mutex);
+			_stats.fallback_allocations_count--;
+		}
+		return fallback;
+	}
+	
+	void SecureHeap::deallocate(void * ptr, size_t size)
+	{
+		if (!ptr) {
+			return;
+		}
+		if (!contains(ptr)) {
+			// Allocated in the regular heap
+			CC7_SecureClean(ptr, size);
+			delete [] static_cast<cc7::byte*>(ptr);
+			std::lock_guard<std::mutex> lock(_mutex);
+			_stats.fallback_allocations_count--;
+			return;
+		}
+		size_t order  = _OrderForSize(size > 0 ? size : 1);
+		size_t offset = static_cast<cc7::byte*>(ptr) - _region;
+		CC7_SecureClean(ptr, _BlockSize(order));
+		
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stats.allocations_count--;
+		_stats.used_size -= _BlockSize(order);
+		// Merge with free buddies
+		while (order < _max_order) {
+			size_t buddy = offset ^ _BlockSize(order);
+			if (buddy + _BlockSize(order) > _region_size || _free_orders[buddy / s_min_block_size] != order + 1) {
+				break;
+			}
+			_removeFree(buddy, order);
+			CC7_SecureClean(_region + buddy, sizeof(_FreeNode));
+			if (buddy < offset) {
+				offset = buddy;
+			}
+			order++;
+		}
+		_pushFree(offset, order);
+	}
+	
+	bool SecureHeap::contains(const void * ptr) const
+	{
+		const cc7::byte * p = static_cast<const cc7::byte*>(ptr);
+		return _region && p >= _region && p < _region + _region_size;
+	}
+	
+	SecureHeap::Statistics SecureHeap::statistics() const
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _stats;
+	}
+	
+	// MARK: Private methods -
+	
+	void SecureHeap::_pushFree(size_t offset, size_t order)
+	{
+		_FreeNode * node = reinterpret_cast<_FreeNode*>(_region + offset);
+		node->next = _free_lists[order];
+		node->prev = s_no_block;
+		if (node->next != s_no_block) {
+			reinterpret_cast<_FreeNode*>(_region + node->next)->prev = offset;
+		}
+		_free_lists[order] = offset;
+		_free_orders[offset / s_min_block_size] = (byte)(order + 1);
+	}
+	
+	void SecureHeap::_removeFree(size_t offset, size_t order)
+	{
+		_FreeNode * node = reinterpret_cast<_FreeNode*>(_region + offset);
+		if (node->prev != s_no_block) {
+			reinterpret_cast<_FreeNode*>(_region + node->prev)->next = node->next;
+		} else {
+			_free_lists[order] = node->next;
+		}
+		if (node->next != s_no_block) {
+			reinterpret_cast<_FreeNode*>(_region + node->next)->prev = node->prev;
+		}
+		_free_orders[offset / s_min_block_size] = 0;
+	}
+
+} // cc7
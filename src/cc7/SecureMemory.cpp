@@ -0,0 +1,126 @@
+/*
+ * Copyright 2016 Juraj Durech <durech.juraj@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cc7/SecureMemory.h>
+
+// Both SSE2 and NEON are part of the base instruction set on all supported
+// 64 bit CPUs, so no runtime detection is required.
+#if !defined(CC7_NO_SIMD)
+	#if defined(__SSE2__)
+		#include <emmintrin.h>
+		#define CC7_SECURE_SSE2
+	#elif defined(__ARM_NEON)
+		#include <arm_neon.h>
+		#define CC7_SECURE_NEON
+	#endif
+#endif
+
+namespace cc7
+{
+	// MARK: Comparison -
+	
+	/*
+	 Returns OR of XORed bytes from both blocks, so the result is zero only
+	 for equal blocks. The loops have no data-dependent branches.
+	 */
+	static U64 _Difference(const cc7::byte * a, const cc7::byte * b, size_t size)
+	{
+		U64 diff = 0;
+#if defined(CC7_SECURE_SSE2)
+		if (size >= 16) {
+			__m128i acc = _mm_setzero_si128();
+			while (size >= 32) {
+				const __m128i d0 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)a), _mm_loadu_si128((const __m128i*)b));
+				const __m128i d1 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(a + 16)), _mm_loadu_si128((const __m128i*)(b + 16)));
+				acc = _mm_or_si128(acc, _mm_or_si128(d0, d1));
+				a += 32; b += 32; size -= 32;
+			}
+			if (size >= 16) {
+				acc = _mm_or_si128(acc, _mm_xor_si128(_mm_loadu_si128((const __m128i*)a), _mm_loadu_si128((const __m128i*)b)));
+				a += 16; b += 16; size -= 16;
+			}
+			acc = _mm_or_si128(acc, _mm_srli_si128(acc, 8));
+			acc = _mm_or_si128(acc, _mm_srli_si128(acc, 4));
+			diff = (U32)_mm_cvtsi128_si32(acc);
+		}
+#elif defined(CC7_SECURE_NEON)
+		if (size >= 16) {
+			uint8x16_t acc = vdupq_n_u8(0);
+			while (size >= 32) {
+				const uint8x16_t d0 = veorq_u8(vld1q_u8(a), vld1q_u8(b));
+				const uint8x16_t d1 = veorq_u8(vld1q_u8(a + 16), vld1q_u8(b + 16));
+				acc = vorrq_u8(acc, vorrq_u8(d0, d1));
+				a += 32; b += 32; size -= 32;
+			}
+			if (size >= 16) {
+				acc = vorrq_u8(acc, veorq_u8(vld1q_u8(a), vld1q_u8(b)));
+				a += 16; b += 16; size -= 16;
+			}
+			const uint64x2_t acc64 = vreinterpretq_u64_u8(acc);
+			diff = vgetq_lane_u64(acc64, 0) | vgetq_lane_u64(acc64, 1);
+		}
+#endif
+		while (size >= 8) {
+			U64 wa, wb;
+			memcpy(&wa, a, 8);
+			memcpy(&wb, b, 8);
+			diff |= wa ^ wb;
+			a += 8; b += 8; size -= 8;
+		}
+		while (size > 0) {
+			diff |= *a++ ^ *b++;
+			size--;
+		}
+		return diff;
+	}
+	
+	bool SecureCompare(const ByteRange & a, const ByteRange & b)
+	{
+		if (a.size() != b.size()) {
+			return false;
+		}
+		return _Difference(a.data(), b.data(), a.size()) == 0;
+	}
+	
+	bool SecureCompare(const void * a, const void * b, size_t size)
+	{
+		return _Difference(static_cast<const cc7::byte*>(a), static_cast<const cc7::byte*>(b), size) == 0;
+	}
+	
+	// MARK: Cleanup -
+	
+	void SecureClean(void * ptr, size_t size)
+	{
+		if (!ptr || size == 0) {
+			return;
+		}
+#if defined(CC7_WINDOWS)
+		RtlSecureZeroMemory(ptr, size);
+#else
+		// memset() is already vectorized in all C libraries. The empty assembly
+		// block with the memory clobber tells the compiler that the memory is
+		// still in use, so the memset() cannot be removed as a dead store.
+		memset(ptr, 0, size);
+		__asm__ __volatile__("" : : "r"(ptr) : "memory");
+#endif
+	}
+
+} // cc7
+
+CC7_EXTERN_C void CC7SecureCleanImpl(void * ptr, size_t size)
+{
+	cc7::SecureClean(ptr, size);
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright 2016 Juraj Durech <durech.juraj@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cc7/SecureMemoryResource.h>
+#include <atomic>
+
+namespace cc7
+{
+	/// Resource installed for the current thread by SecureMemoryResource::Scope
+	static thread_local SecureMemoryResource * s_current_resource = nullptr;
+	
+	/// Resource used when there's no scope in the current thread
+	static std::atomic<SecureMemoryResource*> s_default_resource(nullptr);
+	
+	SecureMemoryResource::~SecureMemoryResource()
+	{
+		if (s_current_resource == this) {
+			CC7_ASSERT(false, "SecureMemoryResource is destroyed while its scope is still active.");
+			s_current_resource = nullptr;
+		}
+		if (s_default_resource.load() == this) {
+			CC7_ASSERT(false, "SecureMemoryResource is destroyed while it's still the default resource.");
+			s_default_resource.store(nullptr);
+		}
+	}
+	
+	SecureMemoryResource * SecureMemoryResource::current()
+	{
+		if (s_current_resource) {
+			return s_current_resource;
+		}
+		return s_default_resource.load();
+	}
+	
+	void SecureMemoryResource::setDefault(SecureMemoryResource * resource)
+	{
+		s_default_resource.store(resource);
+	}
+	
+	// MARK: Scope -
+	
+	SecureMemoryResource::Scope::Scope(SecureMemoryResource & resource) :
+		_previous(s_current_resource)
+	{
+		s_current_resource = &resource;
+	}
+	
+	SecureMemoryResource::Scope::~Scope()
+	{
+		s_current_resource = _previous;
+	}
+
+} // cc7
@@ -0,0 +1,35 @@
+/*
+ * Copyright 2016 Juraj Durech <durech.juraj@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cc7/CpuFeatures.h>
+
+//
+// Private header, shared between all vectorized codecs.
+// Vectorized kernels can be disabled at compile time with CC7_NO_SIMD macro.
+// The kernels are selected at runtime, with cpu::Select() from <cc7/CpuFeatures.h>.
+//
+#if !defined(CC7_NO_SIMD)
+	#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+		#define CC7_SIMD_X86
+		// Each kernel is compiled for its own instruction set.
+		#define CC7_TARGET_SSSE3	__attribute__((target("ssse3")))
+		#define CC7_TARGET_AVX2		__attribute__((target("avx2")))
+	#elif defined(__aarch64__) && defined(__ARM_NEON)
+		#define CC7_SIMD_NEON
+	#endif
+#endif
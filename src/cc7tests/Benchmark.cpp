@@ -0,0 +1,159 @@
+/*
+ * Copyright 2016 Juraj Durech <durech.juraj@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cc7tests/Benchmark.h>
+#include <cc7tests/detail/StringUtils.h>
+#include <algorithm>
+#include <stdio.h>
+
+namespace cc7
+{
+namespace tests
+{
+	// MARK: BenchmarkResult -
+	
+	std::string BenchmarkResult::toString() const
+	{
+		return detail::FormattedString("%-36s %10zu B %12.2f MB/s   p50 %12.3f us   p99 %12.3f us",
+									   name.c_str(), data_size, throughput, p50 * 1000.0, p99 * 1000.0);
+	}
+	
+	std::string BenchmarkResult::toJSON() const
+	{
+		return detail::FormattedString("{\"name\":\"%s\",\"size\":%zu,\"samples\":%zu,\"iterations\":%zu,"
+									   "\"p50_ms\":%.9g,\"p99_ms\":%.9g,\"mbps\":%.3f}",
+									   name.c_str(), data_size, samples, iterations, p50, p99, throughput);
+	}
+	
+	
+	// MARK: Benchmark -
+	
+	Benchmark::Benchmark()
+	{
+	}
+	
+	Benchmark::Benchmark(const Config & config) :
+		_config(config)
+	{
+	}
+	
+	const Benchmark::Config & Benchmark::config() const
+	{
+		return _config;
+	}
+	
+	/*
+	 Returns the value at |percentile| from the sorted vector, with using the nearest rank method.
+	 */
+	static double _Percentile(const std::vector<double> & sorted, double percentile)
+	{
+		if (sorted.empty()) {
+			return 0.0;
+		}
+		size_t rank = size_t(percentile * sorted.size() + 0.5);
+		if (rank > 0) {
+			rank--;
+		}
+		return sorted[std::min(rank, sorted.size() - 1)];
+	}
+	
+	const BenchmarkResult & Benchmark::run(const std::string & name, size_t data_size, std::function<void()> block)
+	{
+		PerformanceTimer timer;
+		
+		// Warm up caches and estimate time of one execution.
+		double single_time = 0.0;
+		for (size_t i = 0; i < std::max(_config.warmup_runs, size_t(1)); i++) {
+			single_time = timer.measureBlock(block);
+		}
+		// Calculate number of iterations in one sample, so that the sample is long enough
+		// for the timer's resolution. If the block is too fast, then double the number
+		// of iterations until the sample is long enough.
+		size_t iterations = 1;
+		if (single_time < _config.min_sample_time) {
+			if (single_time > 0.0) {
+				iterations = size_t(_config.min_sample_time / single_time) + 1;
+			}
+			while (true) {
+				double sample_time = timer.measureBlock([&]() {
+					for (size_t i = 0; i < iterations; i++) {
+						block();
+					}
+				});
+				if (sample_time >= _config.min_sample_time) {
+					break;
+				}
+				iterations *= 2;
+			}
+		}
+		
+		// Collect samples
+		std::vector<double> samples;
+		samples.reserve(_config.min_samples);
+		double total_time = 0.0;
+		while (samples.size() < _config.min_samples ||
+			   (samples.size() < _config.max_samples && total_time < _config.max_total_time)) {
+			double sample_time = timer.measureBlock([&]() {
+				for (size_t i = 0; i < iterations; i++) {
+					block();
+				}
+			});
+			total_time += sample_time;
+			samples.push_back(sample_time / iterations);
+		}
+		std::sort(samples.begin(), samples.end());
+		
+		BenchmarkResult result;
+		result.name			= name;
+		result.data_size	= data_size;
+		result.samples		= samples.size();
+		result.iterations	= iterations;
+		result.p50			= _Percentile(samples, 0.50);
+		result.p99			= _Percentile(samples, 0.99);
+		result.throughput	= result.p50 > 0.0 ? double(data_size) / (result.p50 * 1000.0) : 0.0;
+		_results.push_back(result);
+		return _results.back();
+	}
+	
+	const std::vector<BenchmarkResult> & Benchmark::results() const
+	{
+		return _results;
+	}
+	
+	std::string Benchmark::reportJSON() const
+	{
+		std::string report;
+		for (const BenchmarkResult & result : _results) {
+			report.append(result.toJSON());
+			report.push_back('\n');
+		}
+		return report;
+	}
+	
+	bool Benchmark::writeReport(const std::string & path) const
+	{
+		FILE * file = fopen(path.c_str(), "w");
+		if (!file) {
+			return false;
+		}
+		std::string report = reportJSON();
+		bool result = fwrite(report.data(), 1, report.size(), file) == report.size();
+		result = (fclose(file) == 0) && result;
+		return result;
+	}
+
+} // cc7::tests
+} // cc7
@@ -57,7 +57,7 @@ namespace tests
 	cc7::ByteArray JSONValue::dataFromBase64StringAtPath(const std::string & path) const
 	{
 		ByteArray result;
-		if (!Base64_Decode(stringAtPath(path), 0, result)) {
+		if (!Base64_Decode(MakeRange(stringAtPath(path)), 0, result)) {
 			throw std::invalid_argument("The selected string is not a Base64 string.");
 		}
 		return result;
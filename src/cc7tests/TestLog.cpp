@@ -16,6 +16,7 @@
 
 #include <cc7tests/TestLog.h>
 #include <cc7tests/detail/StringUtils.h>
+#include <stdarg.h>
 #include <memory>
 #include <string>
 
@@ -45,6 +45,7 @@ namespace tests
 	}
 	
 	extern const UnitTestCreationInfoList _GetDefaultUnitTestCreationInfoList();
+	extern const UnitTestCreationInfoList _GetDefaultBenchmarkCreationInfoList();
 	
 	TestManager * TestManager::createDefaultManager()
 	{
@@ -54,6 +55,14 @@ namespace tests
 	}
 	
 	
+	TestManager * TestManager::createBenchmarkManager()
+	{
+		TestManager * tm = new TestManager();
+		tm->addUnitTestList(_GetDefaultBenchmarkCreationInfoList());
+		return tm;
+	}
+	
+	
 	TestManager * TestManager::createEmptyManager()
 	{
 		return new TestManager();
@@ -18,6 +18,8 @@
 #include <sstream>
 #include <memory>
 #include <stdlib.h>
+#include <stdarg.h>
+#include <stdio.h>
 
 namespace cc7
 {
@@ -28,13 +28,14 @@ namespace tests
 	cc7::U64 Platform_GetCurrentTime()
 	{
 		struct timespec res;
-		clock_gettime(CLOCK_REALTIME, &res);
-		return (cc7::U64)(1000000.0*res.tv_sec + (double)res.tv_nsec * 1.0/1000.0);
+		clock_gettime(CLOCK_MONOTONIC, &res);
+		return (cc7::U64)res.tv_sec * 1000000000ULL + (cc7::U64)res.tv_nsec;
 	}
 	
 	double Platform_GetTimeDiff(cc7::U64 start, cc7::U64 future)
 	{
-		return (future - start) * 1.0/1000.0;
+		// Returns milliseconds
+		return (double)(future - start) * 1e-6;
 	}
 
 
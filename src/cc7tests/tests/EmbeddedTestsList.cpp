@@ -30,11 +30,31 @@ namespace tests
 		
 		// cc7 framework tests
 		CC7_ADD_UNIT_TEST(cc7PlatformTests, list);
+		CC7_ADD_UNIT_TEST(cc7CpuFeaturesTests, list);
 		CC7_ADD_UNIT_TEST(cc7ByteArrayTests, list);
+		CC7_ADD_UNIT_TEST(cc7SmallByteArrayTests, list);
+		CC7_ADD_UNIT_TEST(cc7SecureArenaTests, list);
+		CC7_ADD_UNIT_TEST(cc7SecureHeapTests, list);
+		CC7_ADD_UNIT_TEST(cc7SecureMemoryTests, list);
+		CC7_ADD_UNIT_TEST(cc7SecureBufferTests, list);
 		CC7_ADD_UNIT_TEST(cc7ByteRangeTests, list);
+		CC7_ADD_UNIT_TEST(cc7ByteRangeListTests, list);
+		CC7_ADD_UNIT_TEST(cc7ByteReaderTests, list);
+		CC7_ADD_UNIT_TEST(cc7ByteWriterTests, list);
 		CC7_ADD_UNIT_TEST(cc7Base32Tests, list);
 		CC7_ADD_UNIT_TEST(cc7Base64Tests, list);
 		CC7_ADD_UNIT_TEST(cc7HexStringTests, list);
+		CC7_ADD_UNIT_TEST(cc7CodecBatchTests, list);
+		
+		return list;
+	}
+	
+	const UnitTestCreationInfoList _GetDefaultBenchmarkCreationInfoList()
+	{
+		UnitTestCreationInfoList list;
+		
+		// cc7 framework benchmarks
+		CC7_ADD_UNIT_TEST(cc7CodecBenchmarks, list);
 		
 		return list;
 	}
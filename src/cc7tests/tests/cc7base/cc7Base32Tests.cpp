@@ -29,8 +29,13 @@ namespace tests
 			CC7_REGISTER_TEST_METHOD(testEncodePadding);
 			CC7_REGISTER_TEST_METHOD(testEncodeNoPadding);
 			CC7_REGISTER_TEST_METHOD(testRandomEncodeDecode);
+			CC7_REGISTER_TEST_METHOD(testLongData);
+			CC7_REGISTER_TEST_METHOD(testAlphabets);
 			CC7_REGISTER_TEST_METHOD(testDecodeWrongPadding);
 			CC7_REGISTER_TEST_METHOD(testDecodeWrongNoPadding);
+			CC7_REGISTER_TEST_METHOD(testInvalidCharacters);
+			CC7_REGISTER_TEST_METHOD(testStreamingEncoder);
+			CC7_REGISTER_TEST_METHOD(testStreamingDecoder);
 		}
 		
 		// UNIT TESTS
@@ -102,7 +107,7 @@ namespace tests
 				ccstAssertTrue(result);
 				result = Base32_Encode(source_data, true, padded);
 				ccstAssertTrue(result);
-
+				
 				ByteArray plain_dec, padded_dec;
 				result = Base32_Decode(plain, false, plain_dec);
 				ccstAssertTrue(result);
@@ -112,7 +117,77 @@ namespace tests
 				ccstAssertEqual(source_data, padded_dec);
 			}
 		}
-
+		
+		
+		void testLongData()
+		{
+			// All lengths cover the full blocks and all possible tails.
+			ByteArray data = getTestRandomData(1100);
+			for (size_t length = 0; length <= data.size(); length += (length < 100 ? 1 : 97)) {
+				ByteRange range = data.byteRange().subRange(0, length);
+				for (int padding = 0; padding < 2; padding++) {
+					std::string encoded = ToBase32String(range, padding == 1);
+					ccstAssertEqual((encoded.size() % 8 == 0), (padding == 1 || length % 5 == 0));
+					ByteArray decoded;
+					bool result = Base32_Decode(encoded, padding == 1, decoded);
+					ccstAssertTrue(result, "Length %d", (int)length);
+					ccstAssertEqual(decoded, range);
+				}
+			}
+		}
+		
+		void testAlphabets()
+		{
+			// RFC 4648, section 10
+			ccstAssertEqual("", ToBase32String(MakeRange(""), true, Base32_Hex));
+			ccstAssertEqual("CO======", ToBase32String(MakeRange("f"), true, Base32_Hex));
+			ccstAssertEqual("CPNG====", ToBase32String(MakeRange("fo"), true, Base32_Hex));
+			ccstAssertEqual("CPNMU===", ToBase32String(MakeRange("foo"), true, Base32_Hex));
+			ccstAssertEqual("CPNMUOG=", ToBase32String(MakeRange("foob"), true, Base32_Hex));
+			ccstAssertEqual("CPNMUOJ1", ToBase32String(MakeRange("fooba"), true, Base32_Hex));
+			ccstAssertEqual("CPNMUOJ1E8======", ToBase32String(MakeRange("foobar"), true, Base32_Hex));
+			ccstAssertEqual("91IMOR3F5GG7ERRIDHI22", ToBase32String(MakeRange("Hello, world!"), false, Base32_Hex));
+			ccstAssertEqual(FromBase32String("CPNMUOJ1E8======", true, Base32_Hex), MakeRange("foobar"));
+			ccstAssertEqual(FromBase32String("91IMOR3F5GG7ERRIDHI22", false, Base32_Hex), MakeRange("Hello, world!"));
+			
+			ccstAssertEqual("CSQPYRK1E8", ToBase32String(MakeRange("foobar"), false, Base32_Crockford));
+			ccstAssertEqual("91JPRV3F5GG7EVVJDHJ22", ToBase32String(MakeRange("Hello, world!"), false, Base32_Crockford));
+			ccstAssertEqual(FromBase32String("91JPRV3F5GG7EVVJDHJ22", false, Base32_Crockford), MakeRange("Hello, world!"));
+			ccstAssertEqual(FromBase32String("91jprv3f5gg7evvjdhj22", false, Base32_Crockford), MakeRange("Hello, world!"));
+			// Aliases
+			ccstAssertEqual(FromBase32String("0123456789", false, Base32_Crockford), FromBase32String("O1I3456789", false, Base32_Crockford));
+			ccstAssertEqual(FromBase32String("0123456789", false, Base32_Crockford), FromBase32String("oL23456789", false, Base32_Crockford));
+			ccstAssertEqual(FromBase32String("0123456789", false, Base32_Crockford), FromBase32String("0i23456789", false, Base32_Crockford));
+			
+			// Characters which are not in the alphabet
+			ByteArray foo;
+			ccstAssertFalse(Base32_Decode(std::string("CPNMUOJW"), false, foo, Base32_Hex));
+			ccstAssertFalse(Base32_Decode(std::string("cpnmuoj1"), false, foo, Base32_Hex));
+			ccstAssertFalse(Base32_Decode(std::string("CSQPYRKU"), false, foo, Base32_Crockford));
+			ccstAssertFalse(Base32_Decode(std::string("CSQPYRK-"), false, foo, Base32_Crockford));
+			ccstAssertFalse(Base32_Decode(std::string("MZXW6YTB"), false, foo, Base32_Hex));
+			
+			// Round trip for all alphabets
+			ByteArray data = getTestRandomData(200);
+			const Base32_Alphabet alphabets[] = { Base32_Standard, Base32_Hex, Base32_Crockford };
+			for (Base32_Alphabet alphabet : alphabets) {
+				for (size_t length = 0; length <= data.size(); length++) {
+					ByteRange range = data.byteRange().subRange(0, length);
+					std::string encoded;
+					ccstAssertTrue(Base32_Encode(range, true, encoded, alphabet));
+					ByteArray decoded;
+					ccstAssertTrue(Base32_Decode(encoded, true, decoded, alphabet));
+					ccstAssertEqual(decoded, range);
+				}
+			}
+			
+			// The extended hex alphabet preserves sort order
+			for (size_t i = 0; i < 100; i++) {
+				ByteArray a = getTestRandomData(10);
+				ByteArray b = getTestRandomData(10);
+				ccstAssertEqual((a < b), (ToBase32String(a, false, Base32_Hex) < ToBase32String(b, false, Base32_Hex)));
+			}
+		}
 		
 		// MARK: - Wrong data
 		
@@ -194,6 +269,128 @@ namespace tests
 			}
 		}
 		
+		void testInvalidCharacters()
+		{
+			// Every position in the full blocks and in the tail must be validated.
+			ByteArray data = getTestRandomData(23);
+			std::string encoded = ToBase32String(data, false);
+			const char invalid_chars[] = { 'a', 'z', '0', '1', '8', '9', '=', '[', ' ', '\x80', '\xff' };
+			for (size_t i = 0; i < encoded.size(); i++) {
+				for (char c : invalid_chars) {
+					std::string wrong_b32 = encoded;
+					wrong_b32[i] = c;
+					ByteArray foo;
+					bool result = Base32_Decode(wrong_b32, false, foo);
+					ccstAssertFalse(result, "Position %d, char %02x", (int)i, (int)(U8)c);
+					ccstAssertTrue(foo.empty());
+				}
+			}
+		}
+		
+		// MARK: - Streaming
+		
+		void testStreamingEncoder()
+		{
+			ByteArray max_data = getTestRandomData(12000);
+			const size_t sizes[] = { 0, 1, 2, 3, 4, 5, 6, 39, 40, 41, 1000, 2559, 2560, 2561, 12000 };
+			for (int padding = 0; padding < 2; padding++) {
+				for (size_t test_size : sizes) {
+					ByteRange source_data = max_data.byteRange().subRangeTo(test_size);
+					std::string expected = ToBase32String(source_data, padding == 1, Base32_Crockford);
+					for (size_t max_chunk : { 1, 2, 7, 100, 5000 }) {
+						std::string output;
+						Base32Encoder encoder(padding == 1, [&output](const ByteRange & chunk) {
+							output.append(reinterpret_cast<const char*>(chunk.data()), chunk.size());
+						}, Base32_Crockford);
+						size_t offset = 0;
+						while (offset < source_data.size()) {
+							size_t chunk = 1 + (random() % max_chunk);
+							ByteRange range = source_data.subRangeFrom(offset);
+							if (chunk > range.size()) {
+								chunk = range.size();
+							}
+							ccstAssertTrue(encoder.update(range.subRangeTo(chunk)));
+							offset += chunk;
+						}
+						ccstAssertTrue(encoder.finish());
+						ccstAssertEqual(output, expected);
+						if (output != expected) {
+							return;
+						}
+					}
+				}
+			}
+		}
+		
+		// Helper function decodes string with the streaming decoder, in chunks with size
+		// up to |max_chunk| and compares the result with Base32_Decode().
+		bool streamingDecodeMatches(const std::string & input, bool require_padding, size_t max_chunk)
+		{
+			ByteArray expected;
+			bool expected_result = Base32_Decode(input, require_padding, expected);
+			
+			ByteArray output;
+			Base32Decoder decoder(require_padding, [&output](const ByteRange & chunk) {
+				output.append(chunk);
+			});
+			bool result = true;
+			size_t offset = 0;
+			while (offset < input.length()) {
+				size_t chunk = 1 + (random() % max_chunk);
+				ByteRange range = MakeRange(input).subRangeFrom(offset);
+				if (chunk > range.size()) {
+					chunk = range.size();
+				}
+				result = decoder.update(range.subRangeTo(chunk)) && result;
+				offset += chunk;
+			}
+			result = decoder.finish() && result;
+			if (result != expected_result) {
+				return false;
+			}
+			return !result || output == expected;
+		}
+		
+		void testStreamingDecoder()
+		{
+			ByteArray max_data = getTestRandomData(12000);
+			const size_t sizes[] = { 0, 1, 2, 3, 4, 5, 6, 39, 40, 41, 1000, 2559, 2560, 2561, 12000 };
+			for (int padding = 0; padding < 2; padding++) {
+				for (size_t test_size : sizes) {
+					std::string input = ToBase32String(max_data.byteRange().subRangeTo(test_size), padding == 1);
+					for (size_t max_chunk : { 1, 3, 7, 100, 5000 }) {
+						ccstAssertTrue(streamingDecodeMatches(input, padding == 1, max_chunk), "Size %d, chunk %d", (int)test_size, (int)max_chunk);
+					}
+				}
+			}
+			// Valid & invalid strings must be evaluated in the same way as Base32_Decode() does.
+			const char * strings[] = {
+				"MZXW6YTBOI======", "MZXW6YTBOI", "MZXW6YTB", "MZXW6YQ=", "MZXW6YQ",
+				"MZXW6YTB========", "MZXW6YTBOI=====", "MZXW6=TBOI======", "MZXW6YTBO=======",
+				"MZXW6YTBP7======", "MZXW6YTBPZ77", "MZXW6YTBOI======MZXW6YTB", "MZXW6YT]OI======",
+				"========", "=", "", "MY======", "MY", "M", "MZXW6Y"
+			};
+			for (const char * string : strings) {
+				for (int padding = 0; padding < 2; padding++) {
+					ccstAssertTrue(streamingDecodeMatches(string, padding == 1, 1), "String '%s'", string);
+					ccstAssertTrue(streamingDecodeMatches(string, padding == 1, 3), "String '%s'", string);
+					ccstAssertTrue(streamingDecodeMatches(string, padding == 1, 100), "String '%s'", string);
+				}
+			}
+			// Decoder is reusable after the failure
+			ByteArray output;
+			Base32Decoder decoder(true, [&output](const ByteRange & chunk) {
+				output.append(chunk);
+			});
+			ccstAssertFalse(decoder.update(std::string("MZX?6YTBOI")));
+			ccstAssertFalse(decoder.update(std::string("MZXW6YTB")));
+			ccstAssertFalse(decoder.finish());
+			output.clear();
+			ccstAssertTrue(decoder.update(std::string("MZXW6YTBOI======")));
+			ccstAssertTrue(decoder.finish());
+			ccstAssertEqual(CopyToString(output), "foobar");
+		}
+		
 	};
 	
 	CC7_CREATE_UNIT_TEST(cc7Base32Tests, "cc7")
@@ -16,6 +16,7 @@
 
 #include <cc7tests/CC7Tests.h>
 #include <cc7/CC7.h>
+#include <algorithm>
 
 namespace cc7
 {
@@ -31,6 +32,14 @@ namespace tests
 			CC7_REGISTER_TEST_METHOD(testNoWrapBadData);
 			CC7_REGISTER_TEST_METHOD(testWrap);
 			CC7_REGISTER_TEST_METHOD(testWrapBadData);
+			CC7_REGISTER_TEST_METHOD(testReferenceEncoder);
+			CC7_REGISTER_TEST_METHOD(testLongBadData);
+			CC7_REGISTER_TEST_METHOD(testStreamingEncoder);
+			CC7_REGISTER_TEST_METHOD(testStreamingDecoder);
+			CC7_REGISTER_TEST_METHOD(testEncodeToDecodeTo);
+			CC7_REGISTER_TEST_METHOD(testRangeInput);
+			CC7_REGISTER_TEST_METHOD(testParallel);
+			CC7_REGISTER_TEST_METHOD(testVariants);
 		}
 		
 		// UNIT TESTS
@@ -261,6 +270,384 @@ namespace tests
 			result = Base64_Decode(input, 64, output_data);
 			ccstAssertFalse(result);
 		}
+		
+		// Naive, bit by bit implementation of Base64 encoder, used as a reference
+		// for the optimized encoder.
+		static std::string referenceEncode(const ByteRange & data, size_t wrap_size)
+		{
+			const char * alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+			std::string result;
+			size_t full_blocks = data.size() / 3;
+			size_t line_length = 0;
+			for (size_t block = 0; block < full_blocks; block++) {
+				U32 triplet = (data[block * 3] << 16) | (data[block * 3 + 1] << 8) | data[block * 3 + 2];
+				for (int shift = 18; shift >= 0; shift -= 6) {
+					result.push_back(alphabet[(triplet >> shift) & 63]);
+				}
+				line_length += 4;
+				if (wrap_size > 0 && line_length == wrap_size) {
+					result.push_back('\n');
+					line_length = 0;
+				}
+			}
+			size_t rest = data.size() - full_blocks * 3;
+			if (rest > 0) {
+				U32 triplet = data[full_blocks * 3] << 16;
+				if (rest > 1) {
+					triplet |= data[full_blocks * 3 + 1] << 8;
+				}
+				result.push_back(alphabet[(triplet >> 18) & 63]);
+				result.push_back(alphabet[(triplet >> 12) & 63]);
+				result.push_back(rest > 1 ? alphabet[(triplet >> 6) & 63] : '=');
+				result.push_back('=');
+			}
+			return result;
+		}
+		
+		void testReferenceEncoder()
+		{
+			ByteArray max_data = getTestRandomData(1000);
+			const size_t wraps[] = { 0, 4, 8, 64, 76, 128 };
+			for (size_t test_size = 0; test_size < max_data.size(); test_size++) {
+				ByteRange source_data = max_data.byteRange().subRangeTo(test_size);
+				for (size_t wrap_size : wraps) {
+					std::string encoded;
+					bool result = Base64_Encode(source_data, wrap_size, encoded);
+					ccstAssertTrue(result);
+					std::string expected = referenceEncode(source_data, wrap_size);
+					ccstAssertEqual(encoded, expected);
+					if (encoded != expected) {
+						return;
+					}
+					ByteArray decoded;
+					result = Base64_Decode(encoded, wrap_size, decoded);
+					ccstAssertTrue(result);
+					ccstAssertEqual(decoded, source_data);
+				}
+			}
+		}
+		
+		void testLongBadData()
+		{
+			// The long string is processed by the vectorized decoder, so the invalid
+			// character must be detected at any position.
+			ByteArray data = getTestRandomData(300);
+			std::string valid = ToBase64String(data);
+			ByteArray out;
+			for (size_t pos = 0; pos < valid.length(); pos++) {
+				std::string wrong = valid;
+				wrong[pos] = (pos & 1) ? '?' : char(0xC1);
+				bool result = Base64_Decode(wrong, 0, out);
+				ccstAssertFalse(result);
+				ccstAssertTrue(out.empty());
+				if (pos + 1 < valid.length()) {
+					// Padding in the last character is valid
+					wrong[pos] = '=';
+					result = Base64_Decode(wrong, 0, out);
+					ccstAssertFalse(result);
+				}
+			}
+			std::string wrapped = ToBase64String(data, 64);
+			for (size_t pos = 0; pos < wrapped.length(); pos++) {
+				if (wrapped[pos] == '\n') {
+					continue;
+				}
+				std::string wrong = wrapped;
+				wrong[pos] = '-';
+				bool result = Base64_Decode(wrong, 64, out);
+				ccstAssertFalse(result);
+			}
+		}
+		
+		// Helper function decodes string with the streaming decoder, in chunks with size
+		// up to |max_chunk| and compares the result with Base64_Decode().
+		bool streamingDecodeMatches(const std::string & input, size_t wrap_size, size_t max_chunk)
+		{
+			ByteArray expected;
+			bool expected_result = Base64_Decode(input, wrap_size, expected);
+			
+			ByteArray output;
+			Base64Decoder decoder(wrap_size, [&output](const ByteRange & chunk) {
+				output.append(chunk);
+			});
+			bool result = true;
+			size_t offset = 0;
+			while (offset < input.length()) {
+				size_t chunk = 1 + (random() % max_chunk);
+				ByteRange range = MakeRange(input).subRangeFrom(offset);
+				if (chunk > range.size()) {
+					chunk = range.size();
+				}
+				result = decoder.update(range.subRangeTo(chunk)) && result;
+				offset += chunk;
+			}
+			result = decoder.finish() && result;
+			if (result != expected_result) {
+				return false;
+			}
+			return !result || output == expected;
+		}
+		
+		void testStreamingEncoder()
+		{
+			ByteArray max_data = getTestRandomData(12000);
+			const size_t wraps[] = { 0, 4, 64, 76 };
+			const size_t sizes[] = { 0, 1, 2, 3, 4, 5, 47, 48, 49, 1000, 3071, 3072, 3073, 12000 };
+			for (size_t wrap_size : wraps) {
+				for (size_t test_size : sizes) {
+					ByteRange source_data = max_data.byteRange().subRangeTo(test_size);
+					std::string expected = ToBase64String(source_data, wrap_size);
+					for (size_t max_chunk : { 1, 2, 7, 100, 5000 }) {
+						std::string output;
+						Base64Encoder encoder(wrap_size, [&output](const ByteRange & chunk) {
+							output.append(reinterpret_cast<const char*>(chunk.data()), chunk.size());
+						});
+						size_t offset = 0;
+						while (offset < source_data.size()) {
+							size_t chunk = 1 + (random() % max_chunk);
+							ByteRange range = source_data.subRangeFrom(offset);
+							if (chunk > range.size()) {
+								chunk = range.size();
+							}
+							ccstAssertTrue(encoder.update(range.subRangeTo(chunk)));
+							offset += chunk;
+						}
+						ccstAssertTrue(encoder.finish());
+						ccstAssertEqual(output, expected);
+						if (output != expected) {
+							return;
+						}
+					}
+				}
+			}
+			// Invalid wrap
+			Base64Encoder encoder(5, nullptr);
+			ccstAssertFalse(encoder.update(max_data));
+			ccstAssertFalse(encoder.finish());
+		}
+		
+		void testStreamingDecoder()
+		{
+			ByteArray max_data = getTestRandomData(12000);
+			const size_t wraps[] = { 0, 4, 64, 76 };
+			const size_t sizes[] = { 0, 1, 2, 3, 4, 5, 47, 48, 49, 1000, 3071, 3072, 3073, 12000 };
+			for (size_t wrap_size : wraps) {
+				for (size_t test_size : sizes) {
+					std::string input = ToBase64String(max_data.byteRange().subRangeTo(test_size), wrap_size);
+					for (size_t max_chunk : { 1, 3, 7, 100, 5000 }) {
+						ccstAssertTrue(streamingDecodeMatches(input, wrap_size, max_chunk));
+					}
+				}
+			}
+			// Valid & invalid strings must be evaluated in the same way as Base64_Decode() does.
+			const char * strings[] = {
+				"SGVsbG8gd29ybGQ=", "SGVsbG8gd29yZA==", "SGVsbG8gd29ybGQ", "SGVsbG8gd29yZA=",
+				"SGVs_G8gd29ybGQ=", "SGVsbG8gd29y?A==", "SGVsbG8gd29ybA=X", "SGVsbG8gd29yb===",
+				"SGVsbG8gd29y====", "SGV=bG8gd29ybGQ=", "SGVsbG8gd29yZA==\n", " SGVsbG8gd29yZA==",
+				"SGVs\nbG8g\nd29y\nZA==\n", "SGVs\nbG8\ngd29y\nZA==", "SGVs\nZA==\nbG8g",
+				"\n\n  \nSGVsbG8g  \n", "SGVsbG8gd29yZA==   ", "", " ", "===="
+			};
+			for (const char * string : strings) {
+				ccstAssertTrue(streamingDecodeMatches(string, 0, 3));
+				ccstAssertTrue(streamingDecodeMatches(string, 64, 3));
+				ccstAssertTrue(streamingDecodeMatches(string, 64, 100));
+			}
+			// Decoder is reusable after the failure
+			ByteArray output;
+			Base64Decoder decoder(0, [&output](const ByteRange & chunk) {
+				output.append(chunk);
+			});
+			ccstAssertFalse(decoder.update(std::string("SGV?")));
+			ccstAssertFalse(decoder.update(std::string("SGVs")));
+			ccstAssertFalse(decoder.finish());
+			output.clear();
+			ccstAssertTrue(decoder.update(std::string("SGVsbG8gd29yZA==")));
+			ccstAssertTrue(decoder.finish());
+			ccstAssertEqual(CopyToString(output), "Hello word");
+		}
+		
+		void testEncodeToDecodeTo()
+		{
+			ByteArray max_data = getTestRandomData(300);
+			const size_t wraps[] = { 0, 4, 64, 76 };
+			char string_buffer[512];
+			byte data_buffer[512];
+			for (size_t wrap_size : wraps) {
+				for (size_t test_size = 0; test_size < max_data.size(); test_size++) {
+					ByteRange source_data = max_data.byteRange().subRangeTo(test_size);
+					std::string expected = ToBase64String(source_data, wrap_size);
+					size_t length = Base64_EncodedLength(test_size, wrap_size);
+					ccstAssertEqual(length, expected.length());
+					// Encode
+					size_t written = Base64_EncodeTo(source_data, wrap_size, string_buffer, length);
+					ccstAssertEqual(written, length);
+					ccstAssertEqual(std::string(string_buffer, written), expected);
+					if (length > 0) {
+						written = Base64_EncodeTo(source_data, wrap_size, string_buffer, length - 1);
+						ccstAssertEqual(written, ByteRange::npos);
+					}
+					// Decode
+					ByteRange encoded = MakeRange(expected);
+					ccstAssertTrue(Base64_DecodedMaxLength(expected.length()) >= test_size);
+					written = Base64_DecodeTo(encoded, wrap_size, data_buffer, sizeof(data_buffer));
+					ccstAssertEqual(written, test_size);
+					ccstAssertEqualMemSize(data_buffer, source_data.data(), test_size);
+					written = Base64_DecodeTo(encoded, wrap_size, data_buffer, test_size);
+					ccstAssertEqual(written, test_size);
+					if (test_size > 0) {
+						written = Base64_DecodeTo(encoded, wrap_size, data_buffer, test_size - 1);
+						ccstAssertEqual(written, ByteRange::npos);
+					}
+				}
+			}
+			// Invalid input
+			size_t written = Base64_DecodeTo(MakeRange("SGVsbG8gd29y?A=="), 0, data_buffer, sizeof(data_buffer));
+			ccstAssertEqual(written, ByteRange::npos);
+			written = Base64_DecodeTo(MakeRange("SGVsbG8gd29yZA="), 0, data_buffer, sizeof(data_buffer));
+			ccstAssertEqual(written, ByteRange::npos);
+			written = Base64_EncodeTo(max_data, 5, string_buffer, sizeof(string_buffer));
+			ccstAssertEqual(written, ByteRange::npos);
+		}
+		
+		void testRangeInput()
+		{
+			// Base64 string embedded in a larger buffer
+			const char * buffer = "{\"data\":\"SGVsbG8gd29ybGQ=\"}";
+			ByteRange range = MakeRange(buffer).subRange(9, 16);
+			ByteArray out;
+			ccstAssertTrue(Base64_Decode(range, 0, out));
+			ccstAssertEqual(CopyToString(out), "Hello world");
+			ccstAssertTrue(Base64_Decode(buffer + 9, 16, 0, out));
+			ccstAssertEqual(CopyToString(out), "Hello world");
+			ccstAssertFalse(Base64_Decode(buffer + 9, 17, 0, out));
+			ccstAssertTrue(out.empty());
+			ccstAssertEqual(CopyToString(FromBase64String(range)), "Hello world");
+			
+			ByteArray out2;
+			ccstAssertTrue(out2.readFromBase64String(range));
+			ccstAssertEqual(CopyToString(out2), "Hello world");
+			ccstAssertTrue(out2.readFromBase64String(buffer + 9, 16, 64));
+			ccstAssertEqual(CopyToString(out2), "Hello world");
+			
+			// Decode the array's own content
+			ByteArray data = getTestRandomData(1000);
+			ByteArray self = MakeRange(ToBase64String(data, 64));
+			ccstAssertTrue(self.readFromBase64String(self.byteRange(), 64));
+			ccstAssertEqual(self, data);
+		}
+		
+		void testParallel()
+		{
+			// Serial executor, with tasks executed in reversed order
+			Base64_Executor serial = [](size_t tasks_count, const std::function<void (size_t)> & task) {
+				for (size_t index = tasks_count; index > 0; index--) {
+					task(index - 1);
+				}
+			};
+			ByteArray max_data = getTestRandomData(1024 * 1024 + 17);
+			const size_t sizes[] = { 0, 1000, 128 * 1024, 300 * 1024 + 1, 512 * 1024 + 2, max_data.size() };
+			const size_t wraps[] = { 0, 64, 76 };
+			for (size_t size : sizes) {
+				ByteRange source_data = max_data.byteRange().subRangeTo(size);
+				for (size_t wrap : wraps) {
+					std::string expected, encoded;
+					ccstAssertTrue(Base64_Encode(source_data, wrap, expected));
+					ccstAssertTrue(Base64_EncodeParallel(source_data, wrap, encoded, 4, serial));
+					ccstAssertEqual(encoded, expected);
+					ccstAssertTrue(Base64_EncodeParallel(source_data, wrap, encoded));
+					ccstAssertEqual(encoded, expected);
+					
+					ByteArray decoded;
+					ccstAssertTrue(Base64_DecodeParallel(MakeRange(expected), wrap, decoded, 4, serial));
+					ccstAssertEqual(decoded, source_data);
+					ccstAssertTrue(Base64_DecodeParallel(MakeRange(expected), wrap, decoded, 3));
+					ccstAssertEqual(decoded, source_data);
+					
+					if (size < 128 * 1024) {
+						continue;
+					}
+					// Invalid character at the end of the first part
+					std::string wrong = expected;
+					wrong[wrong.size() / 4 - 8] = '?';
+					ccstAssertFalse(Base64_DecodeParallel(MakeRange(wrong), wrap, decoded, 4, serial));
+					ccstAssertTrue(decoded.empty());
+					// Padding in the middle of the string
+					if (wrap > 0) {
+						wrong = "QQ==\n" + expected;
+						ccstAssertFalse(Base64_Decode(MakeRange(wrong), wrap, decoded));
+						ccstAssertFalse(Base64_DecodeParallel(MakeRange(wrong), wrap, decoded, 4, serial));
+					} else {
+						wrong = expected;
+						wrong.replace(wrong.size() / 2, 4, "QQ==");
+						ccstAssertFalse(Base64_DecodeParallel(MakeRange(wrong), wrap, decoded, 4, serial));
+						wrong = expected + "A";
+						ccstAssertFalse(Base64_DecodeParallel(MakeRange(wrong), wrap, decoded, 4, serial));
+					}
+					ccstAssertTrue(decoded.empty());
+				}
+			}
+		}
+		
+		void testVariants()
+		{
+			// Test vectors
+			ByteArray data = { 0xfb, 0xff, 0xbf, 0x3e };
+			ccstAssertEqual(ToBase64String(data), "+/+/Pg==");
+			ccstAssertEqual(ToBase64String(data, 0, Base64_Url), "-_-_Pg==");
+			ccstAssertEqual(ToBase64String(data, 0, Base64_NoPadding), "+/+/Pg");
+			ccstAssertEqual(ToBase64String(data, 0, Base64_UrlNoPadding), "-_-_Pg");
+			ccstAssertEqual(FromBase64String(std::string("-_-_Pg=="), 0, Base64_Url), data);
+			ccstAssertEqual(FromBase64String(std::string("-_-_Pg"), 0, Base64_UrlNoPadding), data);
+			ccstAssertEqual(FromBase64String(std::string("+/+/Pg"), 0, Base64_NoPadding), data);
+			ccstAssertEqual(ToBase64String(MakeRange("fo"), 0, Base64_UrlNoPadding), "Zm8");
+			ccstAssertEqual(ToBase64String(MakeRange("foo"), 0, Base64_UrlNoPadding), "Zm9v");
+			
+			// Compare variants with the standard encoding
+			ByteArray max_data = getTestRandomData(1025);
+			const Base64_Variant variants[] = { Base64_Url, Base64_NoPadding, Base64_UrlNoPadding };
+			const size_t wraps[] = { 0, 4, 64, 76 };
+			for (size_t test_size = 0; test_size < max_data.size(); test_size += 1 + test_size / 16) {
+				ByteRange source_data = max_data.byteRange().subRangeTo(test_size);
+				for (size_t wrap : wraps) {
+					const std::string standard = ToBase64String(source_data, wrap);
+					for (Base64_Variant variant : variants) {
+						std::string expected = standard;
+						if (variant & Base64_Url) {
+							std::replace(expected.begin(), expected.end(), '+', '-');
+							std::replace(expected.begin(), expected.end(), '/', '_');
+						}
+						if (variant & Base64_NoPadding) {
+							expected.erase(std::remove(expected.begin(), expected.end(), '='), expected.end());
+						}
+						std::string encoded;
+						ccstAssertTrue(Base64_Encode(source_data, wrap, encoded, variant));
+						ccstAssertEqual(encoded, expected);
+						ccstAssertEqual(encoded.size(), Base64_EncodedLength(test_size, wrap, variant));
+						
+						ByteArray decoded;
+						ccstAssertTrue(Base64_Decode(encoded, wrap, decoded, variant));
+						ccstAssertEqual(decoded, source_data);
+						ccstAssertTrue(Base64_DecodedMaxLength(encoded.size(), variant) >= test_size);
+						if (encoded.find_first_of("+/-_") != std::string::npos) {
+							// The other alphabet must be rejected
+							ccstAssertFalse(Base64_Decode(encoded, wrap, decoded, Base64_Variant(variant ^ Base64_Url)));
+						}
+					}
+				}
+			}
+			
+			// Invalid strings
+			ByteArray out;
+			ccstAssertFalse(Base64_Decode(std::string("+/+/Pg"), 0, out, Base64_UrlNoPadding));
+			ccstAssertFalse(Base64_Decode(std::string("-_-_Pg"), 0, out, Base64_NoPadding));
+			ccstAssertFalse(Base64_Decode(std::string("-_-_Pg=="), 0, out, Base64_UrlNoPadding));
+			ccstAssertFalse(Base64_Decode(std::string("-_-_Pg="), 0, out, Base64_UrlNoPadding));
+			ccstAssertFalse(Base64_Decode(std::string("-_-_P"), 0, out, Base64_UrlNoPadding));
+			ccstAssertFalse(Base64_Decode(std::string("-_-_Pg"), 0, out, Base64_Url));
+			ccstAssertFalse(Base64_Decode(std::string("Zm8\nZm9v"), 64, out, Base64_UrlNoPadding));
+			ccstAssertTrue(Base64_Decode(std::string("Zm9v\nZm8"), 64, out, Base64_UrlNoPadding));
+			ccstAssertEqual(CopyToString(out), "foofo");
+		}
 	};
 	
 	CC7_CREATE_UNIT_TEST(cc7Base64Tests, "cc7")
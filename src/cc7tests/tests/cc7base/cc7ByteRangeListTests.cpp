@@ -0,0 +1,213 @@
+/*
+ * Copyright 2016 Juraj Durech <durech.juraj@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cc7tests/CC7Tests.h>
+#include <cc7/ByteRangeList.h>
+#include <cc7/Base64.h>
+
+namespace cc7
+{
+namespace tests
+{
+	/*
+	 Simple structure with the same members as POSIX iovec.
+	 */
+	struct TestIOVec
+	{
+		void *	iov_base;
+		size_t	iov_len;
+	};
+	
+	class cc7ByteRangeListTests : public UnitTest
+	{
+	public:
+		cc7ByteRangeListTests()
+		{
+			CC7_REGISTER_TEST_METHOD(testBuildList)
+			CC7_REGISTER_TEST_METHOD(testSubList)
+			CC7_REGISTER_TEST_METHOD(testRemovePrefixSuffix)
+			CC7_REGISTER_TEST_METHOD(testGather)
+			CC7_REGISTER_TEST_METHOD(testEquals)
+			CC7_REGISTER_TEST_METHOD(testStreamingCodec)
+		}
+		
+		ByteArray _data;
+		
+		void setUp()
+		{
+			_data = getTestRandomData(100);
+		}
+		
+		/*
+		 Returns list with segments of |sizes| from the test data.
+		 */
+		ByteRangeList makeList(std::initializer_list<size_t> sizes)
+		{
+			ByteRangeList list;
+			size_t offset = 0;
+			for (size_t size : sizes) {
+				list.append(_data.byteRange().subRange(offset, size));
+				offset += size;
+			}
+			return list;
+		}
+		
+		// Unit tests
+		
+		void testBuildList()
+		{
+			ByteRangeList empty;
+			ccstAssertTrue(empty.empty());
+			ccstAssertEqual(empty.size(), 0);
+			ccstAssertEqual(empty.segmentCount(), 0);
+			ccstAssertTrue(empty.begin() == empty.end());
+			
+			ByteRangeList list = { MakeRange("Hello"), ByteRange(), MakeRange(" "), MakeRange("world") };
+			ccstAssertEqual(list.size(), 11);
+			// Empty segments are ignored
+			ccstAssertEqual(list.segmentCount(), 3);
+			ccstAssertEqual(list.segment(2), MakeRange("world"));
+			list.prepend(MakeRange(">"));
+			list.append(ByteRangeList(MakeRange("!")));
+			ccstAssertEqual(list.segmentCount(), 5);
+			ccstAssertEqual(list.flatten(), ByteArray(MakeRange(">Hello world!")));
+			list.append(list);
+			ccstAssertEqual(list.flatten(), ByteArray(MakeRange(">Hello world!>Hello world!")));
+			ccstAssertEqual(list.at(0), '>');
+			ccstAssertEqual(list.at(6), ' ');
+			ccstAssertEqual(list.at(25), '!');
+			list.clear();
+			ccstAssertTrue(list.empty());
+			ccstAssertEqual(list.segmentCount(), 0);
+		}
+		
+		void testSubList()
+		{
+			ByteRangeList list = makeList({ 10, 1, 20, 5, 30 });
+			ccstAssertEqual(list.size(), 66);
+			ByteRange expected = _data.byteRange().subRangeTo(66);
+			for (size_t from = 0; from <= 66; from++) {
+				for (size_t count = 0; from + count <= 66; count++) {
+					ByteRangeList sub = list.subList(from, count);
+					ccstAssertEqual(sub.size(), count);
+					ccstAssertEqual(sub.flatten(), ByteArray(expected.subRange(from, count)), "from %d, count %d", (int)from, (int)count);
+				}
+			}
+			// Segments in the middle are shared
+			ByteRangeList sub = list.subList(5, 20);
+			ccstAssertEqual(sub.segmentCount(), 3);
+			ccstAssertTrue(sub.segment(1).data() == list.segment(1).data());
+			ccstAssertEqual(list.subListFrom(60).flatten(), ByteArray(expected.subRangeFrom(60)));
+			ccstAssertEqual(list.subListTo(12).flatten(), ByteArray(expected.subRangeTo(12)));
+		}
+		
+		void testRemovePrefixSuffix()
+		{
+			ByteRange expected = _data.byteRange().subRangeTo(36);
+			for (size_t count = 0; count <= 36; count++) {
+				ByteRangeList list = makeList({ 10, 1, 20, 5 });
+				list.removePrefix(count);
+				ccstAssertEqual(list.size(), 36 - count);
+				ccstAssertEqual(list.flatten(), ByteArray(expected.subRangeFrom(count)));
+				
+				list = makeList({ 10, 1, 20, 5 });
+				list.removeSuffix(count);
+				ccstAssertEqual(list.size(), 36 - count);
+				ccstAssertEqual(list.flatten(), ByteArray(expected.subRangeTo(36 - count)));
+			}
+			ByteRangeList list = makeList({ 10, 1, 20, 5 });
+			list.removePrefix(11);
+			ccstAssertEqual(list.segmentCount(), 2);
+			list.removeSuffix(5);
+			ccstAssertEqual(list.segmentCount(), 1);
+		}
+		
+		void testGather()
+		{
+			ByteRangeList list = makeList({ 10, 1, 20, 5 });
+			cc7::byte buffer[40];
+			ccstAssertEqual(list.copyTo(buffer, 40), 36);
+			ccstAssertEqual(ByteRange(buffer, 36), _data.byteRange().subRangeTo(36));
+			ccstAssertEqual(list.copyTo(buffer, 15), 15);
+			ccstAssertEqual(list.copyTo(buffer, 0), 0);
+			
+			ByteArray out = { 0xAA };
+			list.appendTo(out);
+			ccstAssertEqual(out.size(), 37);
+			ccstAssertEqual(out[0], 0xAA);
+			ccstAssertEqual(out.byteRange().subRangeFrom(1), _data.byteRange().subRangeTo(36));
+			
+			// The list references the output array
+			out.shrink_to_fit();
+			ByteArray expected(out);
+			expected.append(out.byteRange());
+			expected.append(_data.byteRange().subRangeTo(5));
+			ByteRangeList self_list;
+			self_list.append(out.byteRange());
+			self_list.append(_data.byteRange().subRangeTo(5));
+			self_list.appendTo(out);
+			ccstAssertEqual(out, expected);
+			
+			TestIOVec iov[3];
+			ccstAssertEqual(list.fillIOVec(iov, 3), 3);
+			ccstAssertTrue(iov[0].iov_base == _data.data());
+			ccstAssertEqual(iov[0].iov_len, 10);
+			ccstAssertTrue(iov[2].iov_base == _data.data() + 11);
+			ccstAssertEqual(iov[2].iov_len, 20);
+			ccstAssertEqual(list.fillIOVec(iov, 0), 0);
+		}
+		
+		void testEquals()
+		{
+			ByteRangeList a = makeList({ 10, 1, 20, 5 });
+			ByteRangeList b = makeList({ 3, 30, 3 });
+			ByteRangeList c(_data.byteRange().subRangeTo(36));
+			ccstAssertTrue(a == b);
+			ccstAssertTrue(a == c);
+			ccstAssertTrue(ByteRangeList() == ByteRangeList());
+			ByteArray copy = _data;
+			copy[35] ^= 1;
+			ByteRangeList d(copy.byteRange().subRangeTo(36));
+			ccstAssertTrue(a != d);
+			ccstAssertTrue(a != makeList({ 10, 1, 20, 4 }));
+		}
+		
+		void testStreamingCodec()
+		{
+			ByteRangeList list = makeList({ 10, 1, 20, 5, 30, 34 });
+			std::string encoded;
+			Base64Encoder encoder(0, [&](const ByteRange & chunk) {
+				encoded.append(chunk.begin(), chunk.end());
+			});
+			ccstAssertTrue(encoder.update(list));
+			ccstAssertTrue(encoder.finish());
+			ccstAssertEqual(encoded, ToBase64String(_data));
+			
+			ByteArray decoded;
+			Base64Decoder decoder(0, [&](const ByteRange & chunk) {
+				decoded.append(chunk);
+			});
+			ByteRangeList string_list = { MakeRange(encoded).subRangeTo(7), MakeRange(encoded).subRangeFrom(7) };
+			ccstAssertTrue(decoder.update(string_list));
+			ccstAssertTrue(decoder.finish());
+			ccstAssertEqual(decoded, _data);
+		}
+	};
+	
+	CC7_CREATE_UNIT_TEST(cc7ByteRangeListTests, "cc7")
+
+} // cc7::tests
+} // cc7
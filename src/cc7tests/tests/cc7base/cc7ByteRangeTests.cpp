@@ -35,6 +35,10 @@ namespace tests
 			CC7_REGISTER_TEST_METHOD(testCornerCases)
 			CC7_REGISTER_TEST_METHOD(testSubRanges)
 			CC7_REGISTER_TEST_METHOD(testOtherMethods)
+			CC7_REGISTER_TEST_METHOD(testFind)
+			CC7_REGISTER_TEST_METHOD(testFindSequence)
+			CC7_REGISTER_TEST_METHOD(testFindFirstOf)
+			CC7_REGISTER_TEST_METHOD(testSplit)
 		}
 		
 		// Helper methods
@@ -233,11 +237,10 @@ namespace tests
 			ByteArray a1c(r1.begin(), r1.end());
 			ccstAssertEqual(a1c, ByteArray({ 1, 2, 3, 4, 5, 6, 7, 8 }));
 			
-			// TODO: right iterator / r-iterator is needed...
-			
-//			ByteRange r2(a1);
-//			ByteArray a2c(r2.rend(), r2.rbegin());
-//			ccstAssertEqual(a2c, ByteArray({ 8, 7, 6, 5, 4, 3, 2, 1 }));
+			ByteRange r2(a1);
+			ByteArray a2c(r2.rbegin(), r2.rend());
+			ccstAssertEqual(a2c, ByteArray({ 8, 7, 6, 5, 4, 3, 2, 1 }));
+			ccstAssertTrue(ByteRange().rbegin() == ByteRange().rend());
 		}
 		
 		void testCornerCases()
@@ -324,6 +327,118 @@ namespace tests
 			ByteRange r2;
 			ccstAssertEqual(cc7::CopyToString(r2), "");
 		}
+		
+		/*
+		 Returns string with |length| characters from a small alphabet, so all
+		 searched bytes and sequences have many occurrences.
+		 */
+		std::string createSearchString(size_t length, size_t seed)
+		{
+			std::string result;
+			for (size_t i = 0; i < length; i++) {
+				seed = seed * 1103515245 + 12345;
+				result.push_back("abc\n"[(seed >> 16) & 3]);
+			}
+			return result;
+		}
+		
+		void testFind()
+		{
+			for (size_t length = 0; length < 80; length++) {
+				const std::string str = createSearchString(length, length);
+				const ByteRange range(str);
+				for (size_t pos = 0; pos <= length + 1; pos++) {
+					for (char c : std::string("abc\nx")) {
+						ccstAssertEqual(range.find((cc7::byte)c, pos), str.find(c, pos), "find %d %d", (int)length, (int)pos);
+						ccstAssertEqual(range.rfind((cc7::byte)c, pos), str.rfind(c, pos), "rfind %d %d", (int)length, (int)pos);
+					}
+				}
+				ccstAssertEqual(range.rfind('a'), str.rfind('a'));
+			}
+			ByteRange empty;
+			ccstAssertEqual(empty.find('a'), ByteRange::npos);
+			ccstAssertEqual(empty.rfind('a'), ByteRange::npos);
+		}
+		
+		void testFindSequence()
+		{
+			const char * needles[] = { "", "a", "ab", "ca", "abc", "\nab", "aaa", "cab\na", "abcabcabcabcabcabc", "x" };
+			for (size_t length = 0; length < 80; length++) {
+				const std::string str = createSearchString(length, length + 100);
+				const ByteRange range(str);
+				for (const char * needle : needles) {
+					for (size_t pos = 0; pos <= length + 1; pos++) {
+						ccstAssertEqual(range.find(MakeRange(needle), pos), str.find(needle, pos), "find '%s' %d %d", needle, (int)length, (int)pos);
+						ccstAssertEqual(range.rfind(MakeRange(needle), pos), str.rfind(needle, pos), "rfind '%s' %d %d", needle, (int)length, (int)pos);
+					}
+					ccstAssertEqual(range.rfind(MakeRange(needle)), str.rfind(needle));
+				}
+			}
+			// Long data, sequence at the end
+			ByteArray data = getTestRandomData(1000);
+			ByteRange sequence = data.byteRange().subRangeFrom(990);
+			ccstAssertEqual(data.byteRange().find(sequence), 990);
+			ccstAssertEqual(data.byteRange().rfind(sequence), 990);
+			ccstAssertEqual(data.byteRange().find(sequence, 991), ByteRange::npos);
+			ccstAssertEqual(data.byteRange().find(data.byteRange()), 0);
+		}
+		
+		void testFindFirstOf()
+		{
+			const char * sets[] = { "", "a", "\n", "bc", "c\n", "xyz", "abc\n", "0123456789c" };
+			for (size_t length = 0; length < 80; length++) {
+				const std::string str = createSearchString(length, length + 200);
+				const ByteRange range(str);
+				for (const char * set : sets) {
+					for (size_t pos = 0; pos <= length + 1; pos++) {
+						ccstAssertEqual(range.find_first_of(MakeRange(set), pos), str.find_first_of(set, pos), "first_of '%s' %d %d", set, (int)length, (int)pos);
+						ccstAssertEqual(range.find_first_not_of(MakeRange(set), pos), str.find_first_not_of(set, pos), "first_not_of '%s' %d %d", set, (int)length, (int)pos);
+					}
+				}
+			}
+			ByteRange whitespace(" \t\n\v\f\r");
+			ccstAssertEqual(MakeRange("QUJD\r\nREVG").find_first_of(whitespace), 4);
+			ccstAssertEqual(MakeRange("QUJD\r\nREVG").find_first_not_of(whitespace, 4), 6);
+		}
+		
+		std::vector<std::string> collectParts(const ByteRangeSplit & parts)
+		{
+			std::vector<std::string> result;
+			for (const ByteRange & part : parts) {
+				result.push_back(CopyToString(part));
+			}
+			return result;
+		}
+		
+		void testSplit()
+		{
+			typedef std::vector<std::string> Parts;
+			std::string s1 = "a,bc,,d";
+			ccstAssertTrue(collectParts(MakeRange(s1).split(',')) == Parts({ "a", "bc", "", "d" }));
+			std::string s2 = ",a,";
+			ccstAssertTrue(collectParts(MakeRange(s2).split(',')) == Parts({ "", "a", "" }));
+			std::string s3 = "";
+			ccstAssertTrue(collectParts(MakeRange(s3).split(',')) == Parts({ "" }));
+			ccstAssertTrue(collectParts(ByteRange().split(',')) == Parts({ "" }));
+			std::string s4 = "abc";
+			ccstAssertTrue(collectParts(MakeRange(s4).split(',')) == Parts({ "abc" }));
+			std::string s5 = "line1\r\nline2\r\n\r\nline4\r";
+			ccstAssertTrue(collectParts(MakeRange(s5).split(MakeRange("\r\n"))) == Parts({ "line1", "line2", "", "line4\r" }));
+			ccstAssertTrue(collectParts(MakeRange(s5).split(ByteRange())) == Parts({ s5 }));
+			
+			// Parts reference the original data and the iterator is lazy
+			ByteRangeSplit parts = MakeRange(s1).split(',');
+			ByteRangeSplit::const_iterator it = parts.begin();
+			ccstAssertTrue(it->data() == (const cc7::byte*)s1.data());
+			ccstAssertEqual(*it, MakeRange("a"));
+			it++;
+			ccstAssertEqual(*it, MakeRange("bc"));
+			ccstAssertTrue(it->data() == (const cc7::byte*)s1.data() + 2);
+			++it; ++it;
+			ccstAssertTrue(it != parts.end());
+			++it;
+			ccstAssertTrue(it == parts.end());
+		}
 	};
 	
 	CC7_CREATE_UNIT_TEST(cc7ByteRangeTests, "cc7")
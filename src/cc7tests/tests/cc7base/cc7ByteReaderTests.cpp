@@ -0,0 +1,247 @@
+/*
+ * Copyright 2016 Juraj Durech <durech.juraj@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cc7tests/CC7Tests.h>
+#include <cc7/ByteReader.h>
+
+namespace cc7
+{
+namespace tests
+{
+	class cc7ByteReaderTests : public UnitTest
+	{
+	public:
+		cc7ByteReaderTests()
+		{
+			CC7_REGISTER_TEST_METHOD(testIntegers)
+			CC7_REGISTER_TEST_METHOD(testStickyError)
+			CC7_REGISTER_TEST_METHOD(testVarint)
+			CC7_REGISTER_TEST_METHOD(testSignedVarint)
+			CC7_REGISTER_TEST_METHOD(testRanges)
+			CC7_REGISTER_TEST_METHOD(testArrays)
+		}
+		
+		// Unit tests
+		
+		void testIntegers()
+		{
+			const cc7::byte bytes[] = {
+				0x01,
+				0x11, 0x22, 0x11, 0x22,
+				0x11, 0x22, 0x33, 0x44, 0x11, 0x22, 0x33, 0x44,
+				0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88
+			};
+			ByteReader reader(ByteRange(bytes, sizeof(bytes)));
+			ccstAssertEqual(reader.remaining(), sizeof(bytes));
+			ccstAssertEqual(reader.readU8(), 0x01);
+			ccstAssertEqual(reader.readU16BE(), 0x1122);
+			ccstAssertEqual(reader.readU16LE(), 0x2211);
+			ccstAssertEqual(reader.position(), 5);
+			ccstAssertEqual(reader.readU32BE(), 0x11223344);
+			ccstAssertEqual(reader.readU32LE(), 0x44332211);
+			ccstAssertEqual(reader.readU64BE(), 0x1122334455667788ULL);
+			ccstAssertFalse(reader.atEnd());
+			ccstAssertEqual(reader.readU64LE(), 0x8877665544332211ULL);
+			ccstAssertTrue(reader.atEnd());
+			ccstAssertFalse(reader.hasError());
+			ccstAssertEqual(reader.position(), sizeof(bytes));
+			
+			ByteReader empty;
+			ccstAssertTrue(empty.atEnd());
+			ccstAssertEqual(empty.readU8(), 0);
+			ccstAssertTrue(empty.hasError());
+		}
+		
+		void testStickyError()
+		{
+			ByteArray data = { 0x11, 0x22, 0x33 };
+			ByteReader reader(data);
+			ccstAssertEqual(reader.readU16BE(), 0x1122);
+			ccstAssertEqual(reader.readU32BE(), 0);
+			ccstAssertTrue(reader.hasError());
+			// The remaining byte is not available after the error
+			ccstAssertEqual(reader.readU8(), 0);
+			ccstAssertTrue(reader.hasError());
+			ccstAssertTrue(reader.atEnd());
+			
+			ByteReader reader2(data);
+			ccstAssertTrue(reader2.canRead(3));
+			ccstAssertFalse(reader2.canRead(4));
+			ccstAssertTrue(reader2.skip(1));
+			ccstAssertFalse(reader2.skip(3));
+			ccstAssertTrue(reader2.hasError());
+			
+			ByteReader reader3(data);
+			ccstAssertEqual(reader3.readU8(), 0x11);
+			reader3.setError();
+			ccstAssertTrue(reader3.hasError());
+			ccstAssertEqual(reader3.readU8(), 0);
+		}
+		
+		U64 readVarint(const ByteArray & data, bool expected_error = false)
+		{
+			ByteReader reader(data);
+			U64 value = reader.readVarint();
+			ccstAssertEqual(reader.hasError(), expected_error);
+			ccstAssertEqual(reader.atEnd(), true);
+			return value;
+		}
+		
+		int64_t readSignedVarint(const ByteArray & data, bool expected_error = false)
+		{
+			ByteReader reader(data);
+			int64_t value = reader.readSignedVarint();
+			ccstAssertEqual(reader.hasError(), expected_error);
+			ccstAssertEqual(reader.atEnd(), true);
+			return value;
+		}
+		
+		void testVarint()
+		{
+			ccstAssertEqual(readVarint({ 0x00 }), 0);
+			ccstAssertEqual(readVarint({ 0x01 }), 1);
+			ccstAssertEqual(readVarint({ 0x7F }), 127);
+			ccstAssertEqual(readVarint({ 0x80, 0x01 }), 128);
+			ccstAssertEqual(readVarint({ 0xAC, 0x02 }), 300);
+			ccstAssertEqual(readVarint({ 0xE5, 0x8E, 0x26 }), 624485);
+			ccstAssertEqual(readVarint({ 0xFF, 0xFF, 0xFF, 0xFF, 0x0F }), 0xFFFFFFFFULL);
+			ccstAssertEqual(readVarint({ 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01 }), 0xFFFFFFFFFFFFFFFFULL);
+			// Non-minimal encoding is accepted
+			ccstAssertEqual(readVarint({ 0x81, 0x80, 0x00 }), 1);
+			// Errors
+			ccstAssertEqual(readVarint({ }, true), 0);
+			ccstAssertEqual(readVarint({ 0x80 }, true), 0);
+			ccstAssertEqual(readVarint({ 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x02 }, true), 0);
+			ccstAssertEqual(readVarint({ 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x00 }, true), 0);
+			
+			// Sequence of values
+			ByteArray data = { 0x96, 0x01, 0x05, 0xAC, 0x02 };
+			ByteReader reader(data);
+			ccstAssertEqual(reader.readVarint(), 150);
+			ccstAssertEqual(reader.readVarint(), 5);
+			ccstAssertEqual(reader.readVarint(), 300);
+			ccstAssertTrue(reader.atEnd());
+			ccstAssertFalse(reader.hasError());
+		}
+		
+		void testSignedVarint()
+		{
+			ccstAssertEqual(readSignedVarint({ 0x00 }), 0);
+			ccstAssertEqual(readSignedVarint({ 0x02 }), 2);
+			ccstAssertEqual(readSignedVarint({ 0x7E }), -2);
+			ccstAssertEqual(readSignedVarint({ 0x7F }), -1);
+			ccstAssertEqual(readSignedVarint({ 0x3F }), 63);
+			ccstAssertEqual(readSignedVarint({ 0x40 }), -64);
+			ccstAssertEqual(readSignedVarint({ 0xC0, 0x00 }), 64);
+			ccstAssertEqual(readSignedVarint({ 0x80, 0x7F }), -128);
+			ccstAssertEqual(readSignedVarint({ 0xC0, 0xBB, 0x78 }), -123456);
+			ccstAssertEqual(readSignedVarint({ 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00 }), INT64_MAX);
+			ccstAssertEqual(readSignedVarint({ 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x7F }), INT64_MIN);
+			// Errors
+			ccstAssertEqual(readSignedVarint({ }, true), 0);
+			ccstAssertEqual(readSignedVarint({ 0xFF }, true), 0);
+			ccstAssertEqual(readSignedVarint({ 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x7F }, true), 0);
+		}
+		
+		void testRanges()
+		{
+			ByteArray data = {
+				0x03, 'a', 'b', 'c',
+				0x00, 0x02, 'd', 'e',
+				0x01, 0x00, 'f',
+				0x00, 0x00, 0x00, 0x00,
+				0x02, 0x00, 0x00, 0x00, 'g', 'h',
+				0x03, 'i', 'j', 'k',
+				'x', 'y', 'z'
+			};
+			ByteReader reader(data);
+			ccstAssertEqual(reader.readRange(ByteReader::U8_Length), MakeRange("abc"));
+			ccstAssertEqual(reader.readRange(ByteReader::U16BE_Length), MakeRange("de"));
+			ccstAssertEqual(reader.readRange(ByteReader::U16LE_Length), MakeRange("f"));
+			ByteRange empty = reader.readRange(ByteReader::U32BE_Length);
+			ccstAssertTrue(empty.empty());
+			ccstAssertEqual(reader.readRange(ByteReader::U32LE_Length), MakeRange("gh"));
+			ByteRange ijk = reader.readRange(ByteReader::Varint_Length);
+			ccstAssertEqual(ijk, MakeRange("ijk"));
+			// Sub-range points to the original data
+			ccstAssertTrue(ijk.data() == data.data() + 22);
+			ccstAssertEqual(reader.remainingRange(), MakeRange("xyz"));
+			char xy[2];
+			ccstAssertTrue(reader.readBytes(xy, 2));
+			ccstAssertTrue(xy[0] == 'x' && xy[1] == 'y');
+			ccstAssertFalse(reader.hasError());
+			ccstAssertEqual(reader.readRange(1), MakeRange("z"));
+			ccstAssertTrue(reader.atEnd());
+			ccstAssertFalse(reader.hasError());
+			
+			// Length exceeds the data
+			ByteArray truncated = { 0x04, 'a', 'b', 'c' };
+			ByteReader reader2(truncated);
+			ccstAssertTrue(reader2.readRange(ByteReader::U8_Length).empty());
+			ccstAssertTrue(reader2.hasError());
+			ByteReader reader3(truncated);
+			ccstAssertTrue(reader3.readRange(5).empty());
+			ccstAssertTrue(reader3.hasError());
+			ByteReader reader4(truncated);
+			ccstAssertFalse(reader4.readBytes(xy, 5));
+			ccstAssertTrue(reader4.hasError());
+			ByteReader reader5(truncated);
+			ccstAssertTrue(reader5.readRange(ByteReader::U32BE_Length).empty());
+			ccstAssertTrue(reader5.hasError());
+			
+			// Zero length reads succeed, even on an empty range
+			ByteReader empty_reader;
+			ccstAssertTrue(empty_reader.skip(0));
+			ccstAssertTrue(empty_reader.readBytes(xy, 0));
+			ccstAssertTrue(empty_reader.readRange(0).empty());
+			ccstAssertFalse(empty_reader.hasError());
+			ccstAssertFalse(empty_reader.skip(1));
+			ccstAssertTrue(empty_reader.hasError());
+		}
+		
+		void testArrays()
+		{
+			ByteArray data = { 0x00, 0x01, 0x00, 0x02, 0x03, 0x00, 0x04, 0x00 };
+			U16 be[2] = { 0, 0 }, le[2] = { 0, 0 };
+			ByteReader reader(data);
+			ccstAssertTrue(reader.readArrayBE(be, 2));
+			ccstAssertTrue(reader.readArrayLE(le, 2));
+			ccstAssertTrue(reader.atEnd());
+			ccstAssertEqual(be[0], 1);
+			ccstAssertEqual(be[1], 2);
+			ccstAssertEqual(le[0], 3);
+			ccstAssertEqual(le[1], 4);
+			
+			U32 u32[3] = { 0, 0, 0 };
+			ByteReader reader2(data);
+			ccstAssertFalse(reader2.readArrayBE(u32, 3));
+			ccstAssertTrue(reader2.hasError());
+			ccstAssertEqual(u32[0], 0);
+			ByteReader reader3(data);
+			ccstAssertFalse(reader3.readArrayBE(u32, (size_t)-1));
+			ccstAssertTrue(reader3.hasError());
+			ByteReader reader4(data);
+			ccstAssertTrue(reader4.readArrayBE(u32, 0));
+			ccstAssertTrue(reader4.readArrayBE(u32, 2));
+			ccstAssertEqual(u32[0], 0x00010002);
+			ccstAssertEqual(u32[1], 0x03000400);
+		}
+	};
+	
+	CC7_CREATE_UNIT_TEST(cc7ByteReaderTests, "cc7")
+
+} // cc7::tests
+} // cc7
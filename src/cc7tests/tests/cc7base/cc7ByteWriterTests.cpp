@@ -0,0 +1,326 @@
+/*
+ * Copyright 2016 Juraj Durech <durech.juraj@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cc7tests/CC7Tests.h>
+#include <cc7/ByteWriter.h>
+
+namespace cc7
+{
+namespace tests
+{
+	class cc7ByteWriterTests : public UnitTest
+	{
+	public:
+		cc7ByteWriterTests()
+		{
+			CC7_REGISTER_TEST_METHOD(testIntegers)
+			CC7_REGISTER_TEST_METHOD(testReservation)
+			CC7_REGISTER_TEST_METHOD(testFixedBuffer)
+			CC7_REGISTER_TEST_METHOD(testVarint)
+			CC7_REGISTER_TEST_METHOD(testRanges)
+			CC7_REGISTER_TEST_METHOD(testPlaceholders)
+			CC7_REGISTER_TEST_METHOD(testArrays)
+		}
+		
+		// Unit tests
+		
+		void testIntegers()
+		{
+			const cc7::byte expected[] = {
+				0x01,
+				0x11, 0x22, 0x22, 0x11,
+				0x11, 0x22, 0x33, 0x44, 0x44, 0x33, 0x22, 0x11,
+				0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x88, 0x77, 0x66, 0x55, 0x44, 0x33, 0x22, 0x11
+			};
+			ByteArray data;
+			{
+				ByteWriter writer(data);
+				writer.writeU8(0x01);
+				writer.writeU16BE(0x1122);
+				writer.writeU16LE(0x1122);
+				writer.writeU32BE(0x11223344);
+				writer.writeU32LE(0x11223344);
+				writer.writeU64BE(0x1122334455667788ULL);
+				writer.writeU64LE(0x1122334455667788ULL);
+				ccstAssertEqual(writer.position(), sizeof(expected));
+				ccstAssertEqual(writer.writtenRange(), ByteRange(expected, sizeof(expected)));
+				ccstAssertFalse(writer.hasError());
+			}
+			// The destructor sets the final size
+			ccstAssertEqual(data, ByteArray(expected, expected + sizeof(expected)));
+		}
+		
+		void testReservation()
+		{
+			ByteArray payload = getTestRandomData(1000);
+			ByteArray data = { 0xAA, 0xBB };
+			ByteWriter writer(data, 1000 + 4);
+			const cc7::byte * ptr = data.data();
+			ccstAssertEqual(data.capacity(), 1006);
+			writer.writeU32BE(1000);
+			writer.writeRange(payload);
+			writer.finish();
+			// No reallocation was performed
+			ccstAssertTrue(ptr == data.data());
+			ccstAssertEqual(data.size(), 1006);
+			ccstAssertEqual(data[0], 0xAA);
+			ccstAssertEqual(data[1], 0xBB);
+			ccstAssertEqual(data.byteRange().subRangeFrom(6), payload.byteRange());
+			
+			// The writer can be still used after finish()
+			writer.writeU8(0xCC);
+			writer.finish();
+			ccstAssertEqual(data.size(), 1007);
+			ccstAssertEqual(data[1006], 0xCC);
+			
+			// Exponential growth
+			ByteArray data2;
+			{
+				ByteWriter writer2(data2);
+				for (U32 i = 0; i < 10000; i++) {
+					writer2.writeU32LE(i);
+				}
+				ccstAssertTrue(writer2.reserve(1));
+			}
+			ccstAssertEqual(data2.size(), 40000);
+			ByteReader reader(data2);
+			for (U32 i = 0; i < 10000; i++) {
+				ccstAssertEqual(reader.readU32LE(), i);
+			}
+			
+			// Empty writer doesn't change the array
+			ByteArray data3 = { 1, 2, 3 };
+			{
+				ByteWriter writer3(data3);
+			}
+			ccstAssertEqual(data3, ByteArray({ 1, 2, 3 }));
+		}
+		
+		void testFixedBuffer()
+		{
+			cc7::byte buffer[6] = { 0 };
+			ByteWriter writer(buffer, sizeof(buffer));
+			ccstAssertTrue(writer.reserve(6));
+			writer.writeU16BE(0x1122);
+			writer.writeU32BE(0x33445566);
+			ccstAssertFalse(writer.hasError());
+			ccstAssertEqual(writer.writtenRange(), ByteRange(buffer, 6));
+			writer.writeU8(0x77);
+			ccstAssertTrue(writer.hasError());
+			ccstAssertEqual(writer.position(), 6);
+			
+			// The error is sticky
+			ByteWriter writer2(buffer, sizeof(buffer));
+			writer2.writeU8(0x01);
+			writer2.writeU64BE(0);
+			ccstAssertTrue(writer2.hasError());
+			writer2.writeU8(0x02);
+			ccstAssertEqual(writer2.position(), 1);
+			ccstAssertEqual(buffer[0], 0x01);
+			ccstAssertEqual(buffer[1], 0x22);
+			
+			ByteWriter writer3(buffer, sizeof(buffer));
+			ccstAssertFalse(writer3.reserve(7));
+			ccstAssertTrue(writer3.hasError());
+			
+			ByteWriter writer4(nullptr, 0);
+			writer4.writeBytes(nullptr, 0);
+			ccstAssertFalse(writer4.hasError());
+			writer4.writeU8(1);
+			ccstAssertTrue(writer4.hasError());
+		}
+		
+		void testVarint()
+		{
+			const U64 values[] = {
+				0, 1, 63, 64, 127, 128, 300, 16383, 16384, 624485, 0xFFFFFFFFULL,
+				0x7FFFFFFFFFFFFFFFULL, 0x8000000000000000ULL, 0xFFFFFFFFFFFFFFFFULL
+			};
+			ByteArray data;
+			ByteWriter writer(data);
+			size_t expected_size = 0;
+			for (U64 v : values) {
+				writer.writeVarint(v);
+				writer.writeSignedVarint((int64_t)v);
+				writer.writeSignedVarint(-(int64_t)(v >> 1));
+				expected_size += ByteWriter::VarintSize(v);
+				expected_size += ByteWriter::SignedVarintSize((int64_t)v);
+				expected_size += ByteWriter::SignedVarintSize(-(int64_t)(v >> 1));
+			}
+			ccstAssertEqual(writer.position(), expected_size);
+			writer.finish();
+			
+			ByteReader reader(data);
+			for (U64 v : values) {
+				ccstAssertEqual(reader.readVarint(), v);
+				ccstAssertEqual(reader.readSignedVarint(), (int64_t)v);
+				ccstAssertEqual(reader.readSignedVarint(), -(int64_t)(v >> 1));
+			}
+			ccstAssertTrue(reader.atEnd());
+			ccstAssertFalse(reader.hasError());
+			
+			// Known encodings
+			ByteArray known;
+			ByteWriter writer2(known);
+			writer2.writeVarint(300);
+			writer2.writeSignedVarint(-128);
+			writer2.writeSignedVarint(64);
+			writer2.writeSignedVarint(-1);
+			writer2.finish();
+			ccstAssertEqual(known, ByteArray({ 0xAC, 0x02, 0x80, 0x7F, 0xC0, 0x00, 0x7F }));
+			ccstAssertEqual(ByteWriter::VarintSize(0xFFFFFFFFFFFFFFFFULL), 10);
+			ccstAssertEqual(ByteWriter::SignedVarintSize(INT64_MIN), 10);
+			ccstAssertEqual(ByteWriter::SignedVarintSize(-64), 1);
+			ccstAssertEqual(ByteWriter::SignedVarintSize(64), 2);
+		}
+		
+		void testRanges()
+		{
+			ByteArray long_data = getTestRandomData(300);
+			ByteArray data;
+			{
+				ByteWriter writer(data);
+				writer.writeRange(MakeRange("abc"), ByteReader::U8_Length);
+				writer.writeRange(MakeRange("de"), ByteReader::U16BE_Length);
+				writer.writeRange(MakeRange("f"), ByteReader::U16LE_Length);
+				writer.writeRange(ByteRange(), ByteReader::U32BE_Length);
+				writer.writeRange(MakeRange("gh"), ByteReader::U32LE_Length);
+				writer.writeRange(long_data, ByteReader::Varint_Length);
+				writer.writeBytes("xyz", 3);
+				ccstAssertFalse(writer.hasError());
+			}
+			ccstAssertEqual(data.byteRange().subRange(0, 11), ByteRange("\x03" "abc" "\x00\x02" "de" "\x01\x00" "f", 11));
+			ByteReader reader(data);
+			ccstAssertEqual(reader.readRange(ByteReader::U8_Length), MakeRange("abc"));
+			ccstAssertEqual(reader.readRange(ByteReader::U16BE_Length), MakeRange("de"));
+			ccstAssertEqual(reader.readRange(ByteReader::U16LE_Length), MakeRange("f"));
+			ccstAssertTrue(reader.readRange(ByteReader::U32BE_Length).empty());
+			ccstAssertEqual(reader.readRange(ByteReader::U32LE_Length), MakeRange("gh"));
+			ccstAssertEqual(reader.readRange(ByteReader::Varint_Length), long_data.byteRange());
+			ccstAssertEqual(reader.readRange(3), MakeRange("xyz"));
+			ccstAssertTrue(reader.atEnd());
+			ccstAssertFalse(reader.hasError());
+			
+			// Written range passed back to the writer, with reallocations
+			ByteArray data_self;
+			{
+				ByteWriter writer(data_self);
+				writer.writeRange(MakeRange("abc"));
+				for (size_t i = 0; i < 6; i++) {
+					writer.writeRange(writer.writtenRange());
+				}
+				writer.writeRange(writer.writtenRange().subRangeFrom(190), ByteReader::U8_Length);
+				ccstAssertFalse(writer.hasError());
+			}
+			ccstAssertEqual(data_self.size(), 192 + 1 + 2);
+			for (size_t i = 0; i < 192; i++) {
+				ccstAssertEqual(data_self[i], "abc"[i % 3]);
+			}
+			ccstAssertEqual(data_self.byteRange().subRangeFrom(192), ByteRange("\x02" "bc", 3));
+			
+			// Length doesn't fit into the prefix
+			ByteArray data2;
+			ByteWriter writer2(data2);
+			writer2.writeU8(1);
+			writer2.writeRange(long_data, ByteReader::U8_Length);
+			ccstAssertTrue(writer2.hasError());
+			ccstAssertEqual(writer2.position(), 1);
+			// The error is sticky for the array target too
+			writer2.writeU8(2);
+			writer2.writeRange(MakeRange("abc"));
+			ccstAssertEqual(writer2.position(), 1);
+			writer2.finish();
+			ccstAssertEqual(data2, ByteArray({ 1 }));
+		}
+		
+		void testPlaceholders()
+		{
+			ByteArray data;
+			ByteWriter writer(data);
+			writer.writeU8(0x01);
+			size_t length_pos = writer.writePlaceholder(4);
+			ccstAssertEqual(length_pos, 1);
+			writer.writeRange(MakeRange("payload"));
+			ccstAssertTrue(writer.patchU32BE(length_pos, U32(writer.position() - length_pos - 4)));
+			ccstAssertTrue(writer.patchU8(0, 0x02));
+			writer.finish();
+			ccstAssertEqual(data.byteRange(), ByteRange("\x02\x00\x00\x00\x07payload", 12));
+			
+			// Patch beyond written data
+			ccstAssertFalse(writer.patchU32LE(9, 0));
+			ccstAssertTrue(writer.hasError());
+			
+			cc7::byte buffer[4];
+			ByteWriter writer2(buffer, sizeof(buffer));
+			ccstAssertEqual(writer2.writePlaceholder(2), 0);
+			ccstAssertEqual(writer2.writePlaceholder(4), ByteRange::npos);
+			ccstAssertTrue(writer2.hasError());
+		}
+		
+		void testArrays()
+		{
+			U32 values[100];
+			for (U32 i = 0; i < 100; i++) {
+				values[i] = 0x01020304 * (i + 1);
+			}
+			ByteArray data;
+			{
+				ByteWriter writer(data);
+				writer.writeU8(0);
+				writer.writeArrayBE(values, 100);
+				writer.writeArrayLE(values, 100);
+				writer.writeArrayBE(values, 0);
+				ccstAssertFalse(writer.hasError());
+			}
+			ccstAssertEqual(data.size(), 801);
+			ByteReader reader(data);
+			reader.readU8();
+			for (U32 i = 0; i < 100; i++) {
+				ccstAssertEqual(reader.readU32BE(), values[i]);
+			}
+			for (U32 i = 0; i < 100; i++) {
+				ccstAssertEqual(reader.readU32LE(), values[i]);
+			}
+			
+			// Short arrays don't reallocate the target on each write
+			ByteArray data3;
+			{
+				ByteWriter writer(data3);
+				size_t reallocations = 0;
+				size_t capacity = data3.capacity();
+				for (size_t i = 0; i < 1000; i++) {
+					writer.writeArrayBE(values, 4);
+					if (data3.capacity() != capacity) {
+						capacity = data3.capacity();
+						reallocations++;
+					}
+				}
+				ccstAssertTrue(reallocations <= 16);
+			}
+			ccstAssertEqual(data3.size(), 16000);
+			
+			cc7::byte buffer[10];
+			ByteWriter writer2(buffer, sizeof(buffer));
+			writer2.writeArrayBE(values, 3);
+			ccstAssertTrue(writer2.hasError());
+			ccstAssertEqual(writer2.position(), 0);
+		}
+	};
+	
+	CC7_CREATE_UNIT_TEST(cc7ByteWriterTests, "cc7")
+
+} // cc7::tests
+} // cc7
@@ -0,0 +1,193 @@
+/*
+ * Copyright 2016 Juraj Durech <durech.juraj@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cc7tests/CC7Tests.h>
+#include <cc7/CodecBatch.h>
+
+namespace cc7
+{
+namespace tests
+{
+	class cc7CodecBatchTests : public UnitTest
+	{
+	public:
+		cc7CodecBatchTests()
+		{
+			CC7_REGISTER_TEST_METHOD(testHexString)
+			CC7_REGISTER_TEST_METHOD(testBase64)
+			CC7_REGISTER_TEST_METHOD(testBase32)
+			CC7_REGISTER_TEST_METHOD(testInvalidStrings)
+			CC7_REGISTER_TEST_METHOD(testCapturedInput)
+		}
+		
+		// Helper functions
+		
+		std::vector<ByteRange> makeItems(const ByteArray & data, size_t count, size_t max_size)
+		{
+			std::vector<ByteRange> items;
+			size_t offset = 0;
+			for (size_t i = 0; i < count; i++) {
+				// Some items are empty, some are longer than the internal gather buffer.
+				size_t size = (i % 50 == 7) ? 1500 : random() % (max_size + 1);
+				if (offset + size > data.size()) {
+					offset = 0;
+				}
+				items.push_back(data.byteRange().subRange(offset, size));
+				offset += size;
+			}
+			return items;
+		}
+		
+		std::vector<ByteRange> makeRanges(const std::string & string, const std::vector<size_t> & offsets)
+		{
+			std::vector<ByteRange> ranges;
+			for (size_t i = 0; i + 1 < offsets.size(); i++) {
+				ranges.push_back(MakeRange(string).subRange(offsets[i], offsets[i + 1] - offsets[i]));
+			}
+			return ranges;
+		}
+		
+		bool matches(const std::vector<ByteRange> & items, const ByteArray & data, const std::vector<size_t> & offsets)
+		{
+			if (offsets.size() != items.size() + 1 || offsets.back() != data.size()) {
+				return false;
+			}
+			for (size_t i = 0; i < items.size(); i++) {
+				if (data.byteRange().subRange(offsets[i], offsets[i + 1] - offsets[i]) != items[i]) {
+					return false;
+				}
+			}
+			return true;
+		}
+		
+		// Unit tests
+		
+		void testHexString()
+		{
+			ByteArray data = getTestRandomData(4000);
+			std::vector<ByteRange> items = makeItems(data, 300, 40);
+			for (bool lowercase : { false, true }) {
+				std::string encoded;
+				std::vector<size_t> offsets;
+				ccstAssertTrue(HexString_EncodeBatch(items, lowercase, encoded, offsets));
+				ccstAssertEqual(offsets.size(), items.size() + 1);
+				for (size_t i = 0; i < items.size(); i++) {
+					ccstAssertEqual(encoded.substr(offsets[i], offsets[i + 1] - offsets[i]), ToHexString(items[i], lowercase));
+				}
+				ByteArray decoded;
+				std::vector<size_t> decoded_offsets;
+				ccstAssertTrue(HexString_DecodeBatch(makeRanges(encoded, offsets), decoded, decoded_offsets));
+				ccstAssertTrue(matches(items, decoded, decoded_offsets));
+			}
+			// Odd strings are decoded as in HexString_Decode()
+			std::vector<ByteRange> strings = { MakeRange("ABC"), MakeRange("0102"), MakeRange("F"), MakeRange(""), MakeRange("fffe") };
+			ByteArray decoded;
+			std::vector<size_t> offsets;
+			ccstAssertTrue(HexString_DecodeBatch(strings, decoded, offsets));
+			ccstAssertEqual(decoded, ByteArray({ 0x0A, 0xBC, 0x01, 0x02, 0x0F, 0xFF, 0xFE }));
+			ccstAssertEqual(offsets, std::vector<size_t>({ 0, 2, 4, 5, 5, 7 }));
+		}
+		
+		void testBase64()
+		{
+			ByteArray data = getTestRandomData(4000);
+			std::vector<ByteRange> items = makeItems(data, 300, 40);
+			for (Base64_Variant variant : { Base64_Standard, Base64_Url, Base64_NoPadding, Base64_UrlNoPadding }) {
+				std::string encoded;
+				std::vector<size_t> offsets;
+				ccstAssertTrue(Base64_EncodeBatch(items, encoded, offsets, variant));
+				ccstAssertEqual(offsets.size(), items.size() + 1);
+				for (size_t i = 0; i < items.size(); i++) {
+					ccstAssertEqual(encoded.substr(offsets[i], offsets[i + 1] - offsets[i]), ToBase64String(items[i], 0, variant));
+				}
+				ByteArray decoded;
+				std::vector<size_t> decoded_offsets;
+				ccstAssertTrue(Base64_DecodeBatch(makeRanges(encoded, offsets), decoded, decoded_offsets, variant));
+				ccstAssertTrue(matches(items, decoded, decoded_offsets));
+			}
+		}
+		
+		void testBase32()
+		{
+			ByteArray data = getTestRandomData(4000);
+			std::vector<ByteRange> items = makeItems(data, 300, 40);
+			for (Base32_Alphabet alphabet : { Base32_Standard, Base32_Hex, Base32_Crockford }) {
+				for (bool padding : { false, true }) {
+					std::string encoded;
+					std::vector<size_t> offsets;
+					ccstAssertTrue(Base32_EncodeBatch(items, padding, encoded, offsets, alphabet));
+					ccstAssertEqual(offsets.size(), items.size() + 1);
+					for (size_t i = 0; i < items.size(); i++) {
+						ccstAssertEqual(encoded.substr(offsets[i], offsets[i + 1] - offsets[i]), ToBase32String(items[i], padding, alphabet));
+					}
+					ByteArray decoded;
+					std::vector<size_t> decoded_offsets;
+					ccstAssertTrue(Base32_DecodeBatch(makeRanges(encoded, offsets), padding, decoded, decoded_offsets, alphabet));
+					ccstAssertTrue(matches(items, decoded, decoded_offsets));
+				}
+			}
+		}
+		
+		void testInvalidStrings()
+		{
+			ByteArray decoded;
+			std::vector<size_t> offsets;
+			std::vector<ByteRange> hex = { MakeRange("0102"), MakeRange("01X2"), MakeRange("0304") };
+			ccstAssertFalse(HexString_DecodeBatch(hex, decoded, offsets));
+			ccstAssertTrue(decoded.empty());
+			ccstAssertTrue(offsets.empty());
+			hex = { MakeRange("0102"), MakeRange("X"), MakeRange("0304") };
+			ccstAssertFalse(HexString_DecodeBatch(hex, decoded, offsets));
+			
+			std::vector<ByteRange> b64 = { MakeRange("SGVsbG8="), MakeRange("SGVsbG8") };
+			ccstAssertFalse(Base64_DecodeBatch(b64, decoded, offsets));
+			ccstAssertFalse(Base64_DecodeBatch(b64, decoded, offsets, Base64_NoPadding));
+			ccstAssertTrue(decoded.empty());
+			ccstAssertTrue(offsets.empty());
+			
+			std::vector<ByteRange> b32 = { MakeRange("MZXW6YQ="), MakeRange("MZXW6YQ") };
+			ccstAssertFalse(Base32_DecodeBatch(b32, true, decoded, offsets));
+			ccstAssertFalse(Base32_DecodeBatch(b32, false, decoded, offsets));
+			ccstAssertTrue(decoded.empty());
+			ccstAssertTrue(offsets.empty());
+			
+			// Empty batch
+			std::string encoded = "foo";
+			ccstAssertTrue(Base64_EncodeBatch(std::vector<ByteRange>(), encoded, offsets));
+			ccstAssertTrue(encoded.empty());
+			ccstAssertEqual(offsets, std::vector<size_t>({ 0 }));
+			ccstAssertTrue(Base32_DecodeBatch(std::vector<ByteRange>(), false, decoded, offsets));
+			ccstAssertTrue(decoded.empty());
+			ccstAssertEqual(offsets, std::vector<size_t>({ 0 }));
+		}
+		
+		void testCapturedInput()
+		{
+			// Strings captured from the output array must not be overwritten during decoding.
+			ByteArray data(MakeRange("0102030405"));
+			data.reserve(100);
+			std::vector<size_t> offsets;
+			std::vector<ByteRange> strings = { data.byteRange().subRange(0, 4), data.byteRange().subRange(4, 6) };
+			ccstAssertTrue(HexString_DecodeBatch(strings, data, offsets));
+			ccstAssertEqual(data, ByteArray({ 0x01, 0x02, 0x03, 0x04, 0x05 }));
+			ccstAssertEqual(offsets, std::vector<size_t>({ 0, 2, 5 }));
+		}
+	};
+	
+	CC7_CREATE_UNIT_TEST(cc7CodecBatchTests, "cc7")
+
+} // cc7::tests
+} // cc7
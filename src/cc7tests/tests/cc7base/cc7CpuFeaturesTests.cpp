@@ -0,0 +1,105 @@
+/*
+ * Copyright 2016 Juraj Durech <durech.juraj@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cc7tests/CC7Tests.h>
+#include <cc7/CpuFeatures.h>
+
+namespace cc7
+{
+namespace tests
+{
+	class cc7CpuFeaturesTests : public UnitTest
+	{
+	public:
+		cc7CpuFeaturesTests()
+		{
+			CC7_REGISTER_TEST_METHOD(testDetection)
+			CC7_REGISTER_TEST_METHOD(testFeaturesToString)
+			CC7_REGISTER_TEST_METHOD(testSelect)
+		}
+		
+		// Unit tests
+		
+		void testDetection()
+		{
+			U32 features = cpu::GetFeatures();
+			ccstMessage("CPU features: %s", cpu::FeaturesToString(features).c_str());
+			ccstAssertEqual(features, cpu::GetFeatures());
+			ccstAssertTrue(cpu::HasFeatures(0));
+			ccstAssertTrue(cpu::HasFeatures(features));
+			
+#if defined(__x86_64__) || defined(_M_X64)
+			// SSE2 is a part of x86_64
+			ccstAssertTrue(cpu::HasFeatures(cpu::SSE2));
+#endif
+#if defined(__aarch64__)
+			ccstAssertTrue(cpu::HasFeatures(cpu::NEON));
+#endif
+			// Features in the same family imply older ones
+			if (features & cpu::AVX2) {
+				ccstAssertTrue(cpu::HasFeatures(cpu::AVX | cpu::SSSE3));
+			}
+			if (features & cpu::AVX512BW) {
+				ccstAssertTrue(cpu::HasFeatures(cpu::AVX512F));
+			}
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+			// Compare with the compiler's detection
+			__builtin_cpu_init();
+			ccstAssertEqual(cpu::HasFeatures(cpu::SSSE3), (__builtin_cpu_supports("ssse3") != 0));
+			ccstAssertEqual(cpu::HasFeatures(cpu::SSE42), (__builtin_cpu_supports("sse4.2") != 0));
+			ccstAssertEqual(cpu::HasFeatures(cpu::AVX2), (__builtin_cpu_supports("avx2") != 0));
+#endif
+		}
+		
+		void testFeaturesToString()
+		{
+			ccstAssertEqual(cpu::FeaturesToString(0), "");
+			ccstAssertEqual(cpu::FeaturesToString(cpu::SSE2), "sse2");
+			ccstAssertEqual(cpu::FeaturesToString(cpu::AVX2 | cpu::SSE2 | cpu::SSE41), "sse2,sse4.1,avx2");
+			ccstAssertEqual(cpu::FeaturesToString(cpu::NEON), "neon");
+		}
+		
+		static int _ImplAvx2()   { return 2; }
+		static int _ImplSsse3()  { return 1; }
+		static int _ImplScalar() { return 0; }
+		
+		void testSelect()
+		{
+			typedef int (*Function)();
+			static const cpu::Candidate<Function> candidates[] = {
+				{ cpu::AVX2 | cpu::AVX, _ImplAvx2 },
+				{ cpu::SSSE3, _ImplSsse3 },
+				{ 0, _ImplScalar },
+			};
+			ccstAssertEqual(cpu::Select(candidates, 0)(), 0);
+			ccstAssertEqual(cpu::Select(candidates, cpu::SSE2)(), 0);
+			ccstAssertEqual(cpu::Select(candidates, cpu::SSSE3)(), 1);
+			ccstAssertEqual(cpu::Select(candidates, cpu::SSSE3 | cpu::AVX2)(), 1);
+			ccstAssertEqual(cpu::Select(candidates, cpu::SSSE3 | cpu::AVX | cpu::AVX2)(), 2);
+			ccstAssertEqual(cpu::Select(candidates, cpu::AVX | cpu::AVX2)(), 2);
+			
+			// Only fallback
+			static const cpu::Candidate<Function> fallback[] = {
+				{ 0, _ImplScalar },
+			};
+			ccstAssertEqual(cpu::Select(fallback)(), 0);
+		}
+	};
+	
+	CC7_CREATE_UNIT_TEST(cc7CpuFeaturesTests, "cc7")
+
+} // cc7::tests
+} // cc7
@@ -28,6 +28,9 @@ namespace tests
 		cc7HexStringTests()
 		{
 			CC7_REGISTER_TEST_METHOD(testEncodeDecode);
+			CC7_REGISTER_TEST_METHOD(testLongData);
+			CC7_REGISTER_TEST_METHOD(testInvalidCharacters);
+			CC7_REGISTER_TEST_METHOD(testEncodeToDecodeTo);
 		}
 		
 		// UNIT TESTS
@@ -104,7 +107,110 @@ namespace tests
 			ccstAssertFalse(result);
 			ccstAssertEqual(d.size(), 0);
 		}
-
+		
+		// Reference encoder
+		static std::string encodeReference(const ByteRange & data, bool lowercase)
+		{
+			const char * table = lowercase ? "0123456789abcdef" : "0123456789ABCDEF";
+			std::string result;
+			for (byte b : data) {
+				result.push_back(table[b >> 4]);
+				result.push_back(table[b & 15]);
+			}
+			return result;
+		}
+		
+		void testLongData()
+		{
+			// Covers vectorized and scalar paths, with all possible tails
+			ByteArray data = getTestRandomData(300);
+			for (size_t s = 0; s <= data.size(); s++) {
+				ByteRange range = data.byteRange().subRangeTo(s);
+				std::string upper = ToHexString(range);
+				std::string lower = ToHexString(range, true);
+				ccstAssertEqual(upper, encodeReference(range, false));
+				ccstAssertEqual(lower, encodeReference(range, true));
+				
+				// mixed case
+				std::string mixed = upper;
+				for (size_t i = 0; i < mixed.size(); i += 3) {
+					mixed[i] = lower[i];
+				}
+				ByteArray decoded;
+				ccstAssertTrue(HexString_Decode(mixed, decoded));
+				ccstAssertEqual(decoded, range);
+				
+				// odd length, the first character is decoded as a whole byte
+				if (s > 0) {
+					ccstAssertTrue(HexString_Decode(lower.substr(1), decoded));
+					ccstAssertEqual(decoded.size(), s);
+					ccstAssertEqual(decoded[0], (range[0] & 15));
+					ccstAssertEqual(decoded.byteRange().subRangeFrom(1), range.subRangeFrom(1));
+				}
+			}
+		}
+		
+		void testInvalidCharacters()
+		{
+			// Characters around the valid ranges
+			const char invalid[] = { '/', ':', '@', 'G', '`', 'g', ' ', '\x00', '\x7f', '\x80', '\xb0', '\xc1', '\xe6' };
+			const std::string valid = ToHexString(getTestRandomData(65));
+			for (char c : invalid) {
+				for (size_t len = 129; len <= 130; len++) {
+					for (size_t i = 0; i < len; i++) {
+						std::string hex = valid.substr(0, len);
+						hex[i] = c;
+						ByteArray d;
+						bool result = HexString_Decode(hex, d);
+						ccstAssertFalse(result, "Character %02x at position %d", (int)(byte)c, (int)i);
+						ccstAssertTrue(d.empty());
+					}
+				}
+			}
+		}
+		
+		void testEncodeToDecodeTo()
+		{
+			ccstAssertEqual(HexString_EncodedLength(0), 0);
+			ccstAssertEqual(HexString_EncodedLength(32), 64);
+			ccstAssertEqual(HexString_DecodedLength(0), 0);
+			ccstAssertEqual(HexString_DecodedLength(63), 32);
+			ccstAssertEqual(HexString_DecodedLength(64), 32);
+			
+			// Digest into the stack buffer
+			const ByteArray digest = getTestRandomData(32);
+			char hex[64];
+			ccstAssertEqual(HexString_EncodeTo(digest, hex, sizeof(hex), true), 64);
+			ccstAssertEqual(std::string(hex, 64), ToHexString(digest, true));
+			ccstAssertEqual(HexString_EncodeTo(digest, hex, sizeof(hex)), 64);
+			ccstAssertEqual(std::string(hex, 64), ToHexString(digest));
+			ccstAssertEqual(HexString_EncodeTo(digest, hex, 63), ByteRange::npos);
+			ccstAssertEqual(HexString_EncodeTo(ByteRange(), nullptr, 0), 0);
+			
+			cc7::byte bytes[32];
+			ccstAssertEqual(HexString_DecodeTo(ByteRange(hex, 64), bytes, sizeof(bytes)), 32);
+			ccstAssertEqual(ByteRange(bytes, 32), digest);
+			ccstAssertEqual(HexString_DecodeTo(ByteRange(hex, 64), bytes, 31), ByteRange::npos);
+			ccstAssertEqual(HexString_DecodeTo(ByteRange(hex, 63), bytes, 32), 32);
+			hex[10] = 'x';
+			ccstAssertEqual(HexString_DecodeTo(ByteRange(hex, 64), bytes, sizeof(bytes)), ByteRange::npos);
+			
+			// Hex captured in a larger buffer
+			const std::string message = "digest=48656C6C6F;";
+			ByteArray d;
+			ccstAssertTrue(HexString_Decode(MakeRange(message).subRange(7, 10), d));
+			ccstAssertEqual(CopyToString(d), "Hello");
+			ccstAssertTrue(HexString_Decode(message.c_str() + 7, 10, d));
+			ccstAssertEqual(CopyToString(d), "Hello");
+			ccstAssertFalse(HexString_Decode(MakeRange(message).subRange(7, 11), d));
+			ccstAssertTrue(d.empty());
+			
+			// Decode own content
+			d.assign(MakeRange("48656C6C6F"));
+			ccstAssertTrue(d.readFromHexString(d.byteRange()));
+			ccstAssertEqual(CopyToString(d), "Hello");
+		}
+	
 	};
 	
 	CC7_CREATE_UNIT_TEST(cc7HexStringTests, "cc7")
@@ -16,6 +16,7 @@
 
 #include <cc7tests/CC7Tests.h>
 #include <cc7/CC7.h>
+#include <cc7tests/PerformanceTimer.h>
 
 namespace cc7
 {
@@ -32,6 +33,8 @@ namespace tests
 			CC7_REGISTER_TEST_METHOD(testEndian32)
 			CC7_REGISTER_TEST_METHOD(testEndian64)
 			CC7_REGISTER_TEST_METHOD(testEndianIntrinsics)
+			CC7_REGISTER_TEST_METHOD(testEndianArrays)
+			CC7_REGISTER_TEST_METHOD(testPerformanceTimer)
 		}
 		
 		void testPlatformBits()
@@ -67,6 +70,75 @@ namespace tests
 #endif
 		}
 		
+		template <typename T>
+		void checkEndianArray()
+		{
+			// All lengths cover the vector and scalar loops.
+			ByteArray random = getTestRandomData(200 * sizeof(T));
+			std::vector<T> source(200);
+			memcpy(source.data(), random.data(), random.size());
+			for (size_t count = 0; count <= 130; count++) {
+				std::vector<T> expected_be(count), expected_le(count);
+				for (size_t i = 0; i < count; i++) {
+					expected_be[i] = ToBigEndian(source[i]);
+					expected_le[i] = ToLittleEndian(source[i]);
+				}
+				std::vector<T> out(count + 1, 0);
+				ToBigEndian(source.data(), out.data(), count);
+				ccstAssertTrue(std::equal(expected_be.begin(), expected_be.end(), out.begin()), "Count %d", (int)count);
+				ccstAssertEqual(out[count], 0);
+				FromBigEndian(out.data(), count);
+				ccstAssertTrue(std::equal(out.begin(), out.begin() + count, source.begin()), "Count %d", (int)count);
+				
+				ToLittleEndian(source.data(), out.data(), count);
+				ccstAssertTrue(std::equal(expected_le.begin(), expected_le.end(), out.begin()), "Count %d", (int)count);
+				FromLittleEndian(out.data(), out.data(), count);
+				ccstAssertTrue(std::equal(out.begin(), out.begin() + count, source.begin()), "Count %d", (int)count);
+				
+				// In place, with unaligned position in the array
+				std::vector<T> data(source.begin() + 1, source.begin() + 1 + count);
+				ToBigEndian(data.data(), count);
+				for (size_t i = 0; i < count; i++) {
+					ccstAssertEqual(data[i], ToBigEndian(source[i + 1]));
+				}
+				FromBigEndian(data.data(), data.data(), count);
+				ccstAssertTrue(std::equal(data.begin(), data.end(), source.begin() + 1));
+			}
+		}
+		
+		void testEndianArrays()
+		{
+			checkEndianArray<cc7::U16>();
+			checkEndianArray<cc7::U32>();
+			checkEndianArray<cc7::U64>();
+			
+			cc7::U32 values[3] = { 0x11223344, 0x55667788, 0x99AABBCC };
+			cc7::byte bytes_be[12] = { 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xAA, 0xBB, 0xCC };
+			cc7::U32 be[3];
+			ToBigEndian(values, be, 3);
+			ccstAssertEqualMemArray(be, bytes_be);
+		}
+		
+		void testPerformanceTimer()
+		{
+			// The platform timer must be monotonic
+			cc7::U64 previous = Platform_GetCurrentTime();
+			for (int i = 0; i < 1000; i++) {
+				cc7::U64 current = Platform_GetCurrentTime();
+				ccstAssertTrue(current >= previous);
+				previous = current;
+			}
+			PerformanceTimer timer;
+			timer.start();
+			volatile cc7::U32 sum = 0;
+			for (cc7::U32 i = 0; i < 100000; i++) {
+				sum += i;
+			}
+			double elapsed = timer.elapsedTime();
+			ccstAssertTrue(elapsed >= 0.0);
+			ccstAssertTrue(elapsed < 10000.0);
+		}
+		
 		void testEndianIntrinsics()
 		{
 #if !defined(CC7_BSWAP_16)
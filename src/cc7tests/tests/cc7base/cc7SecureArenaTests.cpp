@@ -0,0 +1,198 @@
+/*
+ * Copyright 2016 Juraj Durech <durech.juraj@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cc7tests/CC7Tests.h>
+#include <cc7/SecureArena.h>
+#include <cc7/Base64.h>
+
+namespace cc7
+{
+namespace tests
+{
+	class cc7SecureArenaTests : public UnitTest
+	{
+	public:
+		cc7SecureArenaTests()
+		{
+			CC7_REGISTER_TEST_METHOD(testAllocations)
+			CC7_REGISTER_TEST_METHOD(testDedicatedBlocks)
+			CC7_REGISTER_TEST_METHOD(testReset)
+			CC7_REGISTER_TEST_METHOD(testExplicitAllocator)
+			CC7_REGISTER_TEST_METHOD(testScope)
+			CC7_REGISTER_TEST_METHOD(testMoveAndSwap)
+		}
+		
+		// Unit tests
+		
+		void testAllocations()
+		{
+			SecureArena arena(1024);
+			ccstAssertEqual(arena.usedSize(), 0);
+			ccstAssertEqual(arena.reservedSize(), 0);
+			
+			cc7::byte * p1 = static_cast<cc7::byte*>(arena.allocate(10));
+			cc7::byte * p2 = static_cast<cc7::byte*>(arena.allocate(20));
+			ccstAssertNotNull(p1);
+			ccstAssertNotNull(p2);
+			ccstAssertTrue(p2 == p1 + 16);
+			ccstAssertEqual((reinterpret_cast<size_t>(p2) & 15), 0);
+			ccstAssertEqual(arena.usedSize(), 48);
+			ccstAssertEqual(arena.reservedSize(), 1024);
+			
+			// the most recent allocation is returned back to the block
+			arena.deallocate(p2, 20);
+			cc7::byte * p3 = static_cast<cc7::byte*>(arena.allocate(30));
+			ccstAssertTrue(p3 == p2);
+			// older allocations stay in the arena
+			arena.deallocate(p1, 10);
+			cc7::byte * p4 = static_cast<cc7::byte*>(arena.allocate(10));
+			ccstAssertTrue(p4 == p3 + 32);
+			
+			// fill the first block, the next allocation goes to a new block
+			for (size_t i = 0; i < 20; i++) {
+				ccstAssertNotNull(arena.allocate(200));
+			}
+			ccstAssertTrue(arena.reservedSize() > 1024);
+		}
+		
+		void testDedicatedBlocks()
+		{
+			SecureArena arena(1024);
+			void * small = arena.allocate(16);
+			void * large = arena.allocate(1000);
+			ccstAssertNotNull(large);
+			ccstAssertEqual(arena.reservedSize(), 1024 + 1008);
+			// dedicated block is released immediately
+			arena.deallocate(large, 1000);
+			ccstAssertEqual(arena.reservedSize(), 1024);
+			// regular block continues after the small allocation
+			void * next = arena.allocate(16);
+			ccstAssertTrue(next == static_cast<cc7::byte*>(small) + 16);
+		}
+		
+		void testReset()
+		{
+			SecureArena arena(1024);
+			cc7::byte * p1 = static_cast<cc7::byte*>(arena.allocate(64));
+			memset(p1, 0xAA, 64);
+			arena.deallocate(p1, 64);
+			ccstAssertEqual(arena.usedSize(), 0);
+			arena.allocate(2000);
+			ccstAssertEqual(arena.reservedSize(), 1024 + 2000);
+			
+			arena.reset();
+			ccstAssertEqual(arena.usedSize(), 0);
+			ccstAssertEqual(arena.reservedSize(), 1024);
+			// memory is wiped and the block is reused
+			for (size_t i = 0; i < 64; i++) {
+				ccstAssertEqual(p1[i], 0);
+			}
+			cc7::byte * p2 = static_cast<cc7::byte*>(arena.allocate(64));
+			ccstAssertTrue(p1 == p2);
+		}
+		
+		void testExplicitAllocator()
+		{
+			SecureArena arena;
+			ByteArray::allocator_type allocator(&arena);
+			{
+				ByteArray data(allocator);
+				ccstAssertTrue(data.get_allocator().resource() == &arena);
+				ByteArray reference;
+				ccstAssertNull(reference.get_allocator().resource());
+				for (size_t i = 0; i < 1000; i++) {
+					cc7::byte b = random() & 0xFF;
+					data.push_back(b);
+					reference.push_back(b);
+				}
+				ccstAssertEqual(data, reference);
+				ccstAssertTrue(arena.usedSize() >= 1000);
+				
+				ByteArray decoded(allocator);
+				ccstAssertTrue(Base64_Decode(ToBase64String(reference), 0, decoded));
+				ccstAssertEqual(decoded, reference);
+			}
+			ccstAssertEqual(arena.usedSize(), 0);
+			arena.reset();
+		}
+		
+		void testScope()
+		{
+			SecureArena arena1;
+			SecureArena arena2;
+			ccstAssertNull(SecureArena::current());
+			{
+				SecureArena::Scope scope1(arena1);
+				ccstAssertTrue(SecureArena::current() == &arena1);
+				ByteArray a1 = { 1, 2, 3 };
+				ccstAssertTrue(a1.get_allocator().resource() == &arena1);
+				{
+					SecureArena::Scope scope2(arena2);
+					// copies use the current resource
+					ByteArray a2 = a1;
+					ccstAssertTrue(a2.get_allocator().resource() == &arena2);
+					ByteArray a3(a1.begin(), a1.end());
+					ccstAssertTrue(a3.get_allocator().resource() == &arena2);
+					ccstAssertEqual(a2, a3);
+				}
+				ccstAssertTrue(SecureArena::current() == &arena1);
+			}
+			ccstAssertNull(SecureArena::current());
+			ByteArray heap = { 1 };
+			ccstAssertNull(heap.get_allocator().resource());
+			
+			{
+				// copy made out of the scope doesn't live in the arena
+				ByteArray::allocator_type allocator(&arena1);
+				ByteArray arena_data(3, 0xAA, allocator);
+				ByteArray heap_copy(arena_data);
+				ccstAssertNull(heap_copy.get_allocator().resource());
+				ccstAssertEqual(heap_copy, arena_data);
+			}
+			arena1.reset();
+			arena2.reset();
+			ccstAssertEqual(arena1.usedSize(), 0);
+			ccstAssertEqual(arena2.usedSize(), 0);
+		}
+		
+		void testMoveAndSwap()
+		{
+			SecureArena arena;
+			ByteArray::allocator_type allocator(&arena);
+			ByteArray heap_data = getTestRandomData(100);
+			ByteArray arena_data(allocator);
+			arena_data.assign(MakeRange("Hello world"));
+			
+			// the arena follows the content
+			heap_data.swap(arena_data);
+			ccstAssertTrue(heap_data.get_allocator().resource() == &arena);
+			ccstAssertNull(arena_data.get_allocator().resource());
+			ccstAssertEqual(CopyToString(heap_data), "Hello world");
+			ccstAssertEqual(arena_data.size(), 100);
+			
+			ByteArray moved = std::move(heap_data);
+			ccstAssertTrue(moved.get_allocator().resource() == &arena);
+			ccstAssertEqual(CopyToString(moved), "Hello world");
+			moved = std::move(arena_data);
+			ccstAssertNull(moved.get_allocator().resource());
+			ccstAssertEqual(moved.size(), 100);
+		}
+	};
+	
+	CC7_CREATE_UNIT_TEST(cc7SecureArenaTests, "cc7")
+
+} // cc7::tests
+} // cc7
@@ -0,0 +1,296 @@
+/*
+ * Copyright 2016 Juraj Durech <durech.juraj@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cc7tests/CC7Tests.h>
+#include <cc7/SecureBuffer.h>
+
+namespace cc7
+{
+namespace tests
+{
+	/*
+	 Memory resource which counts allocated and released bytes.
+	 */
+	class CountingResource : public SecureMemoryResource
+	{
+	public:
+		size_t allocations_count = 0;
+		size_t allocated_size = 0;
+		size_t released_size = 0;
+		
+		void * allocate(size_t size) override
+		{
+			allocations_count++;
+			allocated_size += size;
+			return ::operator new(size);
+		}
+		
+		void deallocate(void * ptr, size_t size) override
+		{
+			released_size += size;
+			CC7_SecureClean(ptr, size);
+			::operator delete(ptr);
+		}
+	};
+	
+	class cc7SecureBufferTests : public UnitTest
+	{
+	public:
+		cc7SecureBufferTests()
+		{
+			CC7_REGISTER_TEST_METHOD(testAppend)
+			CC7_REGISTER_TEST_METHOD(testGrowthPolicy)
+			CC7_REGISTER_TEST_METHOD(testReserveAndShrink)
+			CC7_REGISTER_TEST_METHOD(testMappedBuffer)
+			CC7_REGISTER_TEST_METHOD(testAssignment)
+			CC7_REGISTER_TEST_METHOD(testResource)
+		}
+		
+		// Unit tests
+		
+		void testAppend()
+		{
+			SecureBuffer buffer;
+			ccstAssertTrue(buffer.empty());
+			ccstAssertEqual(buffer.capacity(), 0);
+			ccstAssertNull(buffer.data());
+			
+			buffer.append(MakeRange("Hello"));
+			buffer.append(' ');
+			buffer.append(3, '!');
+			buffer.push_back('?');
+			ccstAssertEqual(buffer.byteRange(), MakeRange("Hello !!!?"));
+			ccstAssertEqual(buffer.capacity(), SecureBuffer::MinimumCapacity);
+			ccstAssertEqual(buffer.front(), 'H');
+			ccstAssertEqual(buffer.back(), '?');
+			ccstAssertEqual(buffer.at(1), 'e');
+			
+			buffer.pop_back();
+			buffer.resize(7);
+			ccstAssertEqual(buffer.byteRange(), MakeRange("Hello !"));
+			buffer.resize(9, 'x');
+			ccstAssertEqual(buffer.byteRange(), MakeRange("Hello !xx"));
+			
+			// Appending from own content, with and without reallocation
+			buffer.append(buffer.byteRange().subRange(0, 5));
+			ccstAssertEqual(buffer.byteRange(), MakeRange("Hello !xxHello"));
+			while (buffer.size() < buffer.capacity()) {
+				buffer.push_back('.');
+			}
+			size_t size = buffer.size();
+			buffer.append(buffer.byteRange());
+			ccstAssertEqual(buffer.size(), 2 * size);
+			ccstAssertEqual(buffer.byteRange().subRangeTo(size), buffer.byteRange().subRangeFrom(size));
+			
+			// Appending own element, with reallocation
+			while (buffer.size() < buffer.capacity()) {
+				buffer.push_back('.');
+			}
+			buffer.push_back(buffer[0]);
+			ccstAssertEqual(buffer.back(), 'H');
+			while (buffer.size() < buffer.capacity()) {
+				buffer.push_back('.');
+			}
+			buffer.append(3, buffer[1]);
+			ccstAssertEqual(buffer.byteRange().subRangeFrom(buffer.size() - 3), MakeRange("eee"));
+			
+			ByteArray data = getTestRandomData(1000);
+			SecureBuffer large;
+			for (size_t i = 0; i < data.size(); i += 7) {
+				large.append(data.byteRange().subRange(i, std::min<size_t>(7, data.size() - i)));
+			}
+			ccstAssertEqual(large.byteRange(), data);
+			
+			large.secureClear();
+			ccstAssertTrue(large.empty());
+			ccstAssertTrue(large.capacity() >= 1000);
+			ccstAssertEqual(ByteRange(large.data(), 1000), ByteArray(1000, 0));
+		}
+		
+		void testGrowthPolicy()
+		{
+			CountingResource resource;
+			{
+				// Byte by byte appending allocates only log(N) times and the total
+				// released memory is lower than the final capacity.
+				SecureBuffer buffer(&resource);
+				for (size_t i = 0; i < 100000; i++) {
+					buffer.push_back((cc7::byte)i);
+				}
+				ccstAssertTrue(resource.allocations_count <= 13);
+				ccstAssertTrue(resource.released_size < buffer.capacity());
+				ccstAssertTrue(buffer.capacity() < 2 * 100000);
+			}
+			ccstAssertEqual(resource.allocated_size, resource.released_size);
+			
+			resource = CountingResource();
+			{
+				// The reserve() follows the same policy, so it doesn't lead to
+				// the quadratic behavior.
+				SecureBuffer buffer(&resource);
+				for (size_t i = 0; i < 10000; i++) {
+					buffer.reserve(buffer.size() + 1);
+					buffer.push_back((cc7::byte)i);
+				}
+				ccstAssertTrue(resource.allocations_count <= 10);
+				ccstAssertTrue(resource.released_size < buffer.capacity());
+			}
+		}
+		
+		void testReserveAndShrink()
+		{
+			SecureBuffer buffer(nullptr);
+			buffer.reserve_exact(10);
+			ccstAssertEqual(buffer.capacity(), 10);
+			buffer.reserve_exact(5);
+			ccstAssertEqual(buffer.capacity(), 10);
+			buffer.reserve(11);
+			ccstAssertEqual(buffer.capacity(), SecureBuffer::MinimumCapacity);
+			buffer.reserve(100);
+			ccstAssertEqual(buffer.capacity(), 100);
+			
+			buffer.append(MakeRange("Secret"));
+			buffer.shrink_to_fit_secure();
+			ccstAssertEqual(buffer.capacity(), 6);
+			ccstAssertEqual(buffer.byteRange(), MakeRange("Secret"));
+			
+			// Bytes beyond the size are cleaned
+			buffer.resize(2);
+			buffer.shrink_to_fit_secure();
+			ccstAssertEqual(buffer.capacity(), 2);
+			ccstAssertEqual(buffer.byteRange(), MakeRange("Se"));
+			
+			buffer.clear();
+			buffer.shrink_to_fit_secure();
+			ccstAssertEqual(buffer.capacity(), 0);
+			ccstAssertNull(buffer.data());
+		}
+		
+		void testMappedBuffer()
+		{
+			const size_t size = 4 * SecureBuffer::MappedCapacity + 123;
+			ByteArray data = getTestRandomData(size);
+			SecureBuffer buffer(nullptr);
+			for (size_t i = 0; i < size; i += 1000) {
+				buffer.append(data.byteRange().subRange(i, std::min<size_t>(1000, size - i)));
+			}
+			ccstAssertEqual(buffer.byteRange(), data);
+#if defined(CC7_LINUX) || defined(CC7_ANDROID)
+			ccstAssertTrue(buffer.isMapped());
+#endif
+			buffer.shrink_to_fit_secure();
+			ccstAssertTrue(buffer.capacity() >= size);
+			ccstAssertTrue(buffer.capacity() < size + 64 * 1024);
+			ccstAssertEqual(buffer.byteRange(), data);
+			
+			// Shrink in place, and then back to the heap
+			buffer.resize(2 * SecureBuffer::MappedCapacity);
+			buffer.shrink_to_fit_secure();
+			ccstAssertEqual(buffer.byteRange(), data.byteRange().subRangeTo(2 * SecureBuffer::MappedCapacity));
+			buffer.resize(1000);
+			buffer.shrink_to_fit_secure();
+			ccstAssertFalse(buffer.isMapped());
+			ccstAssertEqual(buffer.capacity(), 1000);
+			ccstAssertEqual(buffer.byteRange(), data.byteRange().subRangeTo(1000));
+			
+			// Appending own element to the full mapped buffer
+			SecureBuffer mapped(nullptr);
+			mapped.reserve_exact(SecureBuffer::MappedCapacity);
+			mapped.append(data.byteRange().subRangeTo(mapped.capacity()));
+			mapped.push_back(mapped[10]);
+			ccstAssertEqual(mapped.back(), data[10]);
+			ccstAssertEqual(mapped.byteRange().subRangeTo(mapped.size() - 1), data.byteRange().subRangeTo(mapped.size() - 1));
+			while (mapped.size() < mapped.capacity()) {
+				mapped.push_back(0);
+			}
+			mapped.append(2, mapped[20]);
+			ccstAssertEqual(mapped.back(), data[20]);
+			
+			// Exact reservation of a mapped buffer
+			SecureBuffer exact(nullptr);
+			exact.reserve_exact(SecureBuffer::MappedCapacity + 1);
+			ccstAssertTrue(exact.capacity() > SecureBuffer::MappedCapacity);
+			exact.append(data.byteRange().subRangeTo(exact.capacity()));
+			ccstAssertEqual(exact.byteRange(), data.byteRange().subRangeTo(exact.capacity()));
+		}
+		
+		void testAssignment()
+		{
+			SecureBuffer a(MakeRange("Hello world"));
+			ccstAssertEqual(a.capacity(), 11);
+			SecureBuffer b(a);
+			ccstAssertEqual(b.byteRange(), MakeRange("Hello world"));
+			
+			b = MakeRange("Bye");
+			ccstAssertEqual(b.byteRange(), MakeRange("Bye"));
+			b = a.byteRange().subRangeFrom(6);
+			ccstAssertEqual(b.byteRange(), MakeRange("world"));
+			// Assignment from own content
+			b = b.byteRange().subRangeFrom(1);
+			ccstAssertEqual(b.byteRange(), MakeRange("orld"));
+			b = b;
+			ccstAssertEqual(b.byteRange(), MakeRange("orld"));
+			
+			SecureBuffer c(std::move(a));
+			ccstAssertTrue(a.empty());
+			ccstAssertNull(a.data());
+			ccstAssertEqual(c.byteRange(), MakeRange("Hello world"));
+			a = std::move(c);
+			ccstAssertEqual(a.byteRange(), MakeRange("Hello world"));
+			ccstAssertTrue(c.empty());
+			
+			a.swap(b);
+			ccstAssertEqual(a.byteRange(), MakeRange("orld"));
+			ccstAssertEqual(b.byteRange(), MakeRange("Hello world"));
+			
+			ByteArray array(b);
+			ccstAssertEqual(array, MakeRange("Hello world"));
+		}
+		
+		void testResource()
+		{
+			ByteArray data = getTestRandomData(3 * SecureBuffer::MappedCapacity);
+			CountingResource resource;
+			{
+				SecureMemoryResource::Scope scope(resource);
+				SecureBuffer buffer;
+				ccstAssertTrue(buffer.resource() == &resource);
+				buffer.append(data);
+				// The resource is never bypassed by the memory mappings.
+				ccstAssertFalse(buffer.isMapped());
+				ccstAssertEqual(resource.allocations_count, 1);
+				
+				SecureBuffer moved(std::move(buffer));
+				ccstAssertTrue(moved.resource() == &resource);
+				ccstAssertEqual(resource.allocations_count, 1);
+			}
+			{
+				// Copy made out of the scope doesn't use the resource
+				SecureBuffer buffer(&resource);
+				buffer.append(MakeRange("Hello"));
+				SecureBuffer copy(buffer);
+				ccstAssertNull(copy.resource());
+				ccstAssertEqual(copy.byteRange(), MakeRange("Hello"));
+			}
+			ccstAssertEqual(resource.allocated_size, resource.released_size);
+			ccstAssertTrue(SecureBuffer().resource() == nullptr);
+		}
+	};
+	
+	CC7_CREATE_UNIT_TEST(cc7SecureBufferTests, "cc7")
+
+} // cc7::tests
+} // cc7
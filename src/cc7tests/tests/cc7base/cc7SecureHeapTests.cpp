@@ -0,0 +1,212 @@
+/*
+ * Copyright 2016 Juraj Durech <durech.juraj@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cc7tests/CC7Tests.h>
+#include <cc7/SecureHeap.h>
+#include <thread>
+
+namespace cc7
+{
+namespace tests
+{
+	class cc7SecureHeapTests : public UnitTest
+	{
+	public:
+		cc7SecureHeapTests()
+		{
+			CC7_REGISTER_TEST_METHOD(testAllocations)
+			CC7_REGISTER_TEST_METHOD(testMerging)
+			CC7_REGISTER_TEST_METHOD(testFallback)
+			CC7_REGISTER_TEST_METHOD(testByteArray)
+			CC7_REGISTER_TEST_METHOD(testDefaultResource)
+			CC7_REGISTER_TEST_METHOD(testThreads)
+		}
+		
+		// Unit tests
+		
+		void testAllocations()
+		{
+			SecureHeap heap(16 * 1024);
+			SecureHeap::Statistics stats = heap.statistics();
+			if (stats.heap_size == 0) {
+				ccstFailure("The region was not reserved.");
+				return;
+			}
+			ccstAssertTrue(stats.heap_size >= 16 * 1024);
+			ccstAssertEqual(stats.used_size, 0);
+			if (!stats.is_locked) {
+				ccstMessage("Warning: SecureHeap is not locked on this system.");
+			}
+			
+			cc7::byte * p1 = static_cast<cc7::byte*>(heap.allocate(10));
+			cc7::byte * p2 = static_cast<cc7::byte*>(heap.allocate(100));
+			ccstAssertTrue(heap.contains(p1));
+			ccstAssertTrue(heap.contains(p2));
+			ccstAssertEqual((reinterpret_cast<size_t>(p2) & 15), 0);
+			memset(p1, 0xAA, 10);
+			memset(p2, 0xBB, 100);
+			for (size_t i = 0; i < 10; i++) {
+				ccstAssertEqual(p1[i], 0xAA);
+			}
+			stats = heap.statistics();
+			ccstAssertEqual(stats.allocations_count, 2);
+			ccstAssertEqual(stats.used_size, 16 + 128);
+			ccstAssertEqual(stats.total_allocations_count, 2);
+			ccstAssertEqual(stats.fallback_allocations_count, 0);
+			
+			heap.deallocate(p2, 100);
+			// memory is securely cleaned, except the free list node
+			for (size_t i = 16; i < 100; i++) {
+				ccstAssertEqual(p2[i], 0);
+			}
+			heap.deallocate(p1, 10);
+			stats = heap.statistics();
+			ccstAssertEqual(stats.allocations_count, 0);
+			ccstAssertEqual(stats.used_size, 0);
+			ccstAssertEqual(stats.peak_used_size, 16 + 128);
+			ccstAssertFalse(heap.contains(&stats));
+		}
+		
+		void testMerging()
+		{
+			SecureHeap heap(16 * 1024);
+			const size_t heap_size = heap.statistics().heap_size;
+			ccstAssertTrue(heap_size > 0);
+			// fill the heap with small blocks
+			std::vector<void*> blocks;
+			for (size_t i = 0; i < heap_size / 64; i++) {
+				void * p = heap.allocate(50);
+				ccstAssertTrue(heap.contains(p));
+				blocks.push_back(p);
+			}
+			ccstAssertEqual(heap.statistics().used_size, heap_size);
+			// free in a random order
+			for (size_t i = 0; i < blocks.size(); i++) {
+				std::swap(blocks[i], blocks[random() % blocks.size()]);
+			}
+			for (void * p : blocks) {
+				heap.deallocate(p, 50);
+			}
+			ccstAssertEqual(heap.statistics().used_size, 0);
+			// all blocks are merged back, so the large allocation must fit
+			void * large = heap.allocate(heap_size / 2);
+			ccstAssertTrue(heap.contains(large));
+			heap.deallocate(large, heap_size / 2);
+			ccstAssertEqual(heap.statistics().fallback_allocations_count, 0);
+		}
+		
+		void testFallback()
+		{
+			SecureHeap heap(4096);
+			const size_t heap_size = heap.statistics().heap_size;
+			void * p1 = heap.allocate(heap_size);
+			void * p2 = heap.allocate(16);
+			void * p3 = heap.allocate(heap_size * 2);
+			ccstAssertTrue(heap.contains(p1));
+			ccstAssertNotNull(p2);
+			ccstAssertNotNull(p3);
+			ccstAssertFalse(heap.contains(p2));
+			ccstAssertFalse(heap.contains(p3));
+			SecureHeap::Statistics stats = heap.statistics();
+			ccstAssertEqual(stats.allocations_count, 1);
+			ccstAssertEqual(stats.fallback_allocations_count, 2);
+			ccstAssertEqual(stats.total_fallback_allocations_count, 2);
+			heap.deallocate(p3, heap_size * 2);
+			heap.deallocate(p2, 16);
+			heap.deallocate(p1, heap_size);
+			stats = heap.statistics();
+			ccstAssertEqual(stats.allocations_count, 0);
+			ccstAssertEqual(stats.fallback_allocations_count, 0);
+			ccstAssertEqual(stats.total_allocations_count, 3);
+		}
+		
+		void testByteArray()
+		{
+			SecureHeap heap;
+			ByteArray::allocator_type allocator(&heap);
+			{
+				ByteArray data(allocator);
+				ByteArray reference;
+				for (size_t i = 0; i < 1000; i++) {
+					cc7::byte b = random() & 0xFF;
+					data.push_back(b);
+					reference.push_back(b);
+				}
+				ccstAssertEqual(data, reference);
+				ccstAssertTrue(heap.contains(data.data()));
+				ByteArray copy(data, allocator);
+				ccstAssertTrue(heap.contains(copy.data()));
+				ccstAssertEqual(heap.statistics().allocations_count, 2);
+				// the regular copy uses the current resource
+				ByteArray heap_copy = data;
+				ccstAssertFalse(heap.contains(heap_copy.data()));
+				ccstAssertEqual(heap_copy, data);
+			}
+			ccstAssertEqual(heap.statistics().allocations_count, 0);
+			ccstAssertEqual(heap.statistics().used_size, 0);
+		}
+		
+		void testDefaultResource()
+		{
+			SecureHeap heap;
+			ccstAssertNull(SecureMemoryResource::current());
+			SecureMemoryResource::setDefault(&heap);
+			{
+				ByteArray data = { 1, 2, 3 };
+				ccstAssertTrue(data.get_allocator().resource() == &heap);
+				ccstAssertTrue(heap.contains(data.data()));
+				// the default resource is visible in other threads
+				SecureMemoryResource * thread_resource = nullptr;
+				std::thread thread([&thread_resource]() {
+					thread_resource = SecureMemoryResource::current();
+				});
+				thread.join();
+				ccstAssertTrue(thread_resource == &heap);
+			}
+			SecureMemoryResource::setDefault(nullptr);
+			ccstAssertNull(SecureMemoryResource::current());
+			ccstAssertEqual(heap.statistics().allocations_count, 0);
+		}
+		
+		void testThreads()
+		{
+			SecureHeap heap(64 * 1024);
+			std::vector<std::thread> threads;
+			for (size_t t = 0; t < 4; t++) {
+				threads.push_back(std::thread([&heap]() {
+					ByteArray::allocator_type allocator(&heap);
+					for (size_t i = 0; i < 200; i++) {
+						ByteArray data(allocator);
+						data.assign(i + 1, (cc7::byte)i);
+						data.push_back(0);
+					}
+				}));
+			}
+			for (auto & thread : threads) {
+				thread.join();
+			}
+			SecureHeap::Statistics stats = heap.statistics();
+			ccstAssertEqual(stats.allocations_count, 0);
+			ccstAssertEqual(stats.fallback_allocations_count, 0);
+			ccstAssertEqual(stats.used_size, 0);
+			ccstAssertTrue(stats.total_allocations_count >= 4 * 200);
+		}
+	};
+	
+	CC7_CREATE_UNIT_TEST(cc7SecureHeapTests, "cc7")
+
+} // cc7::tests
+} // cc7
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2016 Juraj Durech <durech.juraj@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cc7tests/CC7Tests.h>
+#include <cc7/SecureMemory.h>
+
+namespace cc7
+{
+namespace tests
+{
+	class cc7SecureMemoryTests : public UnitTest
+	{
+	public:
+		cc7SecureMemoryTests()
+		{
+			CC7_REGISTER_TEST_METHOD(testSecureCompare)
+			CC7_REGISTER_TEST_METHOD(testSecureCompareAllPositions)
+			CC7_REGISTER_TEST_METHOD(testSecureClean)
+		}
+		
+		// Unit tests
+		
+		void testSecureCompare()
+		{
+			ccstAssertTrue(SecureCompare(ByteRange(), ByteRange()));
+			ccstAssertTrue(SecureCompare(MakeRange("Hello"), MakeRange("Hello")));
+			ccstAssertFalse(SecureCompare(MakeRange("Hello"), MakeRange("Hellp")));
+			ccstAssertFalse(SecureCompare(MakeRange("Hello"), MakeRange("Hello ")));
+			ccstAssertFalse(SecureCompare(MakeRange("Hello"), ByteRange()));
+			
+			ByteArray tag = getTestRandomData(32);
+			ByteArray copy = tag;
+			ccstAssertTrue(SecureCompare(tag, copy));
+			ccstAssertTrue(SecureCompare(tag.data(), copy.data(), 32));
+			copy[31] ^= 0x80;
+			ccstAssertFalse(SecureCompare(tag, copy));
+			ccstAssertFalse(SecureCompare(tag.data(), copy.data(), 32));
+			ccstAssertTrue(SecureCompare(tag.data(), copy.data(), 31));
+		}
+		
+		void testSecureCompareAllPositions()
+		{
+			// All lengths cover the vector, word and byte loops, with all
+			// possible positions of the difference and unaligned pointers.
+			ByteArray data = getTestRandomData(200);
+			for (size_t length = 1; length <= 130; length++) {
+				for (size_t offset = 0; offset < 3; offset++) {
+					ByteRange a = data.byteRange().subRange(offset, length);
+					ByteArray b(a);
+					ccstAssertTrue(SecureCompare(a, b));
+					for (size_t i = 0; i < length; i++) {
+						b[i] ^= 1 << (i & 7);
+						ccstAssertFalse(SecureCompare(a, b), "Length %d, position %d", (int)length, (int)i);
+						b[i] = a[i];
+					}
+				}
+			}
+		}
+		
+		void testSecureClean()
+		{
+			ByteArray data = getTestRandomData(1000);
+			for (size_t length = 0; length < 100; length++) {
+				ByteArray copy = data;
+				SecureClean(copy.data() + 3, length);
+				for (size_t i = 0; i < copy.size(); i++) {
+					bool cleaned = i >= 3 && i < 3 + length;
+					ccstAssertEqual(copy[i], (cleaned ? 0 : data[i]));
+				}
+			}
+			CC7_SecureClean(data.data(), data.size());
+			ccstAssertEqual(data, ByteArray(1000, 0));
+			// must not crash
+			SecureClean(nullptr, 0);
+			SecureClean(nullptr, 10);
+		}
+	};
+	
+	CC7_CREATE_UNIT_TEST(cc7SecureMemoryTests, "cc7")
+
+} // cc7::tests
+} // cc7
@@ -0,0 +1,277 @@
+/*
+ * Copyright 2016 Juraj Durech <durech.juraj@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cc7tests/CC7Tests.h>
+#include <cc7/SmallByteArray.h>
+#include <sstream>
+
+namespace cc7
+{
+namespace tests
+{
+	class cc7SmallByteArrayTests : public UnitTest
+	{
+	public:
+		cc7SmallByteArrayTests()
+		{
+			CC7_REGISTER_TEST_METHOD(testCreation)
+			CC7_REGISTER_TEST_METHOD(testAppendAndGrow)
+			CC7_REGISTER_TEST_METHOD(testAssign)
+			CC7_REGISTER_TEST_METHOD(testInsertErase)
+			CC7_REGISTER_TEST_METHOD(testMoveAndSwap)
+			CC7_REGISTER_TEST_METHOD(testSelfReferences)
+			CC7_REGISTER_TEST_METHOD(testInteroperability)
+		}
+
+		typedef SmallByteArray<16> Small16;
+
+		// Unit tests
+
+		void testCreation()
+		{
+			Small16 a1;
+			ccstAssertTrue(a1.empty());
+			ccstAssertTrue(a1.isInline());
+			ccstAssertEqual(a1.capacity(), 16);
+			ccstAssertTrue(a1.begin() == a1.end());
+
+			Small16 a2 = {1, 2, 3};
+			ccstAssertEqual(a2, ByteArray({1, 2, 3}));
+			ccstAssertTrue(a2.isInline());
+
+			Small16 a3(5, 1);
+			ccstAssertEqual(a3, ByteArray({1, 1, 1, 1, 1}));
+			Small16 a4(4);
+			ccstAssertEqual(a4, ByteArray({0, 0, 0, 0}));
+
+			const TestByteVector v123 = {1, 2, 3};
+			Small16 a5(v123.begin(), v123.end());
+			ccstAssertEqual(a5, a2);
+
+			Small16 a6(a5);
+			ccstAssertEqual(a6, a5);
+
+			ByteArray big = getTestRandomData(100);
+			Small16 a7(big);
+			ccstAssertEqual(a7, big);
+			ccstAssertFalse(a7.isInline());
+			Small16 a8 = a7;
+			ccstAssertEqual(a8, big);
+		}
+
+		void testAppendAndGrow()
+		{
+			ByteArray reference;
+			Small16 a;
+			for (size_t i = 0; i < 100; i++) {
+				cc7::byte b = random() & 0xFF;
+				reference.push_back(b);
+				a.append(b);
+				ccstAssertEqual(a, reference);
+				ccstAssertEqual(a.isInline(), (i < 16));
+			}
+			a.append({1, 2, 3});
+			reference.append({1, 2, 3});
+			a.append(reference.data(), 4);
+			reference.append(reference.data(), reference.data() + 4);
+			a.append(MakeRange("abc"));
+			reference.append(MakeRange("abc"));
+			a.append(3, 0xCC);
+			reference.append(3, 0xCC);
+			ccstAssertEqual(a, reference);
+
+			// shrink back to the inline storage
+			a.resize(10);
+			ccstAssertFalse(a.isInline());
+			a.shrink_to_fit();
+			ccstAssertTrue(a.isInline());
+			ccstAssertEqual(a, reference.byteRange().subRangeTo(10));
+			a.resize(20, 0xEE);
+			ccstAssertFalse(a.isInline());
+			ccstAssertEqual(a.back(), 0xEE);
+			a.secureClear();
+			ccstAssertTrue(a.empty());
+
+			a.reserve(1000);
+			ccstAssertEqual(a.capacity(), 1000);
+			a.pop_back();
+			ccstAssertTrue(a.empty());
+		}
+
+		void testAssign()
+		{
+			Small16 a;
+			a = MakeRange("Hello world");
+			ccstAssertEqual(CopyToString(a), "Hello world");
+			a.assign(MakeRange("Hello world, this is a long string"));
+			ccstAssertEqual(CopyToString(a), "Hello world, this is a long string");
+			a = {1, 2};
+			ccstAssertEqual(a, ByteArray({1, 2}));
+			a.assign(3, 7);
+			ccstAssertEqual(a, ByteArray({7, 7, 7}));
+			const TestByteVector v = {4, 5, 6, 7};
+			a.assign(v.begin(), v.end());
+			ccstAssertEqual(a, ByteArray({4, 5, 6, 7}));
+
+			Small16 b(ByteArray(40, 1));
+			a = b;
+			ccstAssertEqual(a, b);
+			b = Small16({9});
+			ccstAssertEqual(b, ByteArray({9}));
+		}
+
+		void testInsertErase()
+		{
+			Small16 a = {1, 5};
+			a.insert(a.begin() + 1, {2, 3, 4});
+			ccstAssertEqual(a, ByteArray({1, 2, 3, 4, 5}));
+			a.insert(a.begin(), 0);
+			a.insert(a.end(), 2, 6);
+			ccstAssertEqual(a, ByteArray({0, 1, 2, 3, 4, 5, 6, 6}));
+			ByteArray big(20, 0xAA);
+			a.insert(a.begin() + 2, big.byteRange());
+			ccstAssertEqual(a.size(), 28);
+			ccstAssertEqual(a[1], 1);
+			ccstAssertEqual(a[2], 0xAA);
+			ccstAssertEqual(a[22], 2);
+			a.erase(a.begin() + 2, a.begin() + 22);
+			ccstAssertEqual(a, ByteArray({0, 1, 2, 3, 4, 5, 6, 6}));
+			a.erase(a.begin());
+			ccstAssertEqual(a, ByteArray({1, 2, 3, 4, 5, 6, 6}));
+			
+			// Wider elements are converted one by one, like in ByteArray
+			const U16 words[] = { 1, 2, 3 };
+			Small16 b(words, words + 3);
+			ccstAssertEqual(b, ByteArray(words, words + 3));
+			ccstAssertEqual(b, ByteArray({1, 2, 3}));
+			
+			// Single pass iterators
+			std::istringstream stream1("abc");
+			b.insert(b.end(), std::istreambuf_iterator<char>(stream1), std::istreambuf_iterator<char>());
+			std::istringstream stream2("xy");
+			b.insert(b.begin() + 1, std::istreambuf_iterator<char>(stream2), std::istreambuf_iterator<char>());
+			ccstAssertEqual(b, ByteArray({1, 'x', 'y', 2, 3, 'a', 'b', 'c'}));
+		}
+
+		void testMoveAndSwap()
+		{
+			ByteArray small_data = getTestRandomData(10);
+			ByteArray large_data = getTestRandomData(50);
+
+			Small16 a(small_data);
+			Small16 b(std::move(a));
+			ccstAssertEqual(b, small_data);
+			ccstAssertTrue(a.empty());
+
+			Small16 c(large_data);
+			const cc7::byte * c_data = c.data();
+			Small16 d(std::move(c));
+			ccstAssertEqual(d, large_data);
+			ccstAssertTrue(d.data() == c_data);
+			ccstAssertTrue(c.empty());
+			ccstAssertTrue(c.isInline());
+
+			b.swap(d);
+			ccstAssertEqual(b, large_data);
+			ccstAssertEqual(d, small_data);
+			ccstAssertTrue(d.isInline());
+			d.swap(b);
+			ccstAssertEqual(d, large_data);
+			ccstAssertEqual(b, small_data);
+
+			// vector of arrays must move or copy objects during the reallocation
+			std::vector<Small16> list;
+			for (size_t i = 0; i < 40; i++) {
+				list.push_back(Small16(getTestRandomData(i)));
+			}
+			for (size_t i = 0; i < 40; i++) {
+				ccstAssertEqual(list[i].size(), i);
+			}
+		}
+
+		void testSelfReferences()
+		{
+			Small16 a = {1, 2, 3, 4};
+			// append own content
+			a.append(a.byteRange());
+			ccstAssertEqual(a, ByteArray({1, 2, 3, 4, 1, 2, 3, 4}));
+			a.append(a.byteRange());
+			a.append(a.byteRange());
+			ccstAssertEqual(a.size(), 32);
+			ccstAssertFalse(a.isInline());
+			// assign own sub-range
+			a.assign(a.byteRange().subRange(1, 3));
+			ccstAssertEqual(a, ByteArray({2, 3, 4}));
+			// insert own content
+			a.insert(a.begin() + 1, a.byteRange());
+			ccstAssertEqual(a, ByteArray({2, 2, 3, 4, 3, 4}));
+			// append own element, across the inline to heap transition
+			SmallByteArray<4> c = {0x11, 0x22, 0x33, 0x44};
+			c.push_back(c[0]);
+			ccstAssertFalse(c.isInline());
+			ccstAssertEqual(c, ByteArray({0x11, 0x22, 0x33, 0x44, 0x11}));
+			while (c.size() < c.capacity()) {
+				c.push_back(c[1]);
+			}
+			c.push_back(c[2]);
+			ccstAssertEqual(c.back(), 0x33);
+			SmallByteArray<4> d = {0x11, 0x22, 0x33, 0x44};
+			d.append(2, d[3]);
+			ccstAssertEqual(d, ByteArray({0x11, 0x22, 0x33, 0x44, 0x44, 0x44}));
+			// insert own element, which is shifted by the insertion
+			SmallByteArray<4> e = {0x11, 0x22, 0x33};
+			e.insert(e.begin(), 1, e[2]);
+			ccstAssertEqual(e, ByteArray({0x33, 0x11, 0x22, 0x33}));
+			e.resize(6, e[0]);
+			ccstAssertEqual(e, ByteArray({0x33, 0x11, 0x22, 0x33, 0x33, 0x33}));
+
+			Small16 b = MakeRange(ToBase64String(MakeRange("Hello")));
+			ccstAssertTrue(b.readFromBase64String(b.byteRange()));
+			ccstAssertEqual(CopyToString(b), "Hello");
+			b = MakeRange("48656C6C6F");
+			ccstAssertTrue(b.readFromHexString(b.byteRange()));
+			ccstAssertEqual(CopyToString(b), "Hello");
+		}
+
+		void testInteroperability()
+		{
+			Small16 a = MakeRange("Hello world");
+			ccstAssertEqual(a.base64String(), "SGVsbG8gd29ybGQ=");
+			ccstAssertEqual(a.hexString(), "48656C6C6F20776F726C64");
+
+			Small16 b;
+			ccstAssertTrue(b.readFromBase64String(std::string("SGVsbG8gd29ybGQ=")));
+			ccstAssertEqual(b, a);
+			ccstAssertFalse(b.readFromBase64String(std::string("SGVsbG8gd29ybGQ")));
+			ccstAssertTrue(b.empty());
+			ccstAssertTrue(b.readFromHexString("48656C6C6F20776F726C64"));
+			ccstAssertEqual(b, a);
+			ccstAssertFalse(b.readFromHexString(MakeRange("48656C6C6F20776F726C6x")));
+			ccstAssertTrue(b.empty());
+
+			ByteArray c(a);
+			ccstAssertEqual(c, a);
+			ByteRange r = a;
+			ccstAssertEqual(r, MakeRange("Hello world"));
+			ccstAssertEqual(MakeRange(a), r);
+			ccstAssertTrue(a < MakeRange("Hello worle"));
+		}
+	};
+
+	CC7_CREATE_UNIT_TEST(cc7SmallByteArrayTests, "cc7")
+
+} // cc7::tests
+} // cc7
@@ -0,0 +1,216 @@
+/*
+ * Copyright 2016 Juraj Durech <durech.juraj@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cc7tests/CC7Tests.h>
+#include <cc7/CC7.h>
+#include <stdlib.h>
+
+namespace cc7
+{
+namespace tests
+{
+	/**
+	 The cc7CodecBenchmarks measures throughput of all text codecs, for payloads
+	 from 16 bytes up to 64MB. The benchmark is not part of the default test list
+	 and you can run it with TestManager::createBenchmarkManager().
+	 
+	 Following environment variables affects the benchmark:
+	 
+	   CC7_BENCH_OUTPUT    - path to file, where the results are written in JSON Lines format
+	   CC7_BENCH_MAX_SIZE  - limits the maximum payload size, in bytes
+	 */
+	class cc7CodecBenchmarks : public UnitTest
+	{
+	public:
+		cc7CodecBenchmarks()
+		{
+			CC7_REGISTER_TEST_METHOD(benchBase64);
+			CC7_REGISTER_TEST_METHOD(benchBase32);
+			CC7_REGISTER_TEST_METHOD(benchHexString);
+			CC7_REGISTER_TEST_METHOD(benchBatch);
+		}
+		
+		ByteArray	_data;
+		Benchmark	_benchmark;
+		
+		void instanceSetUp() override
+		{
+			size_t max_size = 64 * 1024 * 1024;
+			const char * max_size_env = getenv("CC7_BENCH_MAX_SIZE");
+			if (max_size_env) {
+				max_size = std::max(strtoul(max_size_env, nullptr, 10), 16ul);
+			}
+			_data = getTestRandomData(max_size);
+		}
+		
+		void instanceTearDown() override
+		{
+			const char * output = getenv("CC7_BENCH_OUTPUT");
+			if (output) {
+				if (!_benchmark.writeReport(output)) {
+					ccstFailure("Unable to write benchmark results to: %s", output);
+				}
+			}
+			_data.clear();
+		}
+		
+		/**
+		 Calls |block| for all payload sizes, from 16 bytes up to the maximum size,
+		 with step 4x.
+		 */
+		void forAllSizes(std::function<void(const ByteRange & data)> block)
+		{
+			for (size_t size = 16; size <= _data.size(); size *= 4) {
+				block(_data.byteRange().subRangeTo(size));
+			}
+		}
+		
+		/**
+		 Runs the benchmark and puts the result to the test log.
+		 */
+		void measure(const std::string & name, size_t data_size, std::function<void()> block)
+		{
+			const BenchmarkResult & result = _benchmark.run(name, data_size, block);
+			ccstMessage("%s", result.toString().c_str());
+		}
+		
+		// UNIT TESTS
+		
+		void benchBase64()
+		{
+			struct Variant {
+				const char *	name;
+				size_t			wrap;
+				Base64_Variant	variant;
+			};
+			const Variant variants[] = {
+				{ "base64",				0,  Base64_Standard },
+				{ "base64.wrap64",		64, Base64_Standard },
+				{ "base64.wrap76",		76, Base64_Standard },
+				{ "base64url.nopad",	0,  Base64_UrlNoPadding },
+			};
+			forAllSizes([&](const ByteRange & data) {
+				for (const Variant & v : variants) {
+					std::string encoded;
+					ByteArray decoded;
+					measure(std::string(v.name) + ".encode", data.size(), [&]() {
+						Base64_Encode(data, v.wrap, encoded, v.variant);
+					});
+					measure(std::string(v.name) + ".decode", data.size(), [&]() {
+						Base64_Decode(encoded, v.wrap, decoded, v.variant);
+					});
+					ccstAssertEqual(decoded, data);
+				}
+			});
+		}
+		
+		void benchBase32()
+		{
+			const bool paddings[] = { true, false };
+			forAllSizes([&](const ByteRange & data) {
+				for (bool padding : paddings) {
+					std::string name = padding ? "base32" : "base32.nopad";
+					std::string encoded;
+					ByteArray decoded;
+					measure(name + ".encode", data.size(), [&]() {
+						Base32_Encode(data, padding, encoded);
+					});
+					measure(name + ".decode", data.size(), [&]() {
+						Base32_Decode(encoded, padding, decoded);
+					});
+					ccstAssertEqual(decoded, data);
+				}
+			});
+		}
+		
+		void benchHexString()
+		{
+			forAllSizes([&](const ByteRange & data) {
+				std::string encoded;
+				ByteArray decoded;
+				measure("hex.encode", data.size(), [&]() {
+					HexString_Encode(data, false, encoded);
+				});
+				measure("hex.encode.lowercase", data.size(), [&]() {
+					HexString_Encode(data, true, encoded);
+				});
+				measure("hex.decode", data.size(), [&]() {
+					HexString_Decode(encoded, decoded);
+				});
+				ccstAssertEqual(decoded, data);
+			});
+		}
+		void benchBatch()
+		{
+			// 1000 short identifiers, encoded one by one and in one batch.
+			const size_t items_count = 1000;
+			const size_t item_size = 16;
+			std::vector<ByteRange> items;
+			for (size_t i = 0; i < items_count && (i + 1) * item_size <= _data.size(); i++) {
+				items.push_back(_data.byteRange().subRange(i * item_size, item_size));
+			}
+			const size_t data_size = items.size() * item_size;
+			std::string encoded;
+			std::vector<size_t> offsets;
+			measure("batch.hex.loop.encode", data_size, [&]() {
+				for (const ByteRange & item : items) {
+					ToHexString(item);
+				}
+			});
+			measure("batch.hex.encode", data_size, [&]() {
+				HexString_EncodeBatch(items, false, encoded, offsets);
+			});
+			measure("batch.base64.loop.encode", data_size, [&]() {
+				for (const ByteRange & item : items) {
+					ToBase64String(item);
+				}
+			});
+			measure("batch.base64.encode", data_size, [&]() {
+				Base64_EncodeBatch(items, encoded, offsets);
+			});
+			measure("batch.base32.loop.encode", data_size, [&]() {
+				for (const ByteRange & item : items) {
+					ToBase32String(item, false);
+				}
+			});
+			measure("batch.base32.encode", data_size, [&]() {
+				Base32_EncodeBatch(items, false, encoded, offsets);
+			});
+			
+			HexString_EncodeBatch(items, false, encoded, offsets);
+			std::vector<ByteRange> strings;
+			for (size_t i = 0; i < items.size(); i++) {
+				strings.push_back(MakeRange(encoded).subRange(offsets[i], offsets[i + 1] - offsets[i]));
+			}
+			ByteArray decoded;
+			std::vector<size_t> decoded_offsets;
+			measure("batch.hex.loop.decode", data_size, [&]() {
+				for (const ByteRange & string : strings) {
+					HexString_Decode(string, decoded);
+				}
+			});
+			measure("batch.hex.decode", data_size, [&]() {
+				HexString_DecodeBatch(strings, decoded, decoded_offsets);
+			});
+			ccstAssertEqual(decoded, _data.byteRange().subRangeTo(data_size));
+		}
+		
+	};
+	
+	CC7_CREATE_UNIT_TEST(cc7CodecBenchmarks, "cc7 bench")
+
+} // cc7::tests
+} // cc7